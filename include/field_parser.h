@@ -1,8 +1,54 @@
 /*
-*   fld_parser - v0.60
+*   fld_parser - v0.90
 *   Header-only library for parsing configuration files in the FLD format.
 *
 *   RECENT CHANGES:
+*       0.90    (2026-10-14)    Added `fld_parse_into` to parse a fragment into an object of an existing tree, merging objects and replacing values;
+*       0.89    (2026-10-14)    Added tree edits in the arena (`fld_set_*`, `fld_add_object`, `fld_remove_field`, `fld_array_append`) with a free list for removed fields;
+*       0.88    (2026-10-14)    Added a writer for FLD text, pretty or on one line (`fld_write`, `fld_writer`, `fld_writer_handler`); floats are written shortest round-trip;
+*       0.87    (2026-10-14)    Strings support escapes (`\"` `\\` `\n` `\t` `\uXXXX`...), decoded into the arena only when present; quotes are found with memchr;
+*       0.86    (2026-10-14)    Added `FLD_ENABLE_STATS`, per-parse counters and phase timings in `fld_parse_stats` (`fld_get_parse_stats`);
+*       0.85    (2026-10-14)    Added `fld_shared_config` to read one tree from many threads and replace it without locks (epoch based);
+*       0.84    (2026-10-14)    Added `FLD_PARSE_LAZY_OBJECTS` to parse object bodies on first access, and `fld_get_children`;
+*       0.83    (2026-10-14)    Added overlays (`fld_overlay_get`, `fld_overlay_iter_next`) to read stacked trees as one, `fld_flatten` merges them;
+*       0.82    (2026-10-14)    Added `fld_parser_reset` and `fld_parse_reuse` to parse into the same arena again, and `fld_get_memory_peak`;
+*       0.81    (2026-10-14)    Added `field_parser.hpp`, C++17 wrappers with compile-time hashed `_fld` path literals and typed `get<T>()`;
+*       0.80    (2026-10-14)    `tests/benchmarks.c` runs over synthetic corpora, prints CSV and can gate on a baseline with `--compare`;
+*       0.79    (2026-10-14)    Added schemas (`fld_schema_compile`, `fld_schema_fill`) to fill structs in one walk of the tree;
+*       0.78    (2026-10-14)    Added `fld_parse_parallel`, large documents are split at top-level fields and parsed on worker threads;
+*       0.77    (2026-10-14)    Added `fld_parse_batch` to parse many documents on worker threads (opt-in with `FLD_PARSER_THREADS`);
+*                               `fld_get_field_by_path` no longer uses `strtok`, every entry point is re-entrant;
+*       0.76    (2026-10-14)    Added `fld_compact`, a flat struct-of-arrays copy of the tree in pre-order;
+*       0.75    (2026-10-14)    Added a relocatable binary image of the tree, `fld_serialize` and `fld_load_binary`;
+*       0.74    (2026-10-14)    Added `fld_parse_events`, an event callback mode that builds no tree;
+*       0.73    (2026-10-14)    Added push parsing with `fld_stream_begin`, `fld_stream_feed` and `fld_stream_end`;
+*       0.72    (2026-10-14)    Added `fld_reparse` for hot reloading, unchanged top-level fields are kept from the previous tree;
+*                               Top-level fields carry a hash of their source text (`content_hash`);
+*       0.71    (2026-10-14)    Numbers are scanned in a single pass, floats are correctly rounded (Eisel-Lemire);
+*                               Added `e`/`E` exponents and 64-bit integers (`FLD_VALUE_INT64`, `fld_get_int64`);
+*                               Integers and floats out of range are reported as `FLD_ERROR_INVALID_NUMBER`;
+*       0.70    (2026-10-14)    Whitespace and comments are skipped 16 bytes at a time with SSE2/NEON (`FLD_NO_SIMD` to opt out);
+*                               Columns are computed lazily from the start of the line, token columns now point at the token's start;
+*       0.69    (2026-10-14)    Added chunk allocators: the arena can grow through a user callback (`fld_parser_set_allocator`);
+*                               Added `fld_parser_release` to hand the chunks back;
+*       0.68    (2026-10-14)    Added `fld_measure` for the exact arena size of a parse and `fld_get_memory_used`;
+*                               `fld_parse` no longer rejects buffers below the heuristic estimate;
+*                               `fld_estimate_memory` now returns the exact size for valid sources;
+*       0.67    (2026-10-14)    Added `fld_parse_file` and `fld_close` (opt-in with `FLD_PARSER_FILE_IO`);
+*                               Files are memory mapped and parsed zero-copy into an arena sized by a structural pre-scan;
+*       0.66    (2026-10-14)    Added `fld_parse_ex` with parse flags and `fld_parse_borrowed` for zero-copy parsing;
+*                               Lexer no longer relies on a null terminator;
+*       0.65    (2026-10-14)    Added compiled paths (`fld_path_compile`, `fld_path_resolve`);
+*                               Added bindings that cache a resolved field per parser (`fld_bind`, `fld_binding_get_*`);
+*       0.64    (2026-10-14)    Added a hashed lookup index for objects with many fields (`FLD_INDEX_MIN_FIELDS`);
+*                               Added `fld_hash_key`;
+*       0.63    (2026-10-14)    Arrays no longer have an item limit (`FLD_MAX_ARRAY_ITEMS` is now an opt-in cap);
+*                               Added a bulk fast path for int and float arrays;
+*                               Added tests/benchmarks.c;
+*       0.62    (2026-10-14)    Arrays are parsed in a single pass straight into arena storage, no more lexer rewind;
+*       0.61    (2026-10-14)    Tokens now live in fixed slots inside `fld_parser` instead of the arena;
+*                               Values are parsed straight into their object, no throwaway `fld_value`s;
+*                               Memory estimate shrunk to the size of the tree plus the source copy;
 *       0.60    (2025-01-12)    Added vec2, vec3, vec4 (float) support;
 *                               Vectors are added to examples and tests;
 *                               Updated readme with description and help for new vec types;
@@ -52,7 +98,7 @@
 *       SOFTWARE.
 *
 *   TODOs:
-*       - [ ] Run some tests to see how close the
+*       - [x] Run some tests to see how close the
 *             memory estimating function gets.
 *       - [x] Remove stdlib.h include by writing own
 *             int and float parser.
@@ -91,13 +137,22 @@ typedef enum fld_value_type {
     FLD_VALUE_VEC3,
     FLD_VALUE_VEC4,
     FLD_VALUE_OBJECT,
+    FLD_VALUE_INT64,    // Integers that don't fit in an int
 } fld_value_type;
 
+// Number of fld_value_type values, for tables indexed by type
+#define FLD_VALUE_TYPE_COUNT (FLD_VALUE_INT64 + 1)
+
 typedef struct fld_value {
     fld_value_type type;
+    // Hash of the field's source text, only set for top-level fields and 0
+    // once the field was edited. Lives in what would otherwise be padding,
+    // see fld_reparse.
+    uint32_t content_hash;
     union {
         fld_string_view string;
         int integer;
+        int64_t int64;
         float float_val;
         bool boolean;
         struct {
@@ -106,6 +161,12 @@ typedef struct fld_value {
             void *items;
         } array;
         struct fld_object *object;
+        // Objects of a FLD_PARSE_LAZY_OBJECTS parse that weren't accessed
+        // yet have a NULL `object` and the location of their body here
+        struct {
+            struct fld_object *object;
+            struct fld_lazy_body *body;
+        } lazy;
         struct {
             float x, y;
         } vec2;
@@ -124,8 +185,21 @@ typedef struct fld_object {
 
     struct fld_object *next;
     struct fld_object *parent;
+
+    // Hashed lookup over this field and its siblings. Only ever set on the
+    // first field of a list and only if the list is large enough.
+    struct fld_index *index;
 } fld_object;
 
+// Open-addressed hash table of key hash -> field, stored in the arena.
+typedef struct fld_index {
+    uint32_t capacity;              // Always a power of two
+    uint32_t count;
+    uint32_t *hashes;
+    struct fld_object **fields;     // NULL marks an empty slot
+    struct fld_object *last;        // Last field of the list, where edits append
+} fld_index;
+
 typedef enum {
     TOKEN_KEY,
     TOKEN_EQUALS,
@@ -150,10 +224,11 @@ typedef struct {
     fld_token_type type;
     union {
         fld_string_view string;
-        int integer;
-        double float_val;
+        int64_t integer;
+        float float_val;
         bool boolean;
     } value;
+    bool escaped;   // A string with backslash escapes, still in its source form
     int line;
     int column;
 } fld_token;
@@ -161,8 +236,12 @@ typedef struct {
 typedef struct {
     char *start;
     char *current;
+    char *end;
+    char *line_start;   // Columns are computed from this when a token is made
     int line;
-    int column;
+#ifdef FLD_ENABLE_STATS
+    size_t comment_bytes;
+#endif
 } fld_lexer;
 
 typedef enum {
@@ -173,7 +252,12 @@ typedef enum {
     FLD_ERROR_INSUFFICIENT_MEMORY,
     FLD_ERROR_ARRAY_TYPE_MISMATCH,
     FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE,
-    FLD_ERROR_ARRAY_TOO_MANY_ITEMS
+    FLD_ERROR_ARRAY_TOO_MANY_ITEMS,
+    FLD_ERROR_FILE_IO,
+    FLD_ERROR_INVALID_IMAGE,
+    FLD_ERROR_INVALID_ESCAPE,
+    FLD_ERROR_INVALID_PATH,
+    FLD_ERROR_STRING_TOO_LONG
 } fld_error_code;
 
 typedef struct {
@@ -182,21 +266,97 @@ typedef struct {
     int column;
 } fld_error;
 
+// Fetches a block of at least `size` bytes for the arena, or returns NULL.
+// Blocks have to be aligned for any type, like malloc's.
+typedef void *(*fld_chunk_alloc_fn)(size_t size, void *user);
+// Hands a block fetched by fld_chunk_alloc_fn back, with the size it was asked for.
+typedef void (*fld_chunk_free_fn)(void *memory, size_t size, void *user);
+
+typedef struct {
+    fld_chunk_alloc_fn alloc;
+    fld_chunk_free_fn free;
+    void *user;
+    size_t chunk_size;      // Minimum size of a chunk, 0 for FLD_CHUNK_SIZE
+} fld_chunk_allocator;
+
 typedef struct {
     uint8_t *start;
     uint8_t *end;
     uint8_t *current;
+
+    // Chunks fetched from `backing` once the current block is full,
+    // newest first. The caller's memory is never part of the chain.
+    struct fld_chunk *chunks;
+    size_t retired;         // Bytes used in the blocks before the current one
+    fld_chunk_allocator backing;
+
+    // The caller's memory, what fld_parser_reset rewinds to
+    uint8_t *base;
+    uint8_t *base_end;
+    // Chunks kept by fld_parser_reset, reused before fetching new ones
+    struct fld_chunk *spare;
+    size_t peak;            // Most bytes used by a finished parse
 } fld_bump_allocator;
 
+#ifdef FLD_ENABLE_STATS
+// What a parse spent its time and arena on, filled in when FLD_ENABLE_STATS
+// is defined. Objects parsed later on by FLD_PARSE_LAZY_OBJECTS add to it.
+typedef struct {
+    uint32_t tokens[TOKEN_ERROR + 1];   // Tokens lexed, by fld_token_type
+    size_t whitespace_bytes;
+    size_t comment_bytes;
+
+    uint32_t arrays;
+    uint32_t array_items;
+    uint32_t array_moves;           // Item runs moved to a bigger chunk while they grew
+    uint32_t array_widenings;       // Int arrays copied as int64 ones
+    int max_depth;                  // Deepest object nesting, top-level fields are 1
+
+    // Arena bytes by what they hold, alignment padding not included
+    size_t object_bytes;
+    size_t item_bytes;
+    size_t index_bytes;
+    size_t source_bytes;            // The copy of the source, 0 when borrowed
+    size_t string_bytes;            // Strings with escapes, decoded
+    size_t lazy_bytes;
+
+    // Nanoseconds spent copying the source, and lexing and building the tree
+    // (index builds included, which are also counted on their own)
+    uint64_t copy_ns;
+    uint64_t parse_ns;
+    uint64_t index_ns;
+} fld_parse_stats;
+#endif
+
+// Number of token slots kept inside the parser. The parser only ever looks at
+// `current` and `previous`, the third slot is the one the lexer writes into.
+#define FLD_TOKEN_SLOTS 3
+
 typedef struct {
     fld_lexer lexer;
     fld_token *current;
     fld_token *previous;
+    fld_token tokens[FLD_TOKEN_SLOTS];
     
     char *source;
+    size_t source_length;
     fld_error last_error;
     fld_bump_allocator allocator;
     fld_object *root;
+
+    // Bumped by every parse so bindings know when to resolve again
+    uint32_t generation;
+    uint32_t flags;         // fld_parse_flags of the last parse
+    struct fld_object *free_fields;     // Removed by edits, reused before the arena
+
+#ifdef FLD_ENABLE_STATS
+    fld_parse_stats stats;
+#endif
+
+    // Owned by fld_parse_file and released by fld_close
+    void *file_view;
+    size_t file_size;
+    void *file_arena;
 } fld_parser;
 
 typedef enum fld_iter_type {
@@ -224,11 +384,244 @@ typedef struct {
 #endif
 
 #define FLD_MAX_PATH_LENGTH 128
-#define FLD_MAX_ARRAY_ITEMS 128
-#define FLD_MAX_DIGITS 21
+
+// Default size of the chunks fetched through a fld_chunk_allocator.
+#ifndef FLD_CHUNK_SIZE
+    #define FLD_CHUNK_SIZE (64 * 1024)
+#endif
+
+// Objects (and the top level) with at least this many fields get a hashed
+// lookup index. Define it to 0 before including the header to disable it.
+#ifndef FLD_INDEX_MIN_FIELDS
+    #define FLD_INDEX_MIN_FIELDS 16
+#endif
+
+// Arrays have no item limit by default. Define this to a non-zero value
+// before including the header to cap the number of items per array.
+#ifndef FLD_MAX_ARRAY_ITEMS
+    #define FLD_MAX_ARRAY_ITEMS 0
+#endif
+#define FLD_MAX_PATH_SEGMENTS 16
+
+typedef enum fld_parse_flags {
+    FLD_PARSE_DEFAULT       = 0,
+    FLD_PARSE_BORROW_SOURCE = 1 << 0,   // Lex the caller's buffer in place instead of copying it
+    FLD_PARSE_LAZY_OBJECTS  = 1 << 1,   // Skip object bodies until they are first accessed
+} fld_parse_flags;
+
+typedef struct {
+    uint32_t hash;
+    uint16_t offset;    // Into fld_path.text
+    uint16_t length;
+} fld_path_segment;
+
+// A dotted path split into segments once, with their hashes precomputed.
+typedef struct {
+    char text[FLD_MAX_PATH_LENGTH];
+    fld_path_segment segments[FLD_MAX_PATH_SEGMENTS];
+    int segment_count;
+} fld_path;
+
+// A compiled path bound to a parser, caching the field it resolved to.
+typedef struct {
+    const fld_path *path;
+    fld_parser *parser;
+    fld_object *field;
+    uint32_t generation;
+} fld_binding;
+
+#define FLD_SCHEMA_NONE UINT32_MAX
+
+typedef enum {
+    FLD_SCHEMA_OPTIONAL = 0,
+    FLD_SCHEMA_REQUIRED = 1 << 0,   // fld_schema_fill fails without it
+} fld_schema_flags;
+
+// Where one value of a fld_schema goes. `type` is what gets stored at
+// `offset`: int, int64_t (ints too), float, bool, fld_string_view, or
+// 2 to 4 floats for vectors.
+typedef struct {
+    const char *path;
+    fld_value_type type;
+    size_t offset;
+    uint32_t flags;
+} fld_schema_field;
+
+// One path segment in a compiled schema, sharing prefixes with the others
+typedef struct {
+    const char *key;
+    uint32_t length;
+    uint32_t hash;
+    uint32_t first_child;   // FLD_SCHEMA_NONE for a leaf
+    uint32_t next;          // Next segment on the same level
+    uint32_t field;         // Descriptor that ends here, or FLD_SCHEMA_NONE
+} fld_schema_node;
+
+// The descriptors of a schema compiled into a trie of path segments.
+typedef struct {
+    const fld_schema_field *fields;
+    uint32_t field_count;
+    uint32_t required_count;
+    fld_schema_node *nodes;
+    uint32_t node_count;
+} fld_schema;
+
+typedef enum {
+    FLD_CHANGE_ADDED,
+    FLD_CHANGE_REMOVED,
+    FLD_CHANGE_MODIFIED,
+} fld_change_type;
+
+// A top-level field that changed in fld_reparse
+typedef struct {
+    fld_change_type type;
+    fld_string_view path;   // Key of the top-level field
+    fld_object *field;      // The new field, the old one for FLD_CHANGE_REMOVED
+} fld_change;
+
+typedef struct {
+    fld_change *items;      // Lives in the parser's arena
+    size_t count;
+    size_t reused;          // Top-level fields kept from the previous tree
+} fld_changes;
+
+// Callbacks for fld_parse_events, any of them can be NULL. Returning false
+// from one stops the parse. The string views point into the source, except
+// strings with escapes: those are decoded into a buffer of
+// FLD_EVENT_STRING_SIZE bytes that is only valid during the callback.
+// Longer ones go into chunks from `strings`, without it they fail the parse
+// with FLD_ERROR_STRING_TOO_LONG.
+typedef struct {
+    void *user;     // Passed to every callback
+    bool (*on_key)(void *user, fld_string_view key);
+    bool (*on_value)(void *user, const fld_value *value);   // Primitives and every array item
+    bool (*on_object_begin)(void *user);
+    bool (*on_object_end)(void *user);
+    bool (*on_array_begin)(void *user);
+    bool (*on_array_end)(void *user);
+    const fld_chunk_allocator *strings;     // May be NULL, chunks are handed back before returning
+} fld_event_handler;
+
+#ifndef FLD_EVENT_STRING_SIZE
+    #define FLD_EVENT_STRING_SIZE 1024
+#endif
+
+// "FLDB" when read as a little-endian uint32
+#define FLD_BINARY_MAGIC 0x42444C46u
+#define FLD_BINARY_VERSION 2
+
+// Start of a binary image written by fld_serialize. The tree follows with
+// every pointer stored as an offset from the start of the image (0 for NULL),
+// then the string pool that keys and strings point into.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t pointer_size;   // sizeof(void*) of the writer
+    uint8_t object_size;    // sizeof(fld_object) of the writer
+    uint64_t size;          // Bytes in the whole image
+    uint64_t root;          // Offset of the first top-level field
+    uint64_t strings;       // Offset of the string pool
+} fld_binary_header;
+
+// Node index meaning "none" in a fld_compact_tree
+#define FLD_COMPACT_NONE UINT32_MAX
+
+// Value of a node in a fld_compact_tree, the node's type says which member
+typedef union {
+    int integer;
+    int64_t int64;
+    float float_val;
+    bool boolean;
+    struct {
+        uint32_t offset;    // Into the tree's `text`
+        uint32_t length;
+    } string;
+    struct {
+        uint32_t offset;    // Into the tree's `data`, items of the usual array layout
+        uint32_t count;
+    } array;
+    uint32_t vec;           // Offset of the components in the tree's `data`
+    uint32_t children;      // Objects: number of direct children, the first one is the next node
+} fld_compact_payload;
+
+// A tree flattened by fld_compact: one entry per field in each array, in
+// pre-order, so walking all fields recursively is a scan from 0 to `count`.
+typedef struct {
+    uint32_t count;
+    uint32_t *keys;                 // Offset of each key in `text`
+    uint32_t *key_lengths;
+    uint8_t *types;                 // fld_value_type of each node
+    uint8_t *item_types;            // fld_value_type of the items, for arrays
+    fld_compact_payload *payloads;
+    uint32_t *next;                 // Next sibling or FLD_COMPACT_NONE
+    uint32_t *parents;              // FLD_COMPACT_NONE at the top level
+    char *text;                     // Keys and strings
+    uint8_t *data;                  // Array items and vector components
+} fld_compact_tree;
+
+// Most parsers an overlay can stack
+#ifndef FLD_OVERLAY_MAX_LAYERS
+    #define FLD_OVERLAY_MAX_LAYERS 8
+#endif
+
+// A path an overlay resolved, kept in its cache
+typedef struct {
+    uint32_t hash;      // Of the whole path
+    struct fld_object *field;
+} fld_overlay_entry;
+
+// An ordered stack of parsed trees read as one, see fld_overlay_init
+typedef struct {
+    fld_parser *layers[FLD_OVERLAY_MAX_LAYERS];     // Lowest first, later layers override
+    uint32_t generations[FLD_OVERLAY_MAX_LAYERS];   // Of each layer when the cache was filled
+    int layer_count;
+    fld_overlay_entry *cache;
+    uint32_t cache_capacity;                        // A power of two, 0 without a cache
+} fld_overlay;
+
+// The field lists one level of an overlay is made of, top layer first
+typedef struct {
+    struct fld_object *lists[FLD_OVERLAY_MAX_LAYERS];
+    int count;
+} fld_overlay_level;
+
+// Iterates over the fields of one level of an overlay, see fld_overlay_iter_init
+typedef struct {
+    fld_overlay_level level;
+    int list;           // List being walked, from the bottom
+    struct fld_object *next;
+} fld_overlay_iter;
+
+// State of a push parse, see fld_stream_begin. The fields are internal.
+typedef struct {
+    fld_parser *parser;
+    uint8_t *pending;       // Text not parsed yet, always at the top of the arena
+    size_t scanned;         // Bytes of `pending` the scanner went through
+    size_t complete;        // Bytes of `pending` up to the end of the last complete top-level field
+    size_t column;          // Characters on the current line before `pending`
+    fld_object *last;       // Last top-level field parsed so far
+    uint32_t count;
+    int depth;              // Brackets open at `scanned`
+    int state;              // Whether `scanned` is in code, a string or a comment
+    bool failed;
+} fld_stream;
+
+// What parsing a source will build, as counted by fld_measure.
+typedef struct {
+    size_t bytes;                       // Exact arena bytes the parse uses
+    size_t fields;
+    size_t objects;                     // Object values, empty ones included
+    size_t arrays;
+    size_t indexes;                     // Lookup indexes built for large field lists
+    size_t items[FLD_VALUE_TYPE_COUNT]; // Array items by element type
+    fld_error error;                    // Set when the source doesn't parse
+} fld_measurement;
 
 /**
  * @brief Parses the given source using the specified parser.
+ *
+ * A parser keeps its allocator and arena chunks from one parse to the next,
+ * so it has to start out zeroed, with `= {0}` or fld_parser_init.
  * 
  * @param parser A pointer to the fld_parser structure that will be used for parsing.
  * @param source A constant character pointer to the source string to be parsed.
@@ -239,240 +632,1217 @@ typedef struct {
 extern bool fld_parse(fld_parser *parser, const char *source, void *memory, size_t size);
 
 /**
- * @brief Retrieves a string view associated with a given path starting
- * from the specified fld_object.
- * 
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired string view.
- * @param str_view Pointer to an fld_string_view structure where the result will be stored.
- * @return true if the string view is successfully retrieved, false otherwise.
+ * @brief Parses `length` bytes of source with the given fld_parse_flags.
+ *
+ * The source doesn't need to be null-terminated. With FLD_PARSE_BORROW_SOURCE
+ * the source is not copied into the arena: string views point straight into
+ * the caller's buffer, which then has to outlive the parsed tree.
+ *
+ * With FLD_PARSE_LAZY_OBJECTS the bodies of objects are only matched up to
+ * their closing brace and parsed into the arena when they are first
+ * accessed, one level at a time. That needs room in the arena later on
+ * (or a chunk allocator), makes accesses write to the tree, so lazy trees
+ * can't be read from several threads at once, and leaves syntax errors in
+ * the bodies to the first access: the object then reads as empty and the
+ * error is left in the parser's `last_error`.
+ *
+ * @param parser A pointer to the fld_parser structure that will be used for parsing.
+ * @param source Pointer to the source text.
+ * @param length Length of the source text in bytes.
+ * @param memory A pointer to the memory where the parsed data will be stored.
+ * @param size The size of the memory buffer.
+ * @param flags A combination of fld_parse_flags.
+ * @return true if parsing is successful, false otherwise.
  */
-extern bool fld_get_str_view(fld_object *object, const char *path, fld_string_view *str_view);
+extern bool fld_parse_ex(fld_parser *parser, const char *source, size_t length, void *memory, size_t size, uint32_t flags);
 
 /**
- * @brief Retrieves a C-string value associated with a given path starting from a field object.
- *
- * This function searches for a path starting from  the specified field object and, if found,
- * copies the associated C-string value into the provided buffer. The buffer size
- * must be large enough to hold the value, including the null-terminator.
+ * @brief Parses the caller's buffer in place without copying it (zero-copy).
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired C-string value.
- * @param buffer Pointer to the buffer where the retrieved C-string value will be stored.
- * @param buffer_size The size of the buffer, in bytes.
- * @return true if the object was found and the value was successfully copied to the buffer; 
- *         false otherwise.
+ * Same as fld_parse_ex with FLD_PARSE_BORROW_SOURCE. The buffer must stay
+ * alive and unchanged for as long as the parsed tree is used.
  */
-extern bool fld_get_cstr(fld_object *object, const char *path, char *buffer, size_t buffer_size);
+static inline bool fld_parse_borrowed(fld_parser *parser, const char *source, size_t length, void *memory, size_t size) {
+    return fld_parse_ex(parser, source, length, memory, size, FLD_PARSE_BORROW_SOURCE);
+}
 
 /**
- * @brief Retrieves an integer value from an object at a given path.
+ * @brief Re-parses a changed source on top of the parser's current tree.
  *
- * This function searches for the specified path starting from the given field object and,
- * if found, assigns the corresponding integer value to the output parameter.
+ * Top-level fields whose source text didn't change (found by the hash taken
+ * when they were parsed, then compared with their old text) are kept as
+ * they are, only the others are parsed again. Everything new, including a
+ * copy of the source, is appended to the parser's arena, so it needs room
+ * to spare or a chunk allocator. The source text of the kept fields has to
+ * stay alive, which only matters if it was borrowed. On failure the
+ * previous tree is left untouched.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired integer value.
- * @param out_value A pointer to an integer where the retrieved value will be stored.
- * @return true if the path was found and the value was successfully retrieved, false otherwise.
+ * @param parser A parser holding the tree of a previous parse.
+ * @param source Pointer to the new source text.
+ * @param length Length of the new source text in bytes.
+ * @param out_changes Receives the top-level fields that were added, removed
+ *        or modified, in source order (removed ones last).
+ * @return true if parsing is successful, false otherwise.
  */
-extern bool fld_get_int(fld_object *object, const char *path, int *out_value);
+extern bool fld_reparse(fld_parser *parser, const char *source, size_t length, fld_changes *out_changes);
 
 /**
- * @brief Retrieves a float value from a field object based on the provided path.
+ * @brief Starts a push parse, the source is then fed in with fld_stream_feed.
  *
- * This function searches for the specified path starting from the given object and,
- * if found, assigns the corresponding float value to the output parameter.
+ * Builds the same tree fld_parse does, without the whole source having to be
+ * in memory at once. Fed text is copied into the arena and complete top-level
+ * fields are parsed as soon as their closing semicolon arrives, so only the
+ * text of the field that is still coming in is held on to. That text is
+ * copied again after each parsed batch, so the arena needs a bit more than
+ * fld_measure reports; a chunk allocator takes care of that.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired float value.
- * @param out_value A pointer to a float where the retrieved value will be stored.
- * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ * @param stream The stream state to set up.
+ * @param parser The parser that receives the tree.
+ * @param memory A pointer to the memory where the parsed data will be stored.
+ * @param size The size of the memory buffer.
  */
-extern bool fld_get_float(fld_object *object, const char *path, float *out_value);
+extern void fld_stream_begin(fld_stream *stream, fld_parser *parser, void *memory, size_t size);
 
 /**
- * @brief Retrieves a bool value from a field object based on the provided path.
+ * @brief Feeds the next piece of source to a push parse.
  *
- * This function searches for an object with a specified path starting from
- * the given field object and, if found, assigns the corresponding bool value
- * to the output parameter.
+ * Pieces can be split anywhere, including in the middle of strings, numbers
+ * or comments.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired bool value.
- * @param out_value A pointer to a bool where the retrieved value will be stored.
- * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ * @param stream A stream started with fld_stream_begin.
+ * @param chunk Pointer to the next piece of source text.
+ * @param length Length of the piece in bytes.
+ * @return false once parsing failed, with the error in the parser's `last_error`.
  */
-extern bool fld_get_bool(fld_object *object, const char *path, bool *out_value);
+extern bool fld_stream_feed(fld_stream *stream, const char *chunk, size_t length);
 
+/**
+ * @brief Finishes a push parse, parsing whatever text is left.
+ *
+ * @param stream A stream started with fld_stream_begin.
+ * @return true if the whole source parsed, false otherwise.
+ */
+extern bool fld_stream_end(fld_stream *stream);
 
 /**
- * @brief Retrieves an array from a field object based on a path.
+ * @brief Measures the exact amount of memory parsing the source will use.
  *
- * This function searches for an array associated with the specified path starting from the given field object.
- * If the key is found and the associated value is an array, assigns the array's type, items,
- * and count through the output parameters.
+ * Lexes the source without allocating anything and mirrors every allocation
+ * fld_parse_ex makes, so `out->bytes` is exactly what a parse of the same
+ * source with the same flags uses. This holds for a single block of memory
+ * aligned to at least ALIGNOF(fld_object), which malloc'd memory always is.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the array to retrieve.
- * @param out_type Pointer to a variable to receive the type of the array elements.
- * @param out_items Pointer to a variable to receive the pointer to the array items.
- * @param out_count Pointer to a variable to receive the count of items in the array.
- * @return true if the array is found and successfully retrieved, false otherwise.
+ * With FLD_PARSE_LAZY_OBJECTS the bodies are parsed into the same arena
+ * later on, in whatever order they are accessed. `out->bytes` is then an
+ * upper bound that covers expanding every object: the record of each body
+ * plus the worst alignment padding of every allocation.
+ *
+ * @param source Pointer to the source text.
+ * @param length Length of the source text in bytes.
+ * @param flags The fld_parse_flags the source will be parsed with.
+ * @param out Receives the size and the counts of what will be built.
+ * @return true if the source parses, false otherwise with `out->error` set.
  */
-extern bool fld_get_array(fld_object *object, const char *path, fld_value_type *out_type, void** out_items, size_t* out_count);
+extern bool fld_measure(const char *source, size_t length, uint32_t flags, fld_measurement *out);
 
 /**
- * @brief Retrieves a vec2 value from a field object based on the provided path.
+ * @brief Parses the source and reports what it finds to callbacks, without
+ * building a tree.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired vec2 value.
- * @param out_x A pointer to store the x component.
- * @param out_y A pointer to store the y component.
- * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ * Nothing is allocated and the source is read in place, so memory use only
+ * grows with the nesting depth. The one exception is a decoded string
+ * longer than FLD_EVENT_STRING_SIZE, which takes chunks from
+ * `handler->strings`. Every field reports its key, then either its value or
+ * the begin/end pair of its object or array, in source order.
+ *
+ * @param source Pointer to the source text.
+ * @param length Length of the source text in bytes.
+ * @param handler The callbacks to call.
+ * @param out_error Receives the error, may be NULL.
+ * @return true if the whole source parsed, false if it didn't or a callback
+ *         stopped it, in which case the error code is FLD_ERROR_NONE.
  */
-extern bool fld_get_vec2(fld_object *object, const char *path, float *out_x, float *out_y);
+extern bool fld_parse_events(const char *source, size_t length, const fld_event_handler *handler, fld_error *out_error);
+
+#ifndef FLD_WRITER_BUFFER_SIZE
+    #define FLD_WRITER_BUFFER_SIZE 512
+#endif
+#ifndef FLD_WRITE_INDENT
+    #define FLD_WRITE_INDENT 4
+#endif
+
+typedef enum {
+    FLD_WRITE_PRETTY      = 0,          // One field per line, nested objects indented
+    FLD_WRITE_SINGLE_LINE = 1 << 0,     // Everything on one line, fields separated by a space
+} fld_write_flags;
+
+// Receives the writer's output in pieces, returning false stops the writer
+typedef bool (*fld_write_fn)(void *user, const char *text, size_t length);
+
+// Writes FLD text, from a tree or from calls in the order fld_parse_events
+// reports a document. Nothing is allocated, text either goes into the
+// caller's buffer or through `buffer` to a callback.
+typedef struct {
+    char *out;              // The caller's buffer or `buffer`
+    size_t capacity;        // Bytes of text `out` holds
+    size_t used;
+    size_t length;          // All text written, including what didn't fit
+    fld_write_fn write;     // NULL when writing into the caller's buffer
+    void *user;
+    uint32_t flags;         // fld_write_flags
+    int depth;
+    bool separate;          // The next field needs a separator in front
+    bool open;              // An object was opened and has no fields yet
+    bool in_array;
+    size_t items;           // Items written in the open array
+    bool failed;
+    char buffer[FLD_WRITER_BUFFER_SIZE];
+} fld_writer;
 
 /**
- * @brief Retrieves a vec3 value from a field object based on the provided path.
+ * @brief Sets up a writer into the caller's buffer.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired vec3 value.
- * @param out_x A pointer to store the x component.
- * @param out_y A pointer to store the y component.
- * @param out_z A pointer to store the z component.
- * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ * Like snprintf, text that doesn't fit is still counted, so writing with a
+ * NULL buffer tells the size needed. The text is null-terminated by
+ * fld_writer_finish when there is room.
+ *
+ * @param writer The writer.
+ * @param buffer Where to write, may be NULL if `size` is 0.
+ * @param size The size of the buffer.
+ * @param flags A combination of fld_write_flags.
  */
-extern bool fld_get_vec3(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z);
+extern void fld_writer_init(fld_writer *writer, char *buffer, size_t size, uint32_t flags);
 
 /**
- * @brief Retrieves a vec4 value from a field object based on the provided path.
+ * @brief Sets up a writer that hands its text to a callback.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired vec4 value.
- * @param out_x A pointer to store the x component.
- * @param out_y A pointer to store the y component.
- * @param out_z A pointer to store the z component.
- * @param out_w A pointer to store the w component.
- * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ * Text is collected in the writer's FLD_WRITER_BUFFER_SIZE byte buffer and
+ * passed on whenever it is full, and by fld_writer_finish.
+ *
+ * @param writer The writer.
+ * @param write Called with every piece of text.
+ * @param user Passed to `write`.
+ * @param flags A combination of fld_write_flags.
  */
-extern bool fld_get_vec4(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z, float *out_w);
+extern void fld_writer_init_callback(fld_writer *writer, fld_write_fn write, void *user, uint32_t flags);
 
 /**
- * @brief Retrieves a vector's components as an array of floats.
+ * @brief Writes the key of the next field.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path associated with the desired vector.
- * @param out_components Buffer to store the components (must be large enough).
- * @param out_count Number of components written (2, 3, or 4).
- * @return true if the object was found and components were retrieved, false otherwise.
+ * A field is a key followed by either fld_write_value or a begin/end pair.
+ * The write functions return false once the writer failed: a callback
+ * stopped it, a float was infinite or NaN or a string was empty, which
+ * FLD text can't hold.
  */
-extern bool fld_get_vec_components(fld_object *object, const char *path, float *out_components, size_t* out_count);
+extern bool fld_write_key(fld_writer *writer, fld_string_view key);
 
 /**
- * @brief Retrieves an object based on a specified path.
- *
- * This function searches for an object starting from the given field object using the provided path.
- * If the object is found, it is returned through the out_object parameter.
+ * @brief Writes a value: a field's value or an item of the open array.
  *
- * @param object Pointer to the object to start the search from.
- * @param path The path to search for within the field object.
- * @param out_object A pointer to a pointer where the found object will be stored.
- * @return true if the object is found and retrieved successfully, false otherwise.
+ * Arrays and objects of a tree are written whole, strings get their
+ * quotes and backslashes escaped, and floats are written with the fewest
+ * digits that read back as the same float.
  */
-extern bool fld_get_object(fld_object *object, const char *path, fld_object **out_object);
+extern bool fld_write_value(fld_writer *writer, const fld_value *value);
+extern bool fld_write_object_begin(fld_writer *writer);
+extern bool fld_write_object_end(fld_writer *writer);
+extern bool fld_write_array_begin(fld_writer *writer);
+extern bool fld_write_array_end(fld_writer *writer);
 
 /**
- * @brief Retrieves an object based on a given key on the same level as given object.
- *
- * This function searches for an object within the given field object using the provided key.
- * It only searches horizontally, staying at the same level, without going deeper.
+ * @brief Writes a list of fields and everything below them.
  *
- * @param object The field object to search within.
- * @param key The key to search for within the field object.
- * @param out_object A pointer to a pointer where the found object will be stored.
- * @return true if the object is found and retrieved successfully, false otherwise.
+ * @param writer The writer.
+ * @param first The first field, usually a parser's root.
  */
-extern fld_object *fld_get_field(fld_object *object, const char *key);
-extern fld_object *fld_get_field_by_path(fld_object *object, const char *path);
+extern bool fld_write_fields(fld_writer *writer, const fld_object *first);
 
-extern bool fld_has_field(fld_object *object, const char *path);
-extern fld_value_type fld_get_type(fld_object *object, const char *path);
-extern bool fld_get_array_size(fld_object *object, const char *path, size_t *out_size);
+/**
+ * @brief Returns callbacks that write what fld_parse_events reports, which
+ * reformats a document without building a tree.
+ */
+extern fld_event_handler fld_writer_handler(fld_writer *writer);
 
 /**
- * @brief Converts a fld_string_view to a null-terminated C string.
- *
- * This function takes a fld_string_view and copies its content into the provided buffer,
- * ensuring that the result is null-terminated. The buffer must be large enough to hold
- * the string view content and the null terminator.
+ * @brief Ends the text and passes the rest of it to the callback.
  *
- * @param str_view The fld_string_view to be converted.
- * @param buffer The buffer where the null-terminated C string will be stored.
- * @param buffer_size The size of the buffer.
- * @return true if the conversion was successful and the buffer was large enough,
- *         false if the buffer was too small to hold the string view content and the null terminator.
+ * @param writer The writer.
+ * @param out_length Receives the length of all the text, may be NULL.
+ * @return true if all of it was written, false if it didn't fit the buffer
+ *         or the writer failed.
  */
-extern bool fld_string_view_to_cstr(fld_string_view str_view, char *buffer, size_t buffer_size);
+extern bool fld_writer_finish(fld_writer *writer, size_t *out_length);
 
 /**
- * @brief Compares a fld_string_view with a C-style string for equality.
- * 
- * This function checks if the given fld_string_view is equal to the provided
- * null-terminated C-style string. The comparison is case-sensitive.
- * 
- * @param str_view The fld_string_view to compare.
- * @param cstr The null-terminated C-style string to compare against.
- * @return true if the fld_string_view and the C-style string are equal, false otherwise.
+ * @brief Writes a tree into a buffer in one call.
+ *
+ * @param root The first field to write.
+ * @param buffer Where to write, may be NULL to only measure.
+ * @param size The size of the buffer.
+ * @param flags A combination of fld_write_flags.
+ * @return The length of the text without the terminator, which didn't fit if
+ *         it is `size` or more. 0 if the tree holds a float or an empty string
+ *         FLD can't write.
  */
-extern bool fld_string_view_eq(fld_string_view str_view, const char* cstr);
+extern size_t fld_write(const fld_object *root, char *buffer, size_t size, uint32_t flags);
 
 /**
- * @brief Estimates the memory required to parse the given source string.
- *
- * This function analyzes the provided source string and returns the estimated
- * amount of memory (in bytes) that would be required to parse it.
+ * @brief Returns the size of the binary image fld_serialize writes for the
+ * given fields and everything below them.
  *
- * @param source A pointer to the source string to be analyzed.
- * @return The estimated memory size in bytes required for parsing the source string.
+ * @param root The first of the fields to write, usually the parser's root.
+ * @return The image size in bytes.
  */
-extern size_t fld_estimate_memory(const char *source);
+extern size_t fld_serialized_size(const fld_object *root);
 
 /**
- * @brief Advances the iterator to the next field object.
+ * @brief Writes the fields into a relocatable binary image.
  *
- * This function retrieves the next field object in the sequence
- * represented by the iterator. If there are no more objects, it
- * returns nullptr.
+ * The image holds the tree with offsets in place of pointers, the lookup
+ * indexes and a pool of all key and string text, so loading it needs no
+ * lexing. It can be loaded by builds with the same pointer size and
+ * fld_object layout (checked on load).
  *
- * @param iter A pointer to the field iterator.
- * @return A pointer to the next field object, or nullptr if there
- *         are no more objects.
+ * @param root The first of the fields to write, usually the parser's root.
+ * @param out Where to write the image, aligned to at least ALIGNOF(fld_object).
+ * @param size The size of the buffer.
+ * @return The number of bytes written, 0 if the buffer is too small.
  */
-extern fld_object *fld_iter_next(fld_iterator *iter);
+extern size_t fld_serialize(const fld_object *root, void *out, size_t size);
 
 /**
- * @brief Retrieves the path from the field iterator.
+ * @brief Loads a binary image written by fld_serialize.
  *
- * This function extracts the path from the given field iterator and stores it
- * in the provided buffer. The buffer size must be sufficient to hold the path.
+ * The offsets are turned back into pointers in place, so the image has to
+ * be writable, aligned like fld_serialize's output and kept alive while the
+ * tree is used. Every offset is bounds checked before it is followed, an
+ * image that fails the checks is left unusable. The index slots are filled
+ * again from the loaded fields instead of being trusted. Afterwards all the
+ * fld_get_* functions and iterators work on the parser's root as usual.
  *
- * @param iter Pointer to the field iterator.
- * @param buffer Pointer to the buffer where the path will be stored.
- * @param buffer_size Size of the buffer.
- * @return true if the path was successfully retrieved and stored in the buffer,
- *         false otherwise.
+ * @param parser The parser that receives the tree.
+ * @param image The image, loaded or mapped copy-on-write.
+ * @param size The size of the image in bytes.
+ * @return true if the image is valid, false with FLD_ERROR_INVALID_IMAGE otherwise.
  */
-extern bool fld_iter_get_path(fld_iterator *iter, char *buffer, size_t buffer_size);
+extern bool fld_load_binary(fld_parser *parser, void *image, size_t size);
 
 /**
- * @brief Initializes a field iterator.
+ * @brief Returns the memory fld_compact needs for the given fields and
+ * everything below them.
+ */
+extern size_t fld_compact_size(const fld_object *root);
+
+/**
+ * @brief Copies the fields into a flat, struct-of-arrays tree.
  *
- * This function initializes a field iterator with the given root object and iterator type.
+ * Nodes are numbered in pre-order and linked by 32-bit indices instead of
+ * pointers, with keys, types and values in separate arrays, which takes well
+ * under half the memory of fld_object nodes. Everything, key and string text
+ * included, is copied into `memory`, so the parser can be reused afterwards.
  *
- * @param iter Pointer to the field iterator to initialize.
- * @param root Pointer to the root field object.
- * @param type Type of the iterator.
+ * @param root The first of the fields to copy, usually the parser's root.
+ * @param memory Where the tree is stored, aligned for any type.
+ * @param size The size of the memory, see fld_compact_size.
+ * @param out Receives the tree.
+ * @return true on success, false if the memory is too small.
+ */
+extern bool fld_compact(const fld_object *root, void *memory, size_t size, fld_compact_tree *out);
+
+/**
+ * @brief Finds the node at a dotted path in a compact tree.
+ *
+ * @return The node's index, or FLD_COMPACT_NONE if there is none.
+ */
+extern uint32_t fld_compact_find(const fld_compact_tree *tree, const char *path);
+
+/**
+ * @brief Returns the key of a node in a compact tree.
+ */
+static inline fld_string_view fld_compact_key(const fld_compact_tree *tree, uint32_t node) {
+    fld_string_view key;
+    key.start = tree->text + tree->keys[node];
+    key.length = (int)tree->key_lengths[node];
+    return key;
+}
+
+/**
+ * @brief Returns the string of a FLD_VALUE_STRING node in a compact tree.
+ */
+static inline fld_string_view fld_compact_string(const fld_compact_tree *tree, uint32_t node) {
+    fld_string_view string;
+    string.start = tree->text + tree->payloads[node].string.offset;
+    string.length = (int)tree->payloads[node].string.length;
+    return string;
+}
+
+/**
+ * @brief Returns the components of a vector node in a compact tree.
+ */
+static inline const float *fld_compact_vec(const fld_compact_tree *tree, uint32_t node) {
+    return (const float*)(tree->data + tree->payloads[node].vec);
+}
+
+/**
+ * @brief Returns the items of a FLD_VALUE_ARRAY node in a compact tree,
+ * laid out like fld_value arrays. See `item_types` for their type.
+ */
+static inline const void *fld_compact_array(const fld_compact_tree *tree, uint32_t node, size_t *out_count) {
+    *out_count = tree->payloads[node].array.count;
+    return tree->data + tree->payloads[node].array.offset;
+}
+
+/**
+ * @brief Sets up an empty overlay.
+ *
+ * An overlay reads a stack of parsed trees as if they were merged, without
+ * copying anything: a path resolves to the field in the topmost layer that
+ * has it. Objects merge, so `window.width` from a higher layer and
+ * `window.height` from a lower one both show through, while a value that
+ * isn't an object hides everything below it in lower layers.
+ *
+ * @param overlay The overlay to set up.
+ * @param cache Storage for resolved paths, may be NULL.
+ * @param capacity Number of entries in `cache`, rounded down to a power of two.
+ */
+extern void fld_overlay_init(fld_overlay *overlay, fld_overlay_entry *cache, uint32_t capacity);
+
+/**
+ * @brief Puts a parser's tree on top of the overlay.
+ *
+ * The parser is referenced, so parsing into it again changes what the
+ * overlay sees. The cache notices that by the parser's generation.
+ *
+ * @return false if the overlay already has FLD_OVERLAY_MAX_LAYERS layers.
+ */
+extern bool fld_overlay_push(fld_overlay *overlay, fld_parser *parser);
+
+/**
+ * @brief Resolves a dotted path through the layers of an overlay.
+ *
+ * Found paths are remembered in the overlay's cache, where a hit costs a
+ * hash of the path and a check of the field's keys against it.
+ *
+ * @return The field of the topmost layer that has the path, NULL if none has.
+ */
+extern fld_object *fld_overlay_get(fld_overlay *overlay, const char *path);
+
+/**
+ * @brief Starts iterating over the merged fields of an object in an overlay.
+ *
+ * Every key on the level is visited once, in the order of the lowest layer
+ * that has it, as the field of the topmost layer that has it. Keys the
+ * lower layers don't have come after theirs.
+ *
+ * @param iter The iterator to set up.
+ * @param overlay The overlay, must not change while iterating.
+ * @param path Dotted path of the object, NULL or "" for the top level.
+ */
+extern void fld_overlay_iter_init(fld_overlay_iter *iter, fld_overlay *overlay, const char *path);
+
+/**
+ * @brief Returns the next merged field, NULL at the end of the level.
+ */
+extern fld_object *fld_overlay_iter_next(fld_overlay_iter *iter);
+
+/**
+ * @brief Returns the memory fld_flatten needs for the overlay.
+ */
+extern size_t fld_flatten_size(fld_overlay *overlay);
+
+/**
+ * @brief Merges the layers of an overlay into one compact tree.
+ *
+ * The result is what fld_compact would make of the merged tree, fields in
+ * the order fld_overlay_iter_next visits them, with everything copied into
+ * `memory` so the layers can go away afterwards.
+ *
+ * @param overlay The overlay to flatten.
+ * @param memory Where the tree is stored, aligned for any type.
+ * @param size The size of the memory, see fld_flatten_size.
+ * @param out Receives the tree.
+ * @return true on success, false if the memory is too small.
+ */
+extern bool fld_flatten(fld_overlay *overlay, void *memory, size_t size, fld_compact_tree *out);
+
+/**
+ * @brief Returns the number of arena bytes used by the last parse,
+ * chunks fetched from a fld_chunk_allocator included.
+ */
+static inline size_t fld_get_memory_used(const fld_parser *parser) {
+    return parser->allocator.retired + (size_t)(parser->allocator.current - parser->allocator.start);
+}
+
+/**
+ * @brief Sets up a parser that holds nothing yet, same as `= {0}`.
+ *
+ * Every parser has to start out like this before it is used, since parsing
+ * hands back the chunks of the previous parse.
+ *
+ * @param parser A pointer to the parser.
+ */
+static inline void fld_parser_init(fld_parser *parser) {
+    memset(parser, 0, sizeof(fld_parser));
+}
+
+/**
+ * @brief Lets the parser grow its arena through the given callbacks.
+ *
+ * Once the memory passed to fld_parse (which may then be NULL with a size
+ * of 0) is full, further chunks are fetched from `allocator->alloc` instead
+ * of failing the parse. Pass NULL to go back to fixed memory only.
+ * Starting a new parse hands the chunks of the previous one back.
+ *
+ * @param parser A pointer to the parser.
+ * @param allocator The callbacks to use, copied into the parser.
+ */
+extern void fld_parser_set_allocator(fld_parser *parser, const fld_chunk_allocator *allocator);
+
+/**
+ * @brief Returns the most arena bytes any parse with this parser used,
+ * the current one included.
+ *
+ * A block of this size holds every document parsed so far without any
+ * chunks, which is what to size pooled memory by.
+ */
+static inline size_t fld_get_memory_peak(const fld_parser *parser) {
+    size_t used = fld_get_memory_used(parser);
+    return used > parser->allocator.peak ? used : parser->allocator.peak;
+}
+
+#ifdef FLD_ENABLE_STATS
+/**
+ * @brief Returns the counters of the parser's last parse.
+ *
+ * Only available when FLD_ENABLE_STATS is defined, without it the counters
+ * aren't compiled in at all.
+ */
+static inline const fld_parse_stats *fld_get_parse_stats(const fld_parser *parser) {
+    return &parser->stats;
+}
+#endif
+
+/**
+ * @brief Drops the tree and rewinds the arena, keeping its memory.
+ *
+ * The arena goes back to the start of the memory last passed to a parse,
+ * and the chunks fetched so far are kept for the next parse instead of
+ * being handed back. Nothing is freed or cleared, so this costs next to
+ * nothing. Bindings resolve again on their next use.
+ *
+ * @param parser A pointer to the parser.
+ */
+extern void fld_parser_reset(fld_parser *parser);
+
+/**
+ * @brief Parses into the memory the parser already has, after a
+ * fld_parser_reset.
+ *
+ * Parsing a stream of documents this way allocates nothing once the
+ * arena (memory plus kept chunks) has grown to fld_get_memory_peak.
+ *
+ * @param parser A parser that parsed before, or was given memory by a parse.
+ * @param source Pointer to the source text.
+ * @param length Length of the source text in bytes.
+ * @param flags A combination of fld_parse_flags.
+ * @return true if parsing is successful, false otherwise.
+ */
+extern bool fld_parse_reuse(fld_parser *parser, const char *source, size_t length, uint32_t flags);
+
+/**
+ * @brief Hands every chunk the parser fetched back to the allocator's
+ * free callback. The parsed tree is no longer valid afterwards.
+ *
+ * @param parser A pointer to the parser.
+ */
+extern void fld_parser_release(fld_parser *parser);
+
+#ifdef FLD_PARSER_THREADS
+// One source of a fld_parse_batch with the arena it is parsed into
+typedef struct {
+    const char *source;
+    size_t length;
+    void *memory;       // May be NULL when the parser has a chunk allocator
+    size_t size;
+    uint32_t flags;     // fld_parse_flags
+} fld_document;
+
+/**
+ * @brief Parses a batch of documents on worker threads.
+ *
+ * Document `i` is parsed into `parsers[i]` exactly like fld_parse_ex would,
+ * errors end up in each parser's `last_error`. Documents are handed out
+ * largest first to whichever worker is free. All parse and access functions
+ * are re-entrant, so any number of parsers can be used on different threads
+ * at once, just not one parser on several. Only available when
+ * FLD_PARSER_THREADS is defined.
+ *
+ * @param parsers One parser per document.
+ * @param documents The documents to parse.
+ * @param count Number of documents.
+ * @param workers Number of threads to parse on, the calling thread included.
+ *        1 or less parses everything on the calling thread.
+ * @return true if every document parsed, false otherwise.
+ */
+extern bool fld_parse_batch(fld_parser *parsers, const fld_document *documents, size_t count, int workers);
+
+/**
+ * @brief Parses one large document on worker threads.
+ *
+ * A structural scan splits the source into ranges of whole top-level fields,
+ * the ranges are parsed with fld_parse_batch, each into chunks of its own,
+ * and their fields are joined in source order. The result is the same tree
+ * fld_parse_ex builds, and errors are reported in whole-source lines and
+ * columns. Memory comes from the parser's chunk allocator, a parser without
+ * one is given one based on malloc. Only available when FLD_PARSER_THREADS
+ * is defined.
+ *
+ * @param parser A pointer to the parser that receives the tree.
+ * @param source Pointer to the source text.
+ * @param length Length of the source text in bytes.
+ * @param flags A combination of fld_parse_flags.
+ * @param workers Number of threads to parse on, the calling thread included.
+ * @return true if parsing is successful, false otherwise.
+ */
+extern bool fld_parse_parallel(fld_parser *parser, const char *source, size_t length, uint32_t flags, int workers);
+
+#ifndef FLD_SHARED_MAX_READERS
+    #define FLD_SHARED_MAX_READERS 64
+#endif
+#ifndef FLD_SHARED_MAX_RETIRED
+    #define FLD_SHARED_MAX_RETIRED 8
+#endif
+
+// Called once a replaced parser has no readers left, to close and free it
+typedef void (*fld_shared_release_fn)(fld_parser *parser, void *user);
+
+// One parsed config read by many threads while another one replaces it.
+// Readers announce the epoch they started in, a replaced parser is released
+// once every reader started after it was replaced.
+typedef struct {
+    fld_parser *volatile current;
+    volatile long epoch;
+    volatile long readers[FLD_SHARED_MAX_READERS];   // Epoch of each reader slot, 0 when idle
+    fld_parser *retired[FLD_SHARED_MAX_RETIRED];
+    long retired_epochs[FLD_SHARED_MAX_RETIRED];    // Epoch they were replaced in
+    int retired_count;
+    fld_shared_release_fn release;
+    void *user;
+} fld_shared_config;
+
+/**
+ * @brief Sets up a shared config with its first parser.
+ *
+ * Readers go through fld_shared_acquire and fld_shared_release, a single
+ * writer thread replaces the parser with fld_shared_publish. Neither side
+ * takes a lock: readers only store their epoch and load a pointer. Only
+ * available when FLD_PARSER_THREADS is defined.
+ *
+ * @param shared The shared config.
+ * @param parser The first parser to publish, with a fully parsed tree. May be NULL.
+ * @param release Called on the writer's thread for parsers nobody reads anymore, may be NULL.
+ * @param user Passed to `release`.
+ */
+extern void fld_shared_init(fld_shared_config *shared, fld_parser *parser, fld_shared_release_fn release, void *user);
+
+/**
+ * @brief Starts reading the current parser.
+ *
+ * The parser stays valid until the matching fld_shared_release, even if a
+ * new one is published in between. Each reading thread uses a slot of its
+ * own, and a slot is acquired once at a time.
+ *
+ * @param shared The shared config.
+ * @param reader The reader's slot, below FLD_SHARED_MAX_READERS.
+ * @return The parser to read, NULL if none was published.
+ */
+extern fld_parser *fld_shared_acquire(fld_shared_config *shared, int reader);
+
+/**
+ * @brief Stops reading the parser returned by fld_shared_acquire.
+ *
+ * @param shared The shared config.
+ * @param reader The reader's slot.
+ */
+extern void fld_shared_release(fld_shared_config *shared, int reader);
+
+/**
+ * @brief Makes a new parser the one readers get.
+ *
+ * The old parser is retired and released once the readers that could still
+ * see it are done, here or in a later fld_shared_publish or
+ * fld_shared_reclaim. Objects left unparsed by FLD_PARSE_LAZY_OBJECTS are
+ * parsed first, since reading those writes to the tree. Only one thread may
+ * publish at a time.
+ *
+ * @param shared The shared config.
+ * @param parser The new parser, with a fully parsed tree.
+ * @return true if it was published, false if FLD_SHARED_MAX_RETIRED old parsers
+ *         are still being read (try again later).
+ */
+extern bool fld_shared_publish(fld_shared_config *shared, fld_parser *parser);
+
+/**
+ * @brief Releases the retired parsers that no reader can see anymore.
+ *
+ * @param shared The shared config.
+ * @return The number of parsers still waiting for readers.
+ */
+extern int fld_shared_reclaim(fld_shared_config *shared);
+
+/**
+ * @brief Releases the current and every retired parser.
+ *
+ * No reader may be active anymore.
+ *
+ * @param shared The shared config.
+ */
+extern void fld_shared_close(fld_shared_config *shared);
+#endif
+
+#ifdef FLD_PARSER_FILE_IO
+/**
+ * @brief Memory maps a file and parses it in place.
+ *
+ * The file is lexed straight from the mapping (zero-copy) and the arena is
+ * allocated for the caller, sized by a quick structural scan of the file.
+ * The mapping and arena of a file parsed before are released first. Only
+ * available when FLD_PARSER_FILE_IO is defined.
+ *
+ * @param parser A pointer to the fld_parser structure that will be used for parsing.
+ * @param path Path of the file to parse.
+ * @return true if parsing is successful, false otherwise. The mapping and the
+ *         arena are released on failure, no need to call fld_close.
+ */
+extern bool fld_parse_file(fld_parser *parser, const char *path);
+
+/**
+ * @brief Releases the file mapping and arena acquired by fld_parse_file.
+ *
+ * @param parser A pointer to the parser that was passed to fld_parse_file.
+ */
+extern void fld_close(fld_parser *parser);
+#endif
+
+/**
+ * @brief Retrieves a string view associated with a given path starting
+ * from the specified fld_object.
+ * 
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired string view.
+ * @param str_view Pointer to an fld_string_view structure where the result will be stored.
+ * @return true if the string view is successfully retrieved, false otherwise.
+ */
+extern bool fld_get_str_view(fld_object *object, const char *path, fld_string_view *str_view);
+
+/**
+ * @brief Retrieves a C-string value associated with a given path starting from a field object.
+ *
+ * This function searches for a path starting from  the specified field object and, if found,
+ * copies the associated C-string value into the provided buffer. The buffer size
+ * must be large enough to hold the value, including the null-terminator.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired C-string value.
+ * @param buffer Pointer to the buffer where the retrieved C-string value will be stored.
+ * @param buffer_size The size of the buffer, in bytes.
+ * @return true if the object was found and the value was successfully copied to the buffer; 
+ *         false otherwise.
+ */
+extern bool fld_get_cstr(fld_object *object, const char *path, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Retrieves an integer value from an object at a given path.
+ *
+ * This function searches for the specified path starting from the given field object and,
+ * if found, assigns the corresponding integer value to the output parameter.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired integer value.
+ * @param out_value A pointer to an integer where the retrieved value will be stored.
+ * @return true if the path was found and the value was successfully retrieved, false otherwise.
+ */
+extern bool fld_get_int(fld_object *object, const char *path, int *out_value);
+
+/**
+ * @brief Retrieves a 64-bit integer value associated with a given path
+ * starting from the specified fld_object. Works for any integer field,
+ * whether it fits in an int or not.
+ *
+ * @param object Pointer to the fld_object from which to start the search.
+ * @param path The path associated with the desired integer value.
+ * @param out_value Pointer to an int64_t where the retrieved value will be stored.
+ * @return true if the integer value is successfully retrieved, false otherwise.
+ */
+extern bool fld_get_int64(fld_object *object, const char *path, int64_t *out_value);
+
+/**
+ * @brief Retrieves a float value from a field object based on the provided path.
+ *
+ * This function searches for the specified path starting from the given object and,
+ * if found, assigns the corresponding float value to the output parameter.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired float value.
+ * @param out_value A pointer to a float where the retrieved value will be stored.
+ * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ */
+extern bool fld_get_float(fld_object *object, const char *path, float *out_value);
+
+/**
+ * @brief Retrieves a bool value from a field object based on the provided path.
+ *
+ * This function searches for an object with a specified path starting from
+ * the given field object and, if found, assigns the corresponding bool value
+ * to the output parameter.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired bool value.
+ * @param out_value A pointer to a bool where the retrieved value will be stored.
+ * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ */
+extern bool fld_get_bool(fld_object *object, const char *path, bool *out_value);
+
+
+/**
+ * @brief Retrieves an array from a field object based on a path.
+ *
+ * This function searches for an array associated with the specified path starting from the given field object.
+ * If the key is found and the associated value is an array, assigns the array's type, items,
+ * and count through the output parameters.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the array to retrieve.
+ * @param out_type Pointer to a variable to receive the type of the array elements.
+ * @param out_items Pointer to a variable to receive the pointer to the array items.
+ * @param out_count Pointer to a variable to receive the count of items in the array.
+ * @return true if the array is found and successfully retrieved, false otherwise.
+ */
+extern bool fld_get_array(fld_object *object, const char *path, fld_value_type *out_type, void** out_items, size_t* out_count);
+
+/**
+ * @brief Retrieves a vec2 value from a field object based on the provided path.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired vec2 value.
+ * @param out_x A pointer to store the x component.
+ * @param out_y A pointer to store the y component.
+ * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ */
+extern bool fld_get_vec2(fld_object *object, const char *path, float *out_x, float *out_y);
+
+/**
+ * @brief Retrieves a vec3 value from a field object based on the provided path.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired vec3 value.
+ * @param out_x A pointer to store the x component.
+ * @param out_y A pointer to store the y component.
+ * @param out_z A pointer to store the z component.
+ * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ */
+extern bool fld_get_vec3(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z);
+
+/**
+ * @brief Retrieves a vec4 value from a field object based on the provided path.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired vec4 value.
+ * @param out_x A pointer to store the x component.
+ * @param out_y A pointer to store the y component.
+ * @param out_z A pointer to store the z component.
+ * @param out_w A pointer to store the w component.
+ * @return true if the object was found and the value was successfully retrieved, false otherwise.
+ */
+extern bool fld_get_vec4(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z, float *out_w);
+
+/**
+ * @brief Retrieves a vector's components as an array of floats.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path associated with the desired vector.
+ * @param out_components Buffer to store the components (must be large enough).
+ * @param out_count Number of components written (2, 3, or 4).
+ * @return true if the object was found and components were retrieved, false otherwise.
+ */
+extern bool fld_get_vec_components(fld_object *object, const char *path, float *out_components, size_t* out_count);
+
+/**
+ * @brief Retrieves an object based on a specified path.
+ *
+ * This function searches for an object starting from the given field object using the provided path.
+ * If the object is found, it is returned through the out_object parameter.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path The path to search for within the field object.
+ * @param out_object A pointer to a pointer where the found object will be stored.
+ * @return true if the object is found and retrieved successfully, false otherwise.
+ */
+extern bool fld_get_object(fld_object *object, const char *path, fld_object **out_object);
+
+/**
+ * @brief Retrieves an object based on a given key on the same level as given object.
+ *
+ * This function searches for an object within the given field object using the provided key.
+ * It only searches horizontally, staying at the same level, without going deeper.
+ *
+ * @param object The field object to search within.
+ * @param key The key to search for within the field object.
+ * @param out_object A pointer to a pointer where the found object will be stored.
+ * @return true if the object is found and retrieved successfully, false otherwise.
+ */
+extern fld_object *fld_get_field(fld_object *object, const char *key);
+
+/**
+ * @brief Returns the first field of an object value.
+ *
+ * The body of an object left unparsed by FLD_PARSE_LAZY_OBJECTS is parsed
+ * first, which is why reading `value.as.object` directly isn't enough for
+ * those. All the fld_get_* functions and iterators go through this.
+ *
+ * @param field A field holding an object.
+ * @return The object's first field, NULL if it is empty or not an object.
+ */
+extern fld_object *fld_get_children(fld_object *field);
+
+/**
+ * @brief Hashes a key the same way the lookup index does (32-bit FNV-1a).
+ *
+ * @param key Pointer to the first character of the key.
+ * @param length Length of the key in bytes.
+ * @return The hash of the key.
+ */
+static inline uint32_t fld_hash_key(const char *key, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)key[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+extern fld_object *fld_get_field_by_path(fld_object *object, const char *path);
+
+extern bool fld_has_field(fld_object *object, const char *path);
+extern fld_value_type fld_get_type(fld_object *object, const char *path);
+extern bool fld_get_array_size(fld_object *object, const char *path, size_t *out_size);
+
+/**
+ * @brief Sets the value at a path of a parser's tree, adding what is missing.
+ *
+ * Missing fields along the path are added as objects, and a missing last
+ * field is appended to its object. An existing field keeps its place and
+ * pointer and only gets the new value, so bindings and held pointers keep
+ * working. New fields, keys and strings come from the parser's arena
+ * (fields removed earlier are reused first) and lookup indexes are kept up
+ * to date. Changing a value is a path lookup, and adding a field appends
+ * it in O(1) to a list with an index (lists shorter than
+ * FLD_INDEX_MIN_FIELDS are walked).
+ *
+ * Edits aren't thread safe, and a tree published with fld_shared_publish
+ * must not be edited anymore.
+ *
+ * @param parser The parser whose tree is edited, it may hold no tree yet.
+ * @param path A dotted path, like the getters take.
+ * @param value The new value.
+ * @return The field, or NULL if a field along the path isn't an object or
+ *         the arena is full (FLD_ERROR_OUT_OF_MEMORY in the last error).
+ */
+extern fld_object *fld_set_int(fld_parser *parser, const char *path, int value);
+extern fld_object *fld_set_int64(fld_parser *parser, const char *path, int64_t value);
+extern fld_object *fld_set_float(fld_parser *parser, const char *path, float value);
+extern fld_object *fld_set_bool(fld_parser *parser, const char *path, bool value);
+
+/**
+ * @brief Sets a string value, the text is copied into the arena.
+ *
+ * FLD has no empty strings, so an empty `text` is refused.
+ */
+extern fld_object *fld_set_str(fld_parser *parser, const char *path, const char *text);
+
+/**
+ * @brief Sets a vec2, vec3 or vec4 value from `count` (2 to 4) components.
+ */
+extern fld_object *fld_set_vec(fld_parser *parser, const char *path, const float *components, int count);
+
+/**
+ * @brief Returns the object at a path, adding an empty one if it is missing.
+ *
+ * A field there that isn't an object is turned into an empty one.
+ */
+extern fld_object *fld_add_object(fld_parser *parser, const char *path);
+
+/**
+ * @brief Removes the field at a path, with everything below it.
+ *
+ * The removed fields are reused by later edits. Bindings resolve again.
+ * Lists are singly linked, so this walks the siblings before the field.
+ *
+ * @return true if there was a field to remove.
+ */
+extern bool fld_remove_field(fld_parser *parser, const char *path);
+
+/**
+ * @brief Appends an item to the array at a path, adding the array if it is
+ * missing.
+ *
+ * An empty array takes the type of its first item. Ints go into int64
+ * arrays, and an item that needs 64 bits turns an int array into an int64
+ * one, like in a parse. Items are kept contiguous: an array at the top of
+ * the arena grows in place, any other one is moved there first, so
+ * appending to the same array over and over stays cheap.
+ *
+ * @param parser The parser whose tree is edited.
+ * @param path A dotted path.
+ * @param item A string, int, int64, float or bool. Strings are copied and
+ *             can't be empty.
+ * @return false if the field isn't an array, the item doesn't fit its type,
+ *         or the arena is full.
+ */
+extern bool fld_array_append(fld_parser *parser, const char *path, const fld_value *item);
+
+/**
+ * @brief Parses fields from text into the object at a path of a parser's tree.
+ *
+ * Meant for overrides like `display = { brightness = 0.8; };` under
+ * "settings": a field of the text that the object doesn't have is added, an
+ * object meets an existing object by merging into it, and anything else
+ * replaces the old value in place. The text is copied into the parser's
+ * arena and parsed there, no second parser is involved. The object at
+ * `path` is added if it is missing, see fld_add_object.
+ *
+ * The whole text is parsed before the tree is touched, a text with an
+ * error leaves the tree as it was. Like the other edits, this isn't thread
+ * safe.
+ *
+ * @param parser The parser whose tree is edited, it may hold no tree yet.
+ * @param path The object to parse into, NULL or "" for the top level.
+ * @param source Null-terminated FLD text: fields, as at the top of a file.
+ * @return true on success. Errors are in the last error, lines and columns
+ *         counted in `source`. FLD_ERROR_INVALID_PATH if a field along
+ *         `path` isn't an object.
+ */
+extern bool fld_parse_into(fld_parser *parser, const char *path, const char *source);
+
+/**
+ * @brief Compiles a dotted path into a reusable handle.
+ *
+ * The path is split into segments and every segment is hashed up front,
+ * so resolving the handle later doesn't have to copy or tokenize anything.
+ * Empty segments are skipped, the same way the getters treat them.
+ *
+ * @param out_path Pointer to the path handle to fill in.
+ * @param path The dotted path to compile.
+ * @return true if the path was compiled, false if it is empty, too long
+ *         or has more than FLD_MAX_PATH_SEGMENTS segments.
+ */
+extern bool fld_path_compile(fld_path *out_path, const char *path);
+
+/**
+ * @brief Resolves a compiled path starting from the given object.
+ *
+ * @param object Pointer to the object to start the search from.
+ * @param path Pointer to the compiled path.
+ * @return A pointer to the field the path points to, or NULL if not found.
+ */
+extern fld_object *fld_path_resolve(fld_object *object, const fld_path *path);
+
+/**
+ * @brief Binds a compiled path to a parser and resolves it against its root.
+ *
+ * The resolved field is cached in the binding. It is resolved again
+ * automatically when the parser parses a new document.
+ *
+ * @param binding Pointer to the binding to initialize.
+ * @param path Pointer to the compiled path, must outlive the binding.
+ * @param parser Pointer to the parser holding the tree.
+ * @return A pointer to the resolved field, or NULL if not found.
+ */
+extern fld_object *fld_bind(fld_binding *binding, const fld_path *path, fld_parser *parser);
+
+/**
+ * @brief Returns the field a binding points to.
+ *
+ * This is a pointer read when the parser hasn't parsed anything new since
+ * the binding was resolved, otherwise the path gets resolved again.
+ *
+ * @param binding Pointer to the binding.
+ * @return A pointer to the bound field, or NULL if it doesn't exist.
+ */
+static inline fld_object *fld_binding_get(fld_binding *binding) {
+    if (binding->generation != binding->parser->generation) {
+        return fld_bind(binding, binding->path, binding->parser);
+    }
+    return binding->field;
+}
+
+static inline bool fld_binding_get_int(fld_binding *binding, int *out_value) {
+    fld_object *field = fld_binding_get(binding);
+    if (!field || field->value.type != FLD_VALUE_INT) return false;
+    *out_value = field->value.as.integer;
+    return true;
+}
+
+static inline bool fld_binding_get_int64(fld_binding *binding, int64_t *out_value) {
+    fld_object *field = fld_binding_get(binding);
+    if (!field) return false;
+    if (field->value.type == FLD_VALUE_INT) {
+        *out_value = field->value.as.integer;
+        return true;
+    }
+    if (field->value.type != FLD_VALUE_INT64) return false;
+    *out_value = field->value.as.int64;
+    return true;
+}
+
+static inline bool fld_binding_get_float(fld_binding *binding, float *out_value) {
+    fld_object *field = fld_binding_get(binding);
+    if (!field || field->value.type != FLD_VALUE_FLOAT) return false;
+    *out_value = field->value.as.float_val;
+    return true;
+}
+
+static inline bool fld_binding_get_bool(fld_binding *binding, bool *out_value) {
+    fld_object *field = fld_binding_get(binding);
+    if (!field || field->value.type != FLD_VALUE_BOOL) return false;
+    *out_value = field->value.as.boolean;
+    return true;
+}
+
+static inline bool fld_binding_get_vec2(fld_binding *binding, float *out_x, float *out_y) {
+    fld_object *field = fld_binding_get(binding);
+    if (!field || field->value.type != FLD_VALUE_VEC2) return false;
+    *out_x = field->value.as.vec2.x;
+    *out_y = field->value.as.vec2.y;
+    return true;
+}
+
+static inline bool fld_binding_get_vec3(fld_binding *binding, float *out_x, float *out_y, float *out_z) {
+    fld_object *field = fld_binding_get(binding);
+    if (!field || field->value.type != FLD_VALUE_VEC3) return false;
+    *out_x = field->value.as.vec3.x;
+    *out_y = field->value.as.vec3.y;
+    *out_z = field->value.as.vec3.z;
+    return true;
+}
+
+static inline bool fld_binding_get_vec4(fld_binding *binding, float *out_x, float *out_y, float *out_z, float *out_w) {
+    fld_object *field = fld_binding_get(binding);
+    if (!field || field->value.type != FLD_VALUE_VEC4) return false;
+    *out_x = field->value.as.vec4.x;
+    *out_y = field->value.as.vec4.y;
+    *out_z = field->value.as.vec4.z;
+    *out_w = field->value.as.vec4.w;
+    return true;
+}
+
+/**
+ * @brief Compiles schema descriptors into a trie of their path segments.
+ *
+ * Paths with a common prefix share their first segments, so filling the
+ * schema resolves each object on the way only once. The descriptors and
+ * their paths are referenced, not copied.
+ *
+ * @param schema Receives the compiled schema.
+ * @param fields The descriptors.
+ * @param count Number of descriptors.
+ * @param nodes Storage for the trie, at most one node per path segment.
+ * @param capacity Number of nodes in `nodes`.
+ * @return false if a path is empty, listed twice, a type isn't supported
+ *         or `nodes` is too small.
+ */
+extern bool fld_schema_compile(fld_schema *schema, const fld_schema_field *fields, uint32_t count, fld_schema_node *nodes, uint32_t capacity);
+
+/**
+ * @brief Fills a struct from the tree in one walk, as described by a schema.
+ *
+ * Every object on the schema's paths is visited once, looking up the
+ * segments below it (hashed when the object has an index). Values of the
+ * wrong type count as missing and leave their destination untouched.
+ *
+ * @param schema A compiled schema.
+ * @param root The fields to start from, usually the parser's root.
+ * @param out The struct the descriptors' offsets point into.
+ * @param out_missing Optional, (field_count + 63) / 64 words that receive a
+ *        set bit for every descriptor that wasn't filled.
+ * @return true if every FLD_SCHEMA_REQUIRED descriptor was filled.
+ */
+extern bool fld_schema_fill(const fld_schema *schema, fld_object *root, void *out, uint64_t *out_missing);
+
+/**
+ * @brief Converts a fld_string_view to a null-terminated C string.
+ *
+ * This function takes a fld_string_view and copies its content into the provided buffer,
+ * ensuring that the result is null-terminated. The buffer must be large enough to hold
+ * the string view content and the null terminator.
+ *
+ * @param str_view The fld_string_view to be converted.
+ * @param buffer The buffer where the null-terminated C string will be stored.
+ * @param buffer_size The size of the buffer.
+ * @return true if the conversion was successful and the buffer was large enough,
+ *         false if the buffer was too small to hold the string view content and the null terminator.
+ */
+extern bool fld_string_view_to_cstr(fld_string_view str_view, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Compares a fld_string_view with a C-style string for equality.
+ * 
+ * This function checks if the given fld_string_view is equal to the provided
+ * null-terminated C-style string. The comparison is case-sensitive.
+ * 
+ * @param str_view The fld_string_view to compare.
+ * @param cstr The null-terminated C-style string to compare against.
+ * @return true if the fld_string_view and the C-style string are equal, false otherwise.
+ */
+extern bool fld_string_view_eq(fld_string_view str_view, const char* cstr);
+
+/**
+ * @brief Estimates the memory required to parse the given source string.
+ *
+ * This function analyzes the provided source string and returns the amount
+ * of memory (in bytes) that would be required to parse it. The result is
+ * exact for valid sources (see fld_measure) and an upper bound otherwise.
+ *
+ * @param source A pointer to the source string to be analyzed.
+ * @return The estimated memory size in bytes required for parsing the source string.
+ */
+extern size_t fld_estimate_memory(const char *source);
+
+/**
+ * @brief Advances the iterator to the next field object.
+ *
+ * This function retrieves the next field object in the sequence
+ * represented by the iterator. If there are no more objects, it
+ * returns nullptr.
+ *
+ * @param iter A pointer to the field iterator.
+ * @return A pointer to the next field object, or nullptr if there
+ *         are no more objects.
+ */
+extern fld_object *fld_iter_next(fld_iterator *iter);
+
+/**
+ * @brief Retrieves the path from the field iterator.
+ *
+ * This function extracts the path from the given field iterator and stores it
+ * in the provided buffer. The buffer size must be sufficient to hold the path.
+ *
+ * @param iter Pointer to the field iterator.
+ * @param buffer Pointer to the buffer where the path will be stored.
+ * @param buffer_size Size of the buffer.
+ * @return true if the path was successfully retrieved and stored in the buffer,
+ *         false otherwise.
+ */
+extern bool fld_iter_get_path(fld_iterator *iter, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Initializes a field iterator.
+ *
+ * This function initializes a field iterator with the given root object and iterator type.
+ *
+ * @param iter Pointer to the field iterator to initialize.
+ * @param root Pointer to the root field object.
+ * @param type Type of the iterator.
  */
 static inline void fld_iter_init(fld_iterator *iter, fld_object *root, fld_iter_type type) {
     iter->type = type;
@@ -481,1124 +1851,5509 @@ static inline void fld_iter_init(fld_iterator *iter, fld_object *root, fld_iter_
     iter->parent = NULL;
 }
 
-/**
- * @brief Retrieves the last error encountered by the parser.
- *
- * This function returns the last error that was recorded in the given parser.
- *
- * @param parser A pointer to the fld_parser structure.
- * @return The last error encountered by the parser.
- */
-static inline fld_error fld_get_last_error(fld_parser *parser) {
-    return parser->last_error;
+/**
+ * @brief Retrieves the last error encountered by the parser.
+ *
+ * This function returns the last error that was recorded in the given parser.
+ *
+ * @param parser A pointer to the fld_parser structure.
+ * @return The last error encountered by the parser.
+ */
+static inline fld_error fld_get_last_error(fld_parser *parser) {
+    return parser->last_error;
+}
+
+/**
+ * @brief Converts a field error code to a human-readable string.
+ *
+ * This function takes a field error code and returns a constant string
+ * describing the error. It is useful for logging and debugging purposes.
+ *
+ * @param code The field error code to convert.
+ * @return A constant string describing the error.
+ */
+static inline const char *fld_error_string(fld_error_code code) {
+    switch (code) {
+        case FLD_ERROR_NONE: return "No error";
+        case FLD_ERROR_OUT_OF_MEMORY: return "Out of memory";
+        case FLD_ERROR_UNEXPECTED_TOKEN: return "Unexpected token";
+        case FLD_ERROR_INVALID_NUMBER: return "Invalid number format";
+        case FLD_ERROR_INSUFFICIENT_MEMORY: return "Insufficient memory provided";
+        case FLD_ERROR_ARRAY_TYPE_MISMATCH: return "Array type mismatch";
+        case FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE: return "Unsupported array type";
+        case FLD_ERROR_ARRAY_TOO_MANY_ITEMS: return "Too many items in array";
+        case FLD_ERROR_FILE_IO: return "Could not read file";
+        case FLD_ERROR_INVALID_IMAGE: return "Invalid binary image";
+        case FLD_ERROR_INVALID_ESCAPE: return "Invalid escape sequence in string";
+        case FLD_ERROR_INVALID_PATH: return "Path goes through a field that isn't an object";
+        case FLD_ERROR_STRING_TOO_LONG: return "Decoded string too long for the event buffer";
+        default: return "Unknown error";
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+// TEMP: For developing
+// #define FLD_PARSER_IMPLEMENTATION
+#ifdef FLD_PARSER_IMPLEMENTATION
+
+#if defined(FLD_PARSER_FILE_IO) || defined(FLD_PARSER_THREADS)
+    #include <stdlib.h>
+    #if defined(_WIN32)
+        #define WIN32_LEAN_AND_MEAN
+        #include <windows.h>
+    #else
+        #include <fcntl.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #include <unistd.h>
+    #endif
+#endif
+
+#if defined(FLD_PARSER_THREADS) && !defined(_WIN32)
+    #include <pthread.h>
+#endif
+
+// Counting and timing for fld_parse_stats, compiled out without FLD_ENABLE_STATS
+#ifdef FLD_ENABLE_STATS
+    #if defined(_WIN32)
+        #define WIN32_LEAN_AND_MEAN
+        #include <windows.h>
+    #else
+        #include <time.h>
+    #endif
+    #define FLD_STAT(statement) statement
+
+static uint64_t _stats_now(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    // Strict ISO C modes hide clock_gettime, C11's wall clock does then
+    struct timespec now;
+    #if defined(CLOCK_MONOTONIC)
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    #else
+        timespec_get(&now, TIME_UTC);
+    #endif
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+#else
+    #define FLD_STAT(statement)
+#endif
+
+// Vectorized trivia skipping, define FLD_NO_SIMD to use the scalar path only
+#if !defined(FLD_NO_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define FLD_SIMD_SSE2
+    #elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+        #include <arm_neon.h>
+        #define FLD_SIMD_NEON
+    #endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+// Forward declarations
+static bool _parse_object(fld_parser *parser, fld_object *parent, fld_value *out_value);
+static bool _parse_value(fld_parser *parser, fld_object *parent, fld_value *out_value);
+static fld_object *_parse_field(fld_parser *parser, fld_object *parent);
+static bool _parse_vec(fld_parser *parser, fld_object *parent, fld_value *out_value);
+
+// Header in front of every chunk fetched from the backing allocator
+typedef struct fld_chunk {
+    struct fld_chunk *prev;
+    size_t size;
+} fld_chunk;
+
+static void _bump_free_chunks(fld_bump_allocator *alloc, fld_chunk *chunk) {
+    while (chunk) {
+        fld_chunk *prev = chunk->prev;
+        if (alloc->backing.free) {
+            alloc->backing.free(chunk, chunk->size, alloc->backing.user);
+        }
+        chunk = prev;
+    }
+}
+
+static inline void _bump_note_peak(fld_bump_allocator *alloc) {
+    size_t used = alloc->retired + (size_t)(alloc->current - alloc->start);
+    if (used > alloc->peak) {
+        alloc->peak = used;
+    }
+}
+
+// Hands every chunk back, spare ones included. The peak is kept.
+static void _bump_release(fld_bump_allocator *alloc) {
+    _bump_note_peak(alloc);
+    _bump_free_chunks(alloc, alloc->chunks);
+    _bump_free_chunks(alloc, alloc->spare);
+
+    alloc->chunks = NULL;
+    alloc->spare = NULL;
+    alloc->retired = 0;
+    alloc->start = NULL;
+    alloc->current = NULL;
+    alloc->end = NULL;
+}
+
+// Keeps the backing allocator and the peak, chunks of a previous parse
+// must be released first
+static inline void _bump_init(fld_bump_allocator *alloc, void *memory, size_t size) {
+    alloc->start = (uint8_t*)memory;
+    alloc->current = alloc->start;
+    alloc->end = alloc->start + size;
+    alloc->base = alloc->start;
+    alloc->base_end = alloc->end;
+    alloc->chunks = NULL;
+    alloc->retired = 0;
+    // TODO: maybe zero out the whole block of memory?
+}
+
+// Takes the smallest spare chunk with room for `size` bytes off the spare
+// list, so the big ones are left for the requests that need them
+static fld_chunk *_bump_take_spare(fld_bump_allocator *alloc, size_t size) {
+    fld_chunk **best = NULL;
+    for (fld_chunk **link = &alloc->spare; *link; link = &(*link)->prev) {
+        if ((*link)->size >= sizeof(fld_chunk) + size && (!best || (*link)->size < (*best)->size)) {
+            best = link;
+        }
+    }
+    if (!best) return NULL;
+
+    fld_chunk *chunk = *best;
+    *best = chunk->prev;
+    return chunk;
+}
+
+// Switches to a fresh chunk with room for at least `size` bytes, a spare
+// one if there is one big enough. Whatever is left in the current block
+// is given up.
+static bool _bump_grow(fld_bump_allocator *alloc, size_t size) {
+    fld_chunk *chunk = _bump_take_spare(alloc, size);
+    if (!chunk) {
+        if (!alloc->backing.alloc) return false;
+
+        size_t chunk_size = alloc->backing.chunk_size ? alloc->backing.chunk_size : FLD_CHUNK_SIZE;
+        if (chunk_size < sizeof(fld_chunk) + size) {
+            chunk_size = sizeof(fld_chunk) + size;
+        }
+
+        chunk = (fld_chunk*)alloc->backing.alloc(chunk_size, alloc->backing.user);
+        if (!chunk) return false;
+        chunk->size = chunk_size;
+    }
+
+    chunk->prev = alloc->chunks;
+    alloc->chunks = chunk;
+
+    alloc->retired += (size_t)(alloc->current - alloc->start);
+    alloc->start = (uint8_t*)(chunk + 1);
+    alloc->current = alloc->start;
+    alloc->end = (uint8_t*)chunk + chunk->size;
+    return true;
+}
+
+static inline uintptr_t _align_up(uintptr_t addr, size_t align) {
+    return (addr + (align - 1) & ~(align - 1));
+}
+
+static inline void *_bump_alloc(fld_bump_allocator *alloc, size_t size, size_t align) {
+    uintptr_t aligned = _align_up((uintptr_t)alloc->current, align);
+
+    // Check if we have enough space by address comparison. Without memory
+    // of its own the parser starts out with no block at all.
+    if (!alloc->current || aligned + size > (uintptr_t)alloc->end) {
+        if (!_bump_grow(alloc, size + align)) {
+            return 0;
+        }
+
+        aligned = _align_up((uintptr_t)alloc->current, align);
+    }
+
+    alloc->current = (uint8_t*)(aligned + size);
+    return (void*)aligned;
+}
+// TODO: this can be used by the aligned bump_alloc
+static inline void *_bump_alloc_raw(fld_bump_allocator *alloc, size_t size) {
+    uint8_t *new_current = alloc->current + size;
+
+    // Check if we have enough space by address comparison
+    if (new_current > alloc->end) {
+        return 0;
+    }
+
+    uint8_t* result = alloc->current;
+    alloc->current = new_current;
+    return result;
+}
+
+// Grows the run that starts at `*run` and ends at the top of the arena by
+// `size` bytes. When the block is full the run moves to a fresh chunk, big
+// enough for twice what it holds, and `*run` is updated.
+static void *_bump_extend(fld_bump_allocator *alloc, uint8_t **run, size_t size, size_t align) {
+    if (alloc->current) {
+        void *space = _bump_alloc_raw(alloc, size);
+        if (space) return space;
+    }
+
+    size_t used = alloc->current ? (size_t)(alloc->current - *run) : 0;
+    if (!_bump_grow(alloc, 2 * used + size + align)) {
+        return NULL;
+    }
+
+    uint8_t *moved = (uint8_t*)_bump_alloc(alloc, used, align);
+    if (used > 0) {
+        memcpy(moved, *run, used);
+    }
+    *run = moved;
+
+    return _bump_alloc_raw(alloc, size);
+}
+
+static inline uint32_t _index_capacity(uint32_t count) {
+    // Keep the load factor at or below 2/3
+    uint32_t capacity = 1;
+    while (capacity < count + count / 2 + 1) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static inline size_t _index_size(uint32_t capacity) {
+    return sizeof(fld_index) + capacity * (sizeof(fld_object*) + sizeof(uint32_t));
+}
+
+static inline size_t _index_cost_per_field(void) {
+    // With the load factor above there are at most 3 slots per field
+    return FLD_INDEX_MIN_FIELDS > 0 ? 3 * (sizeof(fld_object*) + sizeof(uint32_t)) : 0;
+}
+
+// Whether a list of `count` fields gets a lookup index
+static inline bool _index_wanted(size_t count) {
+#if FLD_INDEX_MIN_FIELDS > 0
+    return count >= (size_t)FLD_INDEX_MIN_FIELDS;
+#else
+    (void)count;
+    return false;
+#endif
+}
+
+// Structural scanning helpers. These skip over strings and comments without
+// producing tokens, for scans that only care about the shape of the source.
+// The closing quote of the string whose contents start at `p`, NULL if it
+// isn't closed. Jumps from quote to quote with memchr, a quote is escaped
+// when an odd number of backslashes comes right before it.
+static inline const char *_scan_string_end(const char *p, const char *end) {
+    while (p < end) {
+        const char *quote = (const char*)memchr(p, '"', (size_t)(end - p));
+        if (!quote) return NULL;
+
+        const char *run = quote;
+        while (run > p && run[-1] == '\\') {
+            run--;
+        }
+        if (((quote - run) & 1) == 0) return quote;
+        p = quote + 1;
+    }
+    return NULL;
+}
+
+static inline const char *_scan_skip_string(const char *p, const char *end) {
+    // `p` points right after the opening quote
+    const char *quote = _scan_string_end(p, end);
+    return quote ? quote + 1 : end;
+}
+
+static inline const char *_scan_skip_comment(const char *p, const char *end) {
+    // `p` points at a '/', returns it untouched if no comment starts here
+    if (p + 1 >= end) return p;
+
+    if (p[1] == '/') {
+        p += 2;
+        while (p < end && *p != '\n') {
+            p++;
+        }
+        return p;
+    }
+
+    if (p[1] == '*') {
+        p += 2;
+        while (p + 1 < end && !(p[0] == '*' && p[1] == '/')) {
+            p++;
+        }
+        return p + 1 < end ? p + 2 : end;
+    }
+
+    return p;
+}
+
+static inline const char *_scan_skip_space(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        p++;
+    }
+    return p;
+}
+
+// End of the field starting at `p`: right after the first semicolon
+// outside of any brackets. NULL if there is none.
+static const char *_scan_field_end(const char *p, const char *end) {
+    int depth = 0;
+    while (p < end) {
+        char c = *p;
+        if (c == '"') {
+            p = _scan_skip_string(p + 1, end);
+            continue;
+        }
+        if (c == '/') {
+            const char *after = _scan_skip_comment(p, end);
+            if (after != p) {
+                p = after;
+                continue;
+            }
+        }
+
+        if (c == '{' || c == '[' || c == '(') depth++;
+        else if (c == '}' || c == ']' || c == ')') depth--;
+        else if (c == ';' && depth <= 0) return p + 1;
+        p++;
+    }
+    return NULL;
+}
+
+// End of the object whose opening brace is right before `p`: right after
+// its closing brace. NULL if it isn't closed.
+static const char *_scan_object_end(const char *p, const char *end) {
+    int depth = 1;
+    while (p < end) {
+        char c = *p;
+        if (c == '"') {
+            p = _scan_skip_string(p + 1, end);
+            continue;
+        }
+        if (c == '/') {
+            const char *after = _scan_skip_comment(p, end);
+            if (after != p) {
+                p = after;
+                continue;
+            }
+        }
+
+        if (c == '{') depth++;
+        else if (c == '}' && --depth == 0) return p + 1;
+        p++;
+    }
+    return NULL;
+}
+
+// Upper bound of the number of top-level fields: semicolons outside brackets
+static size_t _scan_count_fields(const char *p, const char *end) {
+    size_t count = 0;
+    while ((p = _scan_field_end(p, end)) != NULL) {
+        count++;
+    }
+    return count;
+}
+
+// Hash of a field's source text, 8 bytes at a time
+static uint32_t _content_hash(const char *text, size_t length) {
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ length;
+    while (length >= 8) {
+        uint64_t chunk;
+        memcpy(&chunk, text, 8);
+        hash = (hash ^ chunk) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 32;
+        text += 8;
+        length -= 8;
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, text, length);
+    hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 29;
+
+    // 0 is kept for fields whose text is unknown, see _edit_touch
+    uint32_t folded = (uint32_t)(hash ^ (hash >> 32));
+    return folded ? folded : 1;
+}
+
+#define FLD_PRESCAN_MAX_DEPTH 64
+
+// Upper bound of the arena a parse needs, from a single pass that only looks
+// at structural characters: every '=' is a field, items are counted from the
+// commas inside brackets and their size from the first character of the
+// array, and field counts per list tell which lists get a lookup index.
+static size_t _prescan_memory_needed(const char *source, size_t length, uint32_t flags) {
+    const char *p = source;
+    const char *end = source + length;
+
+    size_t fields = 0;
+    size_t arrays = 0;
+    size_t item_bytes = 0;
+    size_t index_bytes = 0;
+    size_t string_bytes = 0;
+
+    uint32_t list_counts[FLD_PRESCAN_MAX_DEPTH];
+    int depth = 0;
+    list_counts[0] = 0;
+
+    size_t item_size = 0;
+    bool in_array = false;
+
+    while (p < end) {
+        char c = *p;
+        switch (c) {
+            case '"': {
+                // Strings with escapes get decoded, into at most as many bytes
+                const char *after = _scan_skip_string(p + 1, end);
+                if (memchr(p + 1, '\\', (size_t)(after - p - 1))) {
+                    string_bytes += (size_t)(after - p);
+                }
+                p = after;
+                continue;
+            }
+
+            case '/': {
+                const char *after = _scan_skip_comment(p, end);
+                p = (after == p) ? p + 1 : after;
+                continue;
+            }
+
+            case '=':
+                fields++;
+                if (depth < FLD_PRESCAN_MAX_DEPTH) {
+                    list_counts[depth]++;
+                } else {
+                    // Too deep to keep track, assume the worst
+                    index_bytes += _index_cost_per_field() + sizeof(fld_index);
+                }
+                break;
+
+            case '{':
+                depth++;
+                if (depth < FLD_PRESCAN_MAX_DEPTH) list_counts[depth] = 0;
+                break;
+
+            case '}':
+                if (depth > 0 && depth < FLD_PRESCAN_MAX_DEPTH && _index_wanted(list_counts[depth])) {
+                    index_bytes += _index_size(_index_capacity(list_counts[depth])) + ALIGNOF(fld_index);
+                }
+                if (depth > 0) depth--;
+                break;
+
+            case '[': {
+                // The first item tells the storage size of all of them
+                const char *first = _scan_skip_space(p + 1, end);
+                char f = first < end ? *first : ']';
+                if (f == 't' || f == 'f') item_size = sizeof(bool);
+                // Int runs can get widened to int64, which keeps both copies
+                else if (f == '-' || f == '+' || (f >= '0' && f <= '9')) item_size = sizeof(int) + sizeof(int64_t);
+                else item_size = sizeof(fld_string_view);
+
+                arrays++;
+                in_array = true;
+                item_bytes += item_size;
+                break;
+            }
+
+            case ']':
+                in_array = false;
+                break;
+
+            case ',':
+                if (in_array) item_bytes += item_size;
+                break;
+        }
+        p++;
+    }
+
+    if (_index_wanted(list_counts[0])) {
+        index_bytes += _index_size(_index_capacity(list_counts[0])) + ALIGNOF(fld_index);
+    }
+
+    size_t source_copy = (flags & FLD_PARSE_BORROW_SOURCE) ? 0 : length + 1;
+
+    // Padding: objects get realigned after the source copy and after every
+    // array, and a widened array realigns once more
+    size_t padding = (2 * arrays + 1) * ALIGNOF(fld_object);
+
+    return source_copy + fields * sizeof(fld_object) + item_bytes + index_bytes + string_bytes + padding;
+}
+
+static inline bool _is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool _is_alpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+// Powers of five for the decimal exponents q in [-65, 38]: below that every
+// float rounds to zero, above it every float is infinite. Each entry is 5^q
+// normalized to 128 bits (high word first), the same values Eisel-Lemire
+// implementations use, just limited to the binary32 range.
+#define FLD_POW5_MIN (-65)
+#define FLD_POW5_MAX 38
+
+static const uint64_t _fld_pow5_128[2 * (FLD_POW5_MAX - FLD_POW5_MIN + 1)] = {
+    0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL, // 5^-65
+    0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL, // 5^-64
+    0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL, // 5^-63
+    0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL, // 5^-62
+    0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL, // 5^-61
+    0xcdb02555653131b6ULL, 0x3792f412cb06794dULL, // 5^-60
+    0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL, // 5^-59
+    0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL, // 5^-58
+    0xc8de047564d20a8bULL, 0xf245825a5a445275ULL, // 5^-57
+    0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL, // 5^-56
+    0x9ced737bb6c4183dULL, 0x55464dd69685606bULL, // 5^-55
+    0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL, // 5^-54
+    0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL, // 5^-53
+    0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL, // 5^-52
+    0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL, // 5^-51
+    0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL, // 5^-50
+    0x95a8637627989aadULL, 0xdde7001379a44aa8ULL, // 5^-49
+    0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL, // 5^-48
+    0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL, // 5^-47
+    0x9226712162ab070dULL, 0xcab3961304ca70e8ULL, // 5^-46
+    0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL, // 5^-45
+    0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL, // 5^-44
+    0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL, // 5^-43
+    0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL, // 5^-42
+    0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL, // 5^-41
+    0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL, // 5^-40
+    0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL, // 5^-39
+    0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL, // 5^-38
+    0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL, // 5^-37
+    0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL, // 5^-36
+    0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL, // 5^-35
+    0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL, // 5^-34
+    0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL, // 5^-33
+    0xcfb11ead453994baULL, 0x67de18eda5814af2ULL, // 5^-32
+    0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL, // 5^-31
+    0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL, // 5^-30
+    0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL, // 5^-29
+    0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL, // 5^-28
+    0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL, // 5^-27
+    0xc612062576589ddaULL, 0x95364afe032a819eULL, // 5^-26
+    0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL, // 5^-25
+    0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL, // 5^-24
+    0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL, // 5^-23
+    0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL, // 5^-22
+    0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL, // 5^-21
+    0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL, // 5^-20
+    0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL, // 5^-19
+    0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL, // 5^-18
+    0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL, // 5^-17
+    0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL, // 5^-16
+    0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL, // 5^-15
+    0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL, // 5^-14
+    0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL, // 5^-13
+    0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL, // 5^-12
+    0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL, // 5^-11
+    0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL, // 5^-10
+    0x89705f4136b4a597ULL, 0x31680a88f8953031ULL, // 5^-9
+    0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL, // 5^-8
+    0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL, // 5^-7
+    0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL, // 5^-6
+    0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL, // 5^-5
+    0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL, // 5^-4
+    0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL, // 5^-3
+    0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL, // 5^-2
+    0xccccccccccccccccULL, 0xcccccccccccccccdULL, // 5^-1
+    0x8000000000000000ULL, 0x0000000000000000ULL, // 5^0
+    0xa000000000000000ULL, 0x0000000000000000ULL, // 5^1
+    0xc800000000000000ULL, 0x0000000000000000ULL, // 5^2
+    0xfa00000000000000ULL, 0x0000000000000000ULL, // 5^3
+    0x9c40000000000000ULL, 0x0000000000000000ULL, // 5^4
+    0xc350000000000000ULL, 0x0000000000000000ULL, // 5^5
+    0xf424000000000000ULL, 0x0000000000000000ULL, // 5^6
+    0x9896800000000000ULL, 0x0000000000000000ULL, // 5^7
+    0xbebc200000000000ULL, 0x0000000000000000ULL, // 5^8
+    0xee6b280000000000ULL, 0x0000000000000000ULL, // 5^9
+    0x9502f90000000000ULL, 0x0000000000000000ULL, // 5^10
+    0xba43b74000000000ULL, 0x0000000000000000ULL, // 5^11
+    0xe8d4a51000000000ULL, 0x0000000000000000ULL, // 5^12
+    0x9184e72a00000000ULL, 0x0000000000000000ULL, // 5^13
+    0xb5e620f480000000ULL, 0x0000000000000000ULL, // 5^14
+    0xe35fa931a0000000ULL, 0x0000000000000000ULL, // 5^15
+    0x8e1bc9bf04000000ULL, 0x0000000000000000ULL, // 5^16
+    0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL, // 5^17
+    0xde0b6b3a76400000ULL, 0x0000000000000000ULL, // 5^18
+    0x8ac7230489e80000ULL, 0x0000000000000000ULL, // 5^19
+    0xad78ebc5ac620000ULL, 0x0000000000000000ULL, // 5^20
+    0xd8d726b7177a8000ULL, 0x0000000000000000ULL, // 5^21
+    0x878678326eac9000ULL, 0x0000000000000000ULL, // 5^22
+    0xa968163f0a57b400ULL, 0x0000000000000000ULL, // 5^23
+    0xd3c21bcecceda100ULL, 0x0000000000000000ULL, // 5^24
+    0x84595161401484a0ULL, 0x0000000000000000ULL, // 5^25
+    0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL, // 5^26
+    0xcecb8f27f4200f3aULL, 0x0000000000000000ULL, // 5^27
+    0x813f3978f8940984ULL, 0x4000000000000000ULL, // 5^28
+    0xa18f07d736b90be5ULL, 0x5000000000000000ULL, // 5^29
+    0xc9f2c9cd04674edeULL, 0xa400000000000000ULL, // 5^30
+    0xfc6f7c4045812296ULL, 0x4d00000000000000ULL, // 5^31
+    0x9dc5ada82b70b59dULL, 0xf020000000000000ULL, // 5^32
+    0xc5371912364ce305ULL, 0x6c28000000000000ULL, // 5^33
+    0xf684df56c3e01bc6ULL, 0xc732000000000000ULL, // 5^34
+    0x9a130b963a6c115cULL, 0x3c7f400000000000ULL, // 5^35
+    0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL, // 5^36
+    0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL, // 5^37
+    0x96769950b50d88f4ULL, 0x1314448000000000ULL, // 5^38
+};
+
+// 64x64 -> 128 bit multiplication, returns the low half
+static inline uint64_t _mul_128(uint64_t a, uint64_t b, uint64_t *out_high) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *out_high = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, out_high);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *out_high = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+static inline int _leading_zeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int count = 0;
+    while (!(x & 0x8000000000000000ULL)) { x <<= 1; count++; }
+    return count;
+#endif
+}
+
+// Eisel-Lemire: the float closest to w * 10^q as raw bits without the sign,
+// rounding ties to even. `w` must not be zero. Returns false if the result
+// is too big for a float.
+static bool _decimal_to_float_bits(uint64_t w, int q, uint32_t *out_bits) {
+    if (q < FLD_POW5_MIN) {
+        *out_bits = 0;
+        return true;
+    }
+    if (q > FLD_POW5_MAX) return false;
+
+    int lz = _leading_zeros64(w);
+    w <<= lz;
+
+    // Upper 64 bits of w * 5^q. Only 26 of them are needed (23 bits of
+    // mantissa, the implicit one, a rounding bit and the bit telling where
+    // the product starts), the low word of the table is only brought in
+    // when the bits below those are all ones and could still carry.
+    const uint64_t *pow5 = &_fld_pow5_128[2 * (q - FLD_POW5_MIN)];
+    uint64_t high;
+    uint64_t low = _mul_128(w, pow5[0], &high);
+
+    const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFULL >> 26;
+    if ((high & precision_mask) == precision_mask) {
+        uint64_t second_high;
+        _mul_128(w, pow5[1], &second_high);
+        low += second_high;
+        if (second_high > low) high++;
+    }
+
+    int upper_bit = (int)(high >> 63);
+    int shift = upper_bit + 64 - 23 - 3;
+    uint64_t mantissa = high >> shift;
+
+    // floor(log2(10^q)) + 63 is the binary exponent of the product,
+    // 127 is the float exponent bias
+    int32_t power2 = (int32_t)(((152170 + 65536) * q) >> 16) + 63 + upper_bit - lz + 127;
+
+    if (power2 <= 0) {
+        // Subnormal, or too small to be anything but zero
+        if (-power2 + 1 >= 64) {
+            *out_bits = 0;
+            return true;
+        }
+
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+
+        // Rounding up can make it the smallest normal float
+        power2 = (mantissa < (1ULL << 23)) ? 0 : 1;
+        *out_bits = (uint32_t)mantissa | ((uint32_t)power2 << 23);
+        return true;
+    }
+
+    // An exact product right between two floats has to round to even.
+    // That can only happen for small exponents, where 5^q is exact.
+    if (low <= 1 && q >= -17 && q <= 10 && (mantissa & 3) == 1) {
+        if ((mantissa << shift) == high) {
+            mantissa &= ~1ULL;
+        }
+    }
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+
+    if (mantissa >= (2ULL << 23)) {
+        mantissa = 1ULL << 23;
+        power2++;
+    }
+    mantissa &= ~(1ULL << 23);
+
+    if (power2 >= 0xFF) return false;
+
+    *out_bits = (uint32_t)mantissa | ((uint32_t)power2 << 23);
+    return true;
+}
+
+// Exact conversion for numbers with more digits than the mantissa holds
+// that sit too close to a halfway point for Eisel-Lemire to settle. All the
+// digits are compared as a big integer against the point halfway between
+// `lower` and the next float up. Halfway points of floats have fewer than
+// FLD_SLOW_DIGITS significant digits, so any digit after those only tells
+// whether the value is above what was kept.
+#define FLD_SLOW_DIGITS 160
+#define FLD_SLOW_LIMBS 40
+
+typedef struct {
+    uint32_t limbs[FLD_SLOW_LIMBS];     // Least significant first
+    int count;
+} fld_bigint;
+
+static void _bigint_mul_add(fld_bigint *n, uint32_t factor, uint32_t add) {
+    uint64_t carry = add;
+    for (int i = 0; i < n->count; ++i) {
+        uint64_t product = (uint64_t)n->limbs[i] * factor + carry;
+        n->limbs[i] = (uint32_t)product;
+        carry = product >> 32;
+    }
+    if (carry && n->count < FLD_SLOW_LIMBS) {
+        n->limbs[n->count++] = (uint32_t)carry;
+    }
+}
+
+static void _bigint_mul_pow5(fld_bigint *n, int exponent) {
+    for (; exponent >= 13; exponent -= 13) _bigint_mul_add(n, 1220703125u, 0);
+    uint32_t factor = 1;
+    while (exponent-- > 0) factor *= 5;
+    _bigint_mul_add(n, factor, 0);
+}
+
+static void _bigint_shift_left(fld_bigint *n, int bits) {
+    int words = bits / 32;
+    bits %= 32;
+    if (n->count == 0) return;
+    if (n->count + words + 1 > FLD_SLOW_LIMBS) words = FLD_SLOW_LIMBS - n->count - 1;
+
+    n->limbs[n->count + words] = 0;
+    for (int i = n->count - 1; i >= 0; --i) {
+        uint32_t limb = n->limbs[i];
+        if (bits) n->limbs[i + words + 1] |= limb >> (32 - bits);
+        n->limbs[i + words] = limb << bits;
+    }
+    for (int i = 0; i < words; ++i) n->limbs[i] = 0;
+    n->count += words + 1;
+    while (n->count > 0 && n->limbs[n->count - 1] == 0) n->count--;
+}
+
+static int _bigint_compare(const fld_bigint *a, const fld_bigint *b) {
+    if (a->count != b->count) return a->count < b->count ? -1 : 1;
+    for (int i = a->count - 1; i >= 0; --i) {
+        if (a->limbs[i] != b->limbs[i]) return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// `digits` up to `digits_end` is the number without its sign and exponent,
+// `exponent` the value of its e/E part. Returns false if it rounds to
+// infinity.
+static bool _decimal_to_float_slow(const char *digits, const char *digits_end, int exponent, uint32_t lower, uint32_t *out_bits) {
+    fld_bigint value = {{0}, 0};
+    int kept = 0;
+    bool point = false;
+    bool sticky = false;
+    for (const char *p = digits; p < digits_end; ++p) {
+        if (*p == '.') {
+            point = true;
+            continue;
+        }
+        uint32_t digit = (uint32_t)(*p - '0');
+        if (kept == 0 && digit == 0) {
+            if (point) exponent--;
+        } else if (kept < FLD_SLOW_DIGITS) {
+            _bigint_mul_add(&value, 10, digit);
+            kept++;
+            if (point) exponent--;
+        } else {
+            sticky |= digit != 0;
+            if (!point) exponent++;
+        }
+    }
+
+    // Halfway between `lower` and the next float up, as (2m + 1) * 2^(e - 1)
+    uint32_t biased = lower >> 23;
+    uint32_t m = (lower & 0x7FFFFFu) | (biased ? 1u << 23 : 0);
+    int e = (biased ? (int)biased : 1) - 150;
+    fld_bigint halfway = {{2 * m + 1}, 1};
+
+    // Both sides go up to integers, value * 10^exponent against halfway.
+    // Numbers that far out are nowhere near a float boundary.
+    if (exponent > 80 || exponent < -(FLD_SLOW_DIGITS + 80)) {
+        *out_bits = lower;
+        return true;
+    }
+    if (exponent >= 0) _bigint_mul_pow5(&value, exponent);
+    else _bigint_mul_pow5(&halfway, -exponent);
+    int shift = exponent - (e - 1);
+    if (shift >= 0) _bigint_shift_left(&value, shift);
+    else _bigint_shift_left(&halfway, -shift);
+
+    int order = _bigint_compare(&value, &halfway);
+    if (order == 0 && sticky) order = 1;
+    uint32_t bits = (order > 0 || (order == 0 && (lower & 1))) ? lower + 1 : lower;
+    if (bits >= 0x7F800000u) return false;
+
+    *out_bits = bits;
+    return true;
+}
+
+// Bit helpers for the block masks below, `mask` is never 0 for first/last
+static inline int _bit_first(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    int index = 0;
+    while (!(mask & 1)) { mask >>= 1; index++; }
+    return index;
+#endif
+}
+
+static inline int _bit_last(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - __builtin_clz(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (int)index;
+#else
+    int index = 31;
+    while (!(mask & 0x80000000u)) { mask <<= 1; index--; }
+    return index;
+#endif
+}
+
+static inline int _bit_count(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    mask = mask - ((mask >> 1) & 0x55555555u);
+    mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+    return (int)((((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+// 16 byte blocks, `_simd_eq` gives one bit per byte equal to `c`
+#if defined(FLD_SIMD_SSE2)
+    #define FLD_SIMD_WIDTH 16
+    typedef __m128i fld_simd_block;
+
+    static inline fld_simd_block _simd_load(const char *p) {
+        return _mm_loadu_si128((const __m128i*)p);
+    }
+
+    static inline uint32_t _simd_eq(fld_simd_block block, char c) {
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+    }
+#elif defined(FLD_SIMD_NEON)
+    #define FLD_SIMD_WIDTH 16
+    typedef uint8x16_t fld_simd_block;
+
+    static inline fld_simd_block _simd_load(const char *p) {
+        return vld1q_u8((const uint8_t*)p);
+    }
+
+    static inline uint32_t _simd_eq(fld_simd_block block, char c) {
+        // No movemask on NEON, weigh each lane by its bit and add the halves up
+        static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        uint8x16_t hits = vandq_u8(vceqq_u8(block, vdupq_n_u8((uint8_t)c)), vld1q_u8(bits));
+        return (uint32_t)vaddv_u8(vget_low_u8(hits)) | ((uint32_t)vaddv_u8(vget_high_u8(hits)) << 8);
+    }
+#endif
+
+static inline int _lexer_column(const fld_lexer *lexer, const char *at) {
+    return (int)(at - lexer->line_start) + 1;
+}
+
+// Accounts for the newlines marked in `mask`, for the block starting at `p`
+static inline void _lexer_newlines(fld_lexer *lexer, char *p, uint32_t mask) {
+    if (!mask) return;
+
+    lexer->line += _bit_count(mask);
+    lexer->line_start = p + _bit_last(mask) + 1;
+}
+
+static char *_lexer_skip_space(fld_lexer *lexer, char *p) {
+    char *end = lexer->end;
+
+#ifdef FLD_SIMD_WIDTH
+    while (end - p >= FLD_SIMD_WIDTH) {
+        fld_simd_block block = _simd_load(p);
+        uint32_t newline = _simd_eq(block, '\n');
+        uint32_t space = newline | _simd_eq(block, ' ') | _simd_eq(block, '\t') | _simd_eq(block, '\r');
+
+        if (space == 0xFFFF) {
+            _lexer_newlines(lexer, p, newline);
+            p += FLD_SIMD_WIDTH;
+            continue;
+        }
+
+        int stop = _bit_first(~space);
+        _lexer_newlines(lexer, p, newline & ((1u << stop) - 1));
+        return p + stop;
+    }
+#endif
+
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        if (*p == '\n') {
+            lexer->line++;
+            lexer->line_start = p + 1;
+        }
+        p++;
+    }
+    return p;
+}
+
+// `p` points right after the opening `/*`. Returns the position after the
+// closing `*/`, or NULL if the comment never ends.
+static char *_lexer_skip_block_comment(fld_lexer *lexer, char *p) {
+    char *end = lexer->end;
+
+#ifdef FLD_SIMD_WIDTH
+    while (end - p >= FLD_SIMD_WIDTH) {
+        fld_simd_block block = _simd_load(p);
+        uint32_t newline = _simd_eq(block, '\n');
+        uint32_t star = _simd_eq(block, '*');
+
+        if (!star) {
+            _lexer_newlines(lexer, p, newline);
+            p += FLD_SIMD_WIDTH;
+            continue;
+        }
+
+        int at = _bit_first(star);
+        _lexer_newlines(lexer, p, newline & ((1u << at) - 1));
+        p += at;
+        if (p + 1 < end && p[1] == '/') return p + 2;
+        p++;
+    }
+#endif
+
+    while (p < end) {
+        if (*p == '*' && p + 1 < end && p[1] == '/') return p + 2;
+        if (*p == '\n') {
+            lexer->line++;
+            lexer->line_start = p + 1;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+// Skips any run of whitespace and comments in front of the next token.
+// An unterminated block comment is left in place for the scanner to reject.
+static void _lexer_skip_trivia(fld_lexer *lexer) {
+    char *p = lexer->current;
+    char *end = lexer->end;
+
+    while (true) {
+        p = _lexer_skip_space(lexer, p);
+        if (end - p < 2 || p[0] != '/') break;
+
+        if (p[1] == '/') {
+            // Line comment, the newline itself is left for the space skip
+            char *newline = (char*)memchr(p + 2, '\n', (size_t)(end - p - 2));
+            FLD_STAT(lexer->comment_bytes += (size_t)((newline ? newline : end) - p));
+            p = newline ? newline : end;
+        } else if (p[1] == '*') {
+            int line = lexer->line;
+            char *line_start = lexer->line_start;
+
+            char *after = _lexer_skip_block_comment(lexer, p + 2);
+            if (!after) {
+                // Report it where the comment starts
+                lexer->line = line;
+                lexer->line_start = line_start;
+                break;
+            }
+            FLD_STAT(lexer->comment_bytes += (size_t)(after - p));
+            p = after;
+        } else {
+            break;
+        }
+    }
+
+    lexer->current = p;
+}
+
+static bool _lexer_is_at_end(fld_lexer *lexer) {
+    return lexer->current >= lexer->end;
+}
+
+static char _lexer_advance(fld_lexer *lexer) {
+    return *lexer->current++;
+}
+
+// The source is not necessarily null-terminated, so reading past the
+// end yields '\0' instead of touching memory
+static char _lexer_peek(fld_lexer *lexer) {
+    if (_lexer_is_at_end(lexer)) return '\0';
+    return *lexer->current;
+}
+
+static fld_token *_token_create(fld_parser *parser, fld_token_type type, int line, int column) {
+    // Tokens are short lived, so instead of bump allocating them we hand out
+    // whichever slot is not referenced by `current` or `previous`.
+    fld_token *token = parser->tokens;
+    while (token == parser->current || token == parser->previous) {
+        token++;
+    }
+
+    token->type = type;
+    token->line = line;
+    token->column = column;
+    FLD_STAT(parser->stats.tokens[type]++);
+
+    return token;
+}
+
+// Moves the lexer forward to `p`, keeping track of the lines it skips
+static void _lexer_skip_to(fld_lexer *lexer, char *p) {
+    char *newline;
+    while ((newline = (char*)memchr(lexer->current, '\n', (size_t)(p - lexer->current))) != NULL) {
+        lexer->line++;
+        lexer->line_start = newline + 1;
+        lexer->current = newline + 1;
+    }
+    lexer->current = p;
+}
+
+static inline int _hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool _read_hex4(const char *p, const char *end, uint32_t *out) {
+    if (end - p < 4) return false;
+
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        int digit = _hex_digit(p[i]);
+        if (digit < 0) return false;
+        value = (value << 4) | (uint32_t)digit;
+    }
+    *out = value;
+    return true;
+}
+
+// Decodes the escapes of a string's contents into `out`, which may be NULL to
+// only validate and measure. The result is never longer than the source text,
+// so `out` can have room for `length` bytes. Supports \" \\ \/ \b \f \n \r \t
+// and \uXXXX (surrogate pairs included), written as UTF-8.
+static bool _string_unescape(const char *in, size_t length, char *out, size_t *out_length) {
+    const char *p = in;
+    const char *end = in + length;
+    size_t written = 0;
+
+    while (p < end) {
+        const char *backslash = (const char*)memchr(p, '\\', (size_t)(end - p));
+        size_t plain = (size_t)((backslash ? backslash : end) - p);
+        if (out) memcpy(out + written, p, plain);
+        written += plain;
+        if (!backslash) break;
+
+        p = backslash + 1;
+        if (p >= end) return false;
+
+        char decoded;
+        switch (*p++) {
+            case '"': decoded = '"'; break;
+            case '\\': decoded = '\\'; break;
+            case '/': decoded = '/'; break;
+            case 'b': decoded = '\b'; break;
+            case 'f': decoded = '\f'; break;
+            case 'n': decoded = '\n'; break;
+            case 'r': decoded = '\r'; break;
+            case 't': decoded = '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!_read_hex4(p, end, &code)) return false;
+                p += 4;
+
+                if (code >= 0xDC00 && code <= 0xDFFF) return false;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // A high surrogate only makes sense with its low half
+                    uint32_t low;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !_read_hex4(p + 2, end, &low)) return false;
+                    if (low < 0xDC00 || low > 0xDFFF) return false;
+                    p += 6;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                char utf8[4];
+                size_t bytes;
+                if (code < 0x80) {
+                    utf8[0] = (char)code;
+                    bytes = 1;
+                } else if (code < 0x800) {
+                    utf8[0] = (char)(0xC0 | (code >> 6));
+                    utf8[1] = (char)(0x80 | (code & 0x3F));
+                    bytes = 2;
+                } else if (code < 0x10000) {
+                    utf8[0] = (char)(0xE0 | (code >> 12));
+                    utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    utf8[2] = (char)(0x80 | (code & 0x3F));
+                    bytes = 3;
+                } else {
+                    utf8[0] = (char)(0xF0 | (code >> 18));
+                    utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                    utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    utf8[3] = (char)(0x80 | (code & 0x3F));
+                    bytes = 4;
+                }
+                if (out) memcpy(out + written, utf8, bytes);
+                written += bytes;
+                continue;
+            }
+            default:
+                return false;
+        }
+
+        if (out) out[written] = decoded;
+        written++;
+    }
+
+    if (out_length) *out_length = written;
+    return true;
+}
+
+static fld_token *_lexer_handle_string(fld_parser *parser, fld_lexer *lexer) {
+    // Strings can span lines, the token is reported where it starts
+    int line = lexer->line;
+    int column = _lexer_column(lexer, lexer->start);
+
+    char *quote = (char*)_scan_string_end(lexer->current, lexer->end);
+    _lexer_skip_to(lexer, quote ? quote : lexer->end);
+    if (!quote) {
+        // Unterminated string
+        return _token_create(parser, TOKEN_ERROR, line, column);
+    }
+
+    // Consume the closing quote
+    _lexer_advance(lexer);
+
+    // Create token pointing to the string's contents (excluding quotes).
+    // Strings without escapes are used in place, the others are checked
+    // here and decoded into the arena once the value is stored.
+    const char *start = lexer->start + 1;
+    size_t length = (size_t)(quote - start);
+    bool escaped = memchr(start, '\\', length) != NULL;
+    if (escaped && !_string_unescape(start, length, NULL, NULL)) {
+        parser->last_error.code = FLD_ERROR_INVALID_ESCAPE;
+        parser->last_error.line = line;
+        parser->last_error.column = column;
+        return _token_create(parser, TOKEN_ERROR, line, column);
+    }
+
+    fld_token *token = _token_create(parser, TOKEN_STRING, line, column);
+    token->value.string.start = (char*)start;
+    token->value.string.length = (int)length;
+    token->escaped = escaped;
+
+    return token;
+}
+
+// Significant digits that fit in the 64-bit mantissa
+#define FLD_MANTISSA_DIGITS 19
+
+// Reports the number at `at` as invalid, lexing resumes after what was read
+static fld_token *_lexer_number_error(fld_parser *parser, fld_lexer *lexer, const char *at, const char *p) {
+    lexer->current = (char*)p;
+    parser->last_error.code = FLD_ERROR_INVALID_NUMBER;
+    parser->last_error.line = lexer->line;
+    parser->last_error.column = _lexer_column(lexer, at);
+    return _token_create(parser, TOKEN_ERROR, lexer->line, parser->last_error.column);
+}
+
+static fld_token *_lexer_handle_number(fld_parser *parser, fld_lexer *lexer, bool is_negative) {
+    const char *p = lexer->current;
+    const char *end = lexer->end;
+
+    // Skip the sign in input, `is_negative` already knows about it
+    if (*p == '+' || *p == '-') p++;
+
+    // The digits are accumulated into the mantissa as they are read, with no
+    // temporary buffer. Leading zeros don't count as significant, and past
+    // FLD_MANTISSA_DIGITS the remaining digits only move the exponent. Any
+    // of those that isn't zero makes the mantissa a truncation, which the
+    // float conversion has to make up for.
+    const char *digits = p;
+    uint64_t mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool is_float = false;
+    bool truncated = false;
+
+    while (p < end && _is_digit(*p)) {
+        if (significant < FLD_MANTISSA_DIGITS) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            significant += mantissa != 0;
+        } else {
+            truncated |= *p != '0';
+            exponent++;
+        }
+        p++;
+    }
+
+    // Look for decimal point followed by numbers
+    if (p + 1 < end && *p == '.' && _is_digit(p[1])) {
+        is_float = true;
+        p++;
+
+        while (p < end && _is_digit(*p)) {
+            if (significant < FLD_MANTISSA_DIGITS) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                significant += mantissa != 0;
+                exponent--;
+            } else {
+                truncated |= *p != '0';
+            }
+            p++;
+        }
+    }
+    const char *digits_end = p;
+    int scale = 0;
+
+    // Exponent, only when digits follow. Otherwise the `e` is left for
+    // the next token.
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool negative_exponent = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            negative_exponent = (*q == '-');
+            q++;
+        }
+
+        if (q < end && _is_digit(*q)) {
+            int value = 0;
+            while (q < end && _is_digit(*q)) {
+                // Anything this big is zero or infinite anyway
+                if (value < 100000) value = value * 10 + (*q - '0');
+                q++;
+            }
+
+            scale = negative_exponent ? -value : value;
+            exponent += scale;
+            is_float = true;
+            p = q;
+        }
+    }
+
+    lexer->current = (char*)p;
+    int column = _lexer_column(lexer, lexer->start);
+
+    if (is_float) {
+        float value = 0.0f;
+        if (mantissa != 0) {
+            uint32_t bits;
+            bool valid = _decimal_to_float_bits(mantissa, exponent, &bits);
+
+            // The value lies between the truncated mantissa and the next one
+            // up. Where those round apart, only all the digits can tell.
+            uint32_t upper;
+            if (truncated && (!_decimal_to_float_bits(mantissa + 1, exponent, &upper) || !valid || upper != bits)) {
+                valid = valid && _decimal_to_float_slow(digits, digits_end, scale, bits, &bits);
+            }
+            if (!valid) {
+                return _lexer_number_error(parser, lexer, lexer->start, p);
+            }
+            memcpy(&value, &bits, sizeof(float));
+        }
+
+        fld_token *token = _token_create(parser, TOKEN_FLOAT, lexer->line, column);
+        token->value.float_val = is_negative ? -value : value;
+        return token;
+    }
+
+    // Integers have to be exact
+    uint64_t limit = (uint64_t)INT64_MAX + (is_negative ? 1 : 0);
+    if (exponent > 0 || mantissa > limit) {
+        return _lexer_number_error(parser, lexer, lexer->start, p);
+    }
+
+    fld_token *token = _token_create(parser, TOKEN_INT, lexer->line, column);
+    token->value.integer = (is_negative && mantissa) ? -(int64_t)(mantissa - 1) - 1 : (int64_t)mantissa;
+    return token;
+}
+
+static fld_token *_lexer_handle_keyword(fld_parser *parser, fld_lexer *lexer) {
+    while (_is_alpha(_lexer_peek(lexer)) || _is_digit(_lexer_peek(lexer))) {
+        _lexer_advance(lexer);
+    }
+
+    // Check if it's a keyword (true/false)
+    int length = lexer->current - lexer->start;
+    if (length == 4) {
+        // false
+        // TODO: Make it case insensitive!
+        if (strncmp(lexer->start, "true", 4) == 0) {
+            fld_token *token = _token_create(parser, TOKEN_BOOL, lexer->line, _lexer_column(lexer, lexer->start));
+            token->value.boolean = true;
+            return token;
+        }
+        // We just check if it starts with Vec and according to the number
+        // that follows we emit the right token. If something is fishy, we error.
+        if (strncmp(lexer->start, "vec", 3) == 0) {
+            // If it's not 2, 3, 4 -> error!
+            if (lexer->start[3] > '4' || lexer->start[3] < '2') {
+                return _token_create(parser, TOKEN_ERROR, lexer->line, _lexer_column(lexer, lexer->start));
+            }
+
+            // Emit Vec token where the integer value contains the supposed size
+            fld_token *token = _token_create(parser, TOKEN_VEC, lexer->line, _lexer_column(lexer, lexer->start));
+            token->value.integer = lexer->start[3] - 48;
+            return token;
+        }
+    }
+    if (length == 5 && strncmp(lexer->start, "false", 5) == 0) {
+        fld_token *token = _token_create(parser, TOKEN_BOOL, lexer->line, _lexer_column(lexer, lexer->start));
+        token->value.boolean = false;
+        return token;
+    }
+
+    // Regular key
+    fld_token *token = _token_create(parser, TOKEN_KEY, lexer->line, _lexer_column(lexer, lexer->start));
+    token->value.string.start = lexer->start;
+    token->value.string.length = length;
+
+    return token;
+}
+
+static fld_token *_lexer_scan_token(fld_parser *parser) {
+    fld_lexer *lexer = &parser->lexer;
+    
+    // Skip whitespace and comments
+    FLD_STAT(char *before = lexer->current; size_t comments = lexer->comment_bytes);
+    _lexer_skip_trivia(lexer);
+    FLD_STAT(parser->stats.comment_bytes += lexer->comment_bytes - comments);
+    FLD_STAT(parser->stats.whitespace_bytes += (size_t)(lexer->current - before) - (lexer->comment_bytes - comments));
+
+    // Store the start of the token
+    lexer->start = lexer->current;
+    int line = lexer->line;
+    int column = _lexer_column(lexer, lexer->start);
+
+    if (_lexer_is_at_end(lexer)) {
+        return _token_create(parser, TOKEN_EOF, line, column);
+    }
+
+    char c = _lexer_advance(lexer);
+
+    // Handle string literals
+    if (c == '"') return _lexer_handle_string(parser, lexer);
+
+    // Handle numbers
+    if (_is_digit(c) || (c == '-' && _is_digit(_lexer_peek(lexer)))) {
+        // Back up so number() sees the first digit
+        lexer->current--;
+        bool is_negative = (*lexer->current == '-');
+        return _lexer_handle_number(parser, lexer, is_negative);
+    }
+
+    // Handle key and keywords
+    if (_is_alpha(c)) {
+        // Back up so the keywords() sees the first character
+        lexer->current--;
+        return _lexer_handle_keyword(parser, lexer);
+    }
+
+    // Handle single character tokens
+    switch (c) {
+        case '=': return _token_create(parser, TOKEN_EQUALS, line, column);
+        case '{': return _token_create(parser, TOKEN_BRACE_LEFT, line, column);
+        case '}': return _token_create(parser, TOKEN_BRACE_RIGHT, line, column);
+        case '[': return _token_create(parser, TOKEN_BRACKET_LEFT, line, column);
+        case ']': return _token_create(parser, TOKEN_BRACKET_RIGHT, line, column);
+        case '(': return _token_create(parser, TOKEN_PAREN_LEFT, line, column);
+        case ')': return _token_create(parser, TOKEN_PAREN_RIGHT, line, column);
+        case ';': return _token_create(parser, TOKEN_SEMICOLON, line, column);
+        case ',': return _token_create(parser, TOKEN_COMMA, line, column);
+    }
+
+    // If we get here, error
+    return _token_create(parser, TOKEN_ERROR, line, column);
+}
+
+static void _parser_error(fld_parser *parser, fld_error_code error_code) {
+    // Avoid cascading errors
+    if (parser->last_error.code != FLD_ERROR_NONE) return;
+
+    parser->last_error.code = error_code;
+    parser->last_error.line = parser->current->line;
+    parser->last_error.column = parser->current->column;
+}
+
+static void _parser_advance(fld_parser *parser) {
+    // Save the current token for error reporting
+    parser->previous = parser->current;
+
+    // Keep getting tokens until we get a non-error one or reach EOF
+    while (true) {
+        parser->current = _lexer_scan_token(parser);
+        if (parser->current->type != TOKEN_ERROR) break;
+
+        // Handle error token by reporting it
+        _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+    }
+}
+
+static void _parser_consume(fld_parser *parser, fld_token_type type, fld_error_code error_code) {
+    // Like match, but raises an error if the token isn't what we expect
+    if (parser->current->type == type) {
+        _parser_advance(parser);
+        return;
+    }
+
+    _parser_error(parser, error_code);
+}
+
+static bool _parser_match(fld_parser *parser, fld_token_type type) {
+    // Check if current token matches expected type
+    if (parser->current->type != type) return false;
+    _parser_advance(parser);
+    return true;
+}
+
+static bool _parser_expect(fld_parser *parser, fld_token_type type, fld_error_code error_code) {
+    if (!_parser_match(parser, type)) {
+        _parser_error(parser, error_code);
+        return false;
+    }
+
+    return true;
+}
+
+#define FLD_INDEX_NO_SLOT 0xFFFFFFFFu
+
+static uint32_t _index_find_slot(const fld_index *index, const char *key, int length, uint32_t hash) {
+    uint32_t mask = index->capacity - 1;
+    for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+        fld_object *field = index->fields[i];
+        if (!field) return FLD_INDEX_NO_SLOT;
+
+        if (index->hashes[i] == hash &&
+            field->key.length == length &&
+            memcmp(field->key.start, key, length) == 0) {
+            return i;
+        }
+    }
+}
+
+static fld_object *_index_find(const fld_index *index, const char *key, int length, uint32_t hash) {
+    uint32_t slot = _index_find_slot(index, key, length, hash);
+    return slot == FLD_INDEX_NO_SLOT ? NULL : index->fields[slot];
+}
+
+// Sets up an empty index of `capacity` slots in `memory`
+static fld_index *_index_place(void *memory, uint32_t capacity) {
+    fld_index *index = (fld_index*)memory;
+    index->capacity = capacity;
+    index->count = 0;
+    index->fields = (fld_object**)(index + 1);
+    index->hashes = (uint32_t*)(index->fields + capacity);
+    index->last = NULL;
+    memset(index->fields, 0, capacity * sizeof(fld_object*));
+    return index;
+}
+
+// Allocates an empty index with room for `count` fields
+static fld_index *_index_alloc(fld_parser *parser, uint32_t count) {
+    uint32_t capacity = _index_capacity(count);
+    void *memory = _bump_alloc(&parser->allocator, _index_size(capacity), ALIGNOF(fld_index));
+    if (!memory) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    FLD_STAT(parser->stats.index_bytes += _index_size(capacity));
+    return _index_place(memory, capacity);
+}
+
+// Adds a field whose key isn't in the index yet
+static void _index_insert(fld_index *index, fld_object *field, uint32_t hash) {
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = hash & mask;
+    while (index->fields[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    index->fields[slot] = field;
+    index->hashes[slot] = hash;
+    index->count++;
+}
+
+static void _index_fill(fld_index *index, fld_object *first) {
+    for (fld_object *field = first; field; field = field->next) {
+        uint32_t hash = fld_hash_key(field->key.start, field->key.length);
+        index->last = field;
+
+        // Duplicate keys keep resolving to the first one, like a linear scan would
+        if (_index_find(index, field->key.start, field->key.length, hash)) continue;
+        _index_insert(index, field, hash);
+    }
+}
+
+// Builds the lookup index for a list of fields and hangs it off the first one.
+static bool _index_build(fld_parser *parser, fld_object *first, uint32_t count) {
+    if (!_index_wanted(count)) {
+        return true;
+    }
+
+    FLD_STAT(uint64_t started = _stats_now());
+    fld_index *index = _index_alloc(parser, count);
+    if (!index) return false;
+
+    _index_fill(index, first);
+    first->index = index;
+    FLD_STAT(parser->stats.index_ns += _stats_now() - started);
+    return true;
+}
+
+static fld_object *_parse_object_fields(fld_parser *parser, fld_object *parent) {
+    // Skip the opening brace
+    _parser_advance(parser);
+
+    // Handle empty object
+    if (_parser_match(parser, TOKEN_BRACE_RIGHT)) {
+        // Empty object has no fields
+        return NULL;
+    }
+
+    fld_object *first_field = NULL;
+    fld_object *last_field = NULL;
+    uint32_t count = 0;
+
+    // Parse fields until we hit the closing brace
+    while (true) {
+        // Expect a key token
+        if (parser->current->type != TOKEN_KEY) {
+            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+            return NULL;
+        }
+
+        // Parse a field
+        fld_object *field = _parse_field(parser, parent);
+        if (!field) {
+            return NULL;
+        }
+
+        // Add to the linked list
+        if (!first_field) {
+            first_field = field;
+        } else {
+            last_field->next = field;
+        }
+        last_field = field;
+        count++;
+
+        // If we see a closing brace, we're done
+        if (parser->current->type == TOKEN_BRACE_RIGHT) {
+            break;
+        }
+    }
+
+    // Consume the closing brace
+    if (!_parser_expect(parser, TOKEN_BRACE_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) {
+        return NULL;
+    }
+
+    last_field->next = NULL;
+
+    if (!_index_build(parser, first_field, count)) {
+        return NULL;
+    }
+
+    return first_field;
+}
+
+static bool _parse_object(fld_parser *parser, fld_object *parent, fld_value *out_value) {
+    out_value->type = FLD_VALUE_OBJECT;
+
+    // Parse the object's fields
+    out_value->as.object = _parse_object_fields(parser, parent);
+    return parser->last_error.code == FLD_ERROR_NONE;
+}
+
+// Where the body of a lazy object is, kept in the arena until it is parsed
+typedef struct fld_lazy_body {
+    fld_parser *parser;
+    fld_object *field;      // The field holding the object
+    char *start;            // The opening brace
+    char *end;              // Right after the closing brace
+    char *line_start;
+    int line;
+} fld_lazy_body;
+
+static bool _parse_lazy_object(fld_parser *parser, fld_object *parent, fld_value *out_value) {
+    fld_lexer *lexer = &parser->lexer;
+    const char *close = _scan_object_end(lexer->current, lexer->end);
+    if (!close) {
+        // Never closed, the eager parse reports where it goes wrong
+        return _parse_object(parser, parent, out_value);
+    }
+
+    fld_lazy_body *body = (fld_lazy_body*)_bump_alloc(&parser->allocator, sizeof(fld_lazy_body), ALIGNOF(fld_lazy_body));
+    if (!body) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    FLD_STAT(parser->stats.lazy_bytes += sizeof(fld_lazy_body));
+
+    // The opening brace is the current token, the lexer is right after it
+    body->parser = parser;
+    body->field = parent;
+    body->start = lexer->start;
+    body->end = (char*)close;
+    body->line_start = lexer->line_start;
+    body->line = lexer->line;
+
+    out_value->type = FLD_VALUE_OBJECT;
+    out_value->as.lazy.object = NULL;
+    out_value->as.lazy.body = body;
+
+    _lexer_skip_to(lexer, (char*)close);
+    _parser_advance(parser);
+    return true;
+}
+
+// Parses a lazy object's body with its parser, whatever that is doing
+static void _lazy_expand(fld_value *value) {
+    fld_lazy_body *body = value->as.lazy.body;
+    fld_parser *parser = body->parser;
+
+    fld_lexer lexer = parser->lexer;
+    fld_token tokens[FLD_TOKEN_SLOTS];
+    memcpy(tokens, parser->tokens, sizeof(tokens));
+    fld_token *current = parser->current;
+    fld_token *previous = parser->previous;
+    fld_error error = parser->last_error;
+
+    parser->lexer.start = body->start;
+    parser->lexer.current = body->start;
+    parser->lexer.end = body->end;
+    parser->lexer.line_start = body->line_start;
+    parser->lexer.line = body->line;
+    parser->last_error.code = FLD_ERROR_NONE;
+    parser->current = _lexer_scan_token(parser);
+
+    // Only ever tried once, a body that doesn't parse reads as empty
+    fld_object *first = _parse_object_fields(parser, body->field);
+    value->as.lazy.body = NULL;
+    if (parser->last_error.code == FLD_ERROR_NONE) {
+        value->as.object = first;
+        parser->last_error = error;
+    } else {
+        value->as.object = NULL;
+    }
+
+    parser->lexer = lexer;
+    memcpy(parser->tokens, tokens, sizeof(tokens));
+    parser->current = current;
+    parser->previous = previous;
+}
+
+// First field of an object value, parsing a lazy body first
+static inline fld_object *_value_object(const fld_value *value) {
+    if (value->as.lazy.body) {
+        _lazy_expand((fld_value*)value);
+    }
+    return value->as.object;
+}
+
+static size_t _get_type_size(fld_value_type type) {
+    switch (type) {
+        case FLD_VALUE_STRING: return sizeof(fld_string_view);
+        case FLD_VALUE_INT: return sizeof(int);
+        case FLD_VALUE_INT64: return sizeof(int64_t);
+        case FLD_VALUE_FLOAT: return sizeof(float);
+        case FLD_VALUE_BOOL: return sizeof(bool);
+        default: return sizeof(fld_value);
+    }
+}
+
+static size_t _get_type_alignment(fld_value_type type) {
+    switch (type) {
+        case FLD_VALUE_STRING: return ALIGNOF(fld_string_view);
+        case FLD_VALUE_INT: return ALIGNOF(int);
+        case FLD_VALUE_INT64: return ALIGNOF(int64_t);
+        case FLD_VALUE_FLOAT: return ALIGNOF(float);
+        case FLD_VALUE_BOOL: return ALIGNOF(bool);
+        default: return ALIGNOF(fld_value);
+    }
+}
+
+static bool _store_array_item(fld_parser *parser, void *slot, const fld_value *value) {
+    switch (value->type) {
+        case FLD_VALUE_STRING:
+            *((fld_string_view*)slot) = value->as.string;
+            return true;
+        case FLD_VALUE_INT:
+            *((int*)slot) = value->as.integer;
+            return true;
+        case FLD_VALUE_INT64:
+            *((int64_t*)slot) = value->as.int64;
+            return true;
+        case FLD_VALUE_FLOAT:
+            *((float*)slot) = value->as.float_val;
+            return true;
+        case FLD_VALUE_BOOL:
+            *((bool*)slot) = value->as.boolean;
+            return true;
+        default:
+            _parser_error(parser, FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE);
+            return false;
+    }
+}
+
+// Points a string value with escapes at its decoded text in the arena. The
+// lexer checked the escapes already.
+static bool _string_decode(fld_parser *parser, fld_string_view *string) {
+    size_t length = 0;
+    _string_unescape(string->start, (size_t)string->length, NULL, &length);
+
+    char *decoded = (char*)_bump_alloc(&parser->allocator, length, 1);
+    if (!decoded && length > 0) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    _string_unescape(string->start, (size_t)string->length, decoded, NULL);
+    FLD_STAT(parser->stats.string_bytes += length);
+
+    string->start = decoded;
+    string->length = (int)length;
+    return true;
+}
+
+// Whether the value _parse_value just read is a string still to be decoded,
+// its token is the previous one by then
+static inline bool _value_is_escaped(const fld_parser *parser, const fld_value *value) {
+    return value->type == FLD_VALUE_STRING && parser->previous->escaped;
+}
+
+static inline bool _fits_int(int64_t value) {
+    return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+static inline bool _array_is_full(size_t count) {
+#if FLD_MAX_ARRAY_ITEMS > 0
+    return count >= (size_t)FLD_MAX_ARRAY_ITEMS;
+#else
+    (void)count;
+    return false;
+#endif
+}
+
+// Appends a slot to the array run starting at `*items`. When the block is
+// full the run moves to a fresh chunk (at least twice its size, so moves stay
+// rare) to keep the items contiguous.
+static void *_array_push(fld_parser *parser, uint8_t **items, size_t item_size, size_t item_align) {
+    FLD_STAT(uint8_t *run = *items);
+    void *slot = _bump_extend(&parser->allocator, items, item_size, item_align);
+    if (!slot) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    // Only a run that held items already was actually moved
+    FLD_STAT(parser->stats.array_moves += *items != run && (uint8_t*)slot != *items);
+    FLD_STAT(parser->stats.array_items++);
+    FLD_STAT(parser->stats.item_bytes += item_size);
+    return slot;
+}
+
+// Bulk path for numeric arrays. Consumes `n, n, n` for as long as the tokens
+// are numbers of the array's type, storing them without going through the
+// general value dispatch. `out_more` is set when the run stopped right after
+// a comma, meaning the general path has to deal with the next item.
+static bool _parse_number_run(fld_parser *parser, fld_value_type type, uint8_t **items, size_t *count, bool *out_more) {
+    fld_token_type number = (type == FLD_VALUE_FLOAT) ? TOKEN_FLOAT : TOKEN_INT;
+    *out_more = true;
+
+    while (parser->current->type == number) {
+        // A 64-bit item in an int array needs the general path to widen it
+        if (type == FLD_VALUE_INT && !_fits_int(parser->current->value.integer)) break;
+
+        if (_array_is_full(*count)) {
+            _parser_error(parser, FLD_ERROR_ARRAY_TOO_MANY_ITEMS);
+            return false;
+        }
+
+        void *slot = _array_push(parser, items, _get_type_size(type), _get_type_alignment(type));
+        if (!slot) return false;
+
+        if (type == FLD_VALUE_INT) {
+            *((int*)slot) = (int)parser->current->value.integer;
+        } else if (type == FLD_VALUE_INT64) {
+            *((int64_t*)slot) = parser->current->value.integer;
+        } else {
+            *((float*)slot) = parser->current->value.float_val;
+        }
+        (*count)++;
+
+        _parser_advance(parser);
+        if (!_parser_match(parser, TOKEN_COMMA)) {
+            *out_more = false;
+            break;
+        }
+    }
+
+    return true;
+}
+
+// Turns the int items of an array into int64 ones once an item that needs
+// 64 bits shows up. The wide copy goes on top of the arena so the run can
+// keep growing, the narrow one is left behind.
+static bool _array_widen(fld_parser *parser, uint8_t **items, size_t count) {
+    int64_t *wide = (int64_t*)_bump_alloc(&parser->allocator, count * sizeof(int64_t), ALIGNOF(int64_t));
+    if (!wide) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+
+    const int *narrow = (const int*)*items;
+    for (size_t i = 0; i < count; ++i) {
+        wide[i] = narrow[i];
+    }
+    FLD_STAT(parser->stats.array_widenings++);
+    FLD_STAT(parser->stats.item_bytes += count * sizeof(int64_t));
+
+    *items = (uint8_t*)wide;
+    return true;
+}
+
+static bool _parse_array(fld_parser *parser, fld_object *parent, fld_value *out_value) {
+    fld_value *array = out_value;
+    array->type = FLD_VALUE_ARRAY;
+    array->as.array.type = FLD_VALUE_EMPTY;
+    array->as.array.count = 0;
+    array->as.array.items = NULL;
+
+    _parser_advance(parser);  // Skip '['
+
+    // Handle empty array fast path
+    if (_parser_match(parser, TOKEN_BRACKET_RIGHT)) {
+        return true;
+    }
+
+    // Parse first value to get type
+    fld_value item;
+    if (!_parse_value(parser, parent, &item)) return false;
+    bool escaped = _value_is_escaped(parser, &item);
+
+    // Validate array element type - no nested arrays or objects allowed
+    if (item.type == FLD_VALUE_ARRAY || item.type == FLD_VALUE_OBJECT) {
+        _parser_error(parser, FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE);
+        return false;
+    }
+
+    size_t item_size = _get_type_size(item.type);
+    size_t item_align = _get_type_alignment(item.type);
+
+    // Items are appended to a run at the top of the arena as they are parsed.
+    // Array elements never allocate anything themselves, so the run stays
+    // contiguous until the closing bracket and no second pass is needed.
+    // A run that outgrows its block is moved whole by _array_push.
+    uint8_t *items = (uint8_t*)_bump_alloc(&parser->allocator, 0, item_align);
+    if (!items) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+
+    array->as.array.type = item.type;
+    FLD_STAT(parser->stats.arrays++);
+    bool is_numeric = item.type == FLD_VALUE_INT || item.type == FLD_VALUE_INT64 || item.type == FLD_VALUE_FLOAT;
+    size_t count = 0;
+
+    while (true) {
+        if (item.type != array->as.array.type) {
+            // Ints and int64s mix, the array takes the wider type
+            if (item.type == FLD_VALUE_INT && array->as.array.type == FLD_VALUE_INT64) {
+                item.type = FLD_VALUE_INT64;
+                item.as.int64 = item.as.integer;
+            } else if (item.type == FLD_VALUE_INT64 && array->as.array.type == FLD_VALUE_INT) {
+                if (!_array_widen(parser, &items, count)) return false;
+                array->as.array.type = FLD_VALUE_INT64;
+                item_size = sizeof(int64_t);
+                item_align = ALIGNOF(int64_t);
+            } else {
+                _parser_error(parser, FLD_ERROR_ARRAY_TYPE_MISMATCH);
+                return false;
+            }
+        }
+
+        if (_array_is_full(count)) {
+            _parser_error(parser, FLD_ERROR_ARRAY_TOO_MANY_ITEMS);
+            return false;
+        }
+
+        void *slot = _array_push(parser, &items, item_size, item_align);
+        if (!slot) return false;
+
+        if (!_store_array_item(parser, slot, &item)) return false;
+        count++;
+
+        // Anything but a comma ends the array
+        if (!_parser_match(parser, TOKEN_COMMA)) break;
+
+        if (is_numeric) {
+            bool more;
+            if (!_parse_number_run(parser, array->as.array.type, &items, &count, &more)) return false;
+            if (!more) break;
+        }
+
+        if (!_parse_value(parser, parent, &item)) return false;
+        escaped |= _value_is_escaped(parser, &item);
+    }
+
+    // Consume final bracket
+    if (!_parser_expect(parser, TOKEN_BRACKET_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) {
+        return false;
+    }
+
+    array->as.array.count = count;
+    array->as.array.items = items;
+
+    // Decoding allocates, which has to wait until the run is complete.
+    // Only strings with escapes have a backslash in them.
+    if (escaped) {
+        fld_string_view *strings = (fld_string_view*)items;
+        for (size_t i = 0; i < count; ++i) {
+            if (memchr(strings[i].start, '\\', (size_t)strings[i].length) &&
+                !_string_decode(parser, &strings[i])) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool _parse_vec(fld_parser *parser, fld_object *parent, fld_value *out_value) {
+    // Get vector size from keyword token
+    int vec_size = (int)parser->current->value.integer;
+
+    // Consume vec token
+    _parser_advance(parser);
+
+    // We expect opening parenthesis here
+    if(!_parser_expect(parser, TOKEN_PAREN_LEFT, FLD_ERROR_UNEXPECTED_TOKEN)) {
+        return false;
+    }
+
+    // Set appropriate vector type based on size
+    fld_value *value = out_value;
+    value->type = (fld_value_type)(FLD_VALUE_VEC2 + vec_size - 2);
+
+    // Parse the components (they can only be float!)
+    // Here, we are casting to the first vec size in the union
+    // so we can get all the others from this address
+    float *components = (float*)&value->as.vec2;
+    for (int i = 0; i < vec_size; ++i) {
+        // Check for comma between components (except first)
+        if (i > 0 && !_parser_expect(parser, TOKEN_COMMA, FLD_ERROR_UNEXPECTED_TOKEN)) {
+            return false;
+        }
+
+        // Each component must be a number (int or float)
+        if (parser->current->type != TOKEN_INT && parser->current->type != TOKEN_FLOAT) {
+            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+            return false;
+        }
+
+        // Store the component value (convert to float from int if needed)
+        components[i] = (parser->current->type == TOKEN_INT)
+            ? (float)parser->current->value.integer
+            : (float)parser->current->value.float_val;
+
+        _parser_advance(parser);
+    }
+
+    // Expect closing parenthesis
+    return _parser_expect(parser, TOKEN_PAREN_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN);
+}
+
+static bool _parse_value(fld_parser *parser, fld_object *parent, fld_value *out_value) {
+    // Init the structure to zero for safety
+    memset(out_value, 0, sizeof(fld_value));
+
+    // For objects and arrays we'll just use their appropriate parse functions
+    if (parser->current->type == TOKEN_BRACE_LEFT) {
+        if (parser->flags & FLD_PARSE_LAZY_OBJECTS) {
+            return _parse_lazy_object(parser, parent, out_value);
+        }
+        return _parse_object(parser, parent, out_value);
+    }
+    if (parser->current->type == TOKEN_BRACKET_LEFT) {
+        return _parse_array(parser, parent, out_value);
+    }
+
+    // Primitive types are written straight into the destination,
+    // nothing gets allocated for them
+    fld_value *value = out_value;
+
+    switch (parser->current->type) {
+        case TOKEN_STRING: {
+            // Validate string view
+            if (parser->current->value.string.length > 0 &&
+                parser->current->value.string.start != NULL) {
+                value->type = FLD_VALUE_STRING;
+                value->as.string = parser->current->value.string;
+                _parser_advance(parser);
+                return true;
+            }
+            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+            return false;
+        }
+
+        case TOKEN_INT: {
+            int64_t integer = parser->current->value.integer;
+            if (_fits_int(integer)) {
+                value->type = FLD_VALUE_INT;
+                value->as.integer = (int)integer;
+            } else {
+                value->type = FLD_VALUE_INT64;
+                value->as.int64 = integer;
+            }
+            _parser_advance(parser);
+            return true;
+        }
+
+        case TOKEN_FLOAT: {
+            value->type = FLD_VALUE_FLOAT;
+            value->as.float_val = parser->current->value.float_val;
+            _parser_advance(parser);
+            return true;
+        }
+
+        case TOKEN_BOOL: {
+            value->type = FLD_VALUE_BOOL;
+            value->as.boolean = parser->current->value.boolean;
+            _parser_advance(parser);
+            return true;
+        }
+
+        case TOKEN_VEC: {
+            return _parse_vec(parser, parent, out_value);
+        }
+
+        default: {
+            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+            return false;
+        }
+    }
+
+    // Should never reach here
+    return false;
+}
+
+static fld_object *_parse_field(fld_parser *parser, fld_object *parent) {
+    // Allocate new object
+    fld_object *obj = (fld_object*)_bump_alloc(&parser->allocator, sizeof(fld_object), ALIGNOF(fld_object));
+    if (!obj) {
+        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+        return NULL;
+    }
+#ifdef FLD_ENABLE_STATS
+    parser->stats.object_bytes += sizeof(fld_object);
+    int depth = 1;
+    for (const fld_object *up = parent; up; up = up->parent) depth++;
+    if (depth > parser->stats.max_depth) parser->stats.max_depth = depth;
+#endif
+
+    memset(obj, 0, sizeof(fld_object));
+
+    // Null initialize links
+    obj->next = NULL;
+    obj->parent = parent;
+
+    // Store the key
+    obj->key = parser->current->value.string;
+
+    // Consume key
+    _parser_advance(parser);
+    
+    // Expect the equals sign
+    _parser_consume(parser, TOKEN_EQUALS, FLD_ERROR_UNEXPECTED_TOKEN);
+    if (parser->last_error.code != FLD_ERROR_NONE) {
+        return NULL;
+    }
+
+    // Now parse the value straight into the object
+    if (!_parse_value(parser, obj, &obj->value)) {
+        // TODO: error?
+        return NULL;
+    }
+    if (_value_is_escaped(parser, &obj->value) && !_string_decode(parser, &obj->value.as.string)) {
+        return NULL;
+    }
+
+    // Top-level fields remember a hash of their text, key to semicolon,
+    // so fld_reparse can tell whether they changed. `lexer.start` is
+    // where the current token (the semicolon) starts.
+    if (!parent && parser->current->type == TOKEN_SEMICOLON) {
+        const char *end = parser->lexer.start + 1;
+        obj->value.content_hash = _content_hash(obj->key.start, (size_t)(end - obj->key.start));
+    }
+
+    // Expect the semicolon
+    _parser_consume(parser, TOKEN_SEMICOLON, FLD_ERROR_UNEXPECTED_TOKEN);
+    if (parser->last_error.code != FLD_ERROR_NONE) {
+        return NULL;
+    }
+
+    return obj;
+}
+
+// Measuring mirrors the parse functions above: same grammar and same
+// allocations in the same order, but only the arena offset is tracked.
+static inline void _measure_alloc(fld_measurement *m, size_t size, size_t align) {
+    m->bytes = (size_t)_align_up((uintptr_t)m->bytes, align) + size;
+}
+
+static bool _measure_value(fld_parser *parser, fld_measurement *m, fld_value_type *out_type);
+
+// Room for the decoded text of the string just measured, if it has escapes
+static size_t _measure_string_length(const fld_parser *parser, fld_value_type type) {
+    const fld_token *token = parser->previous;
+    if (type != FLD_VALUE_STRING || !token->escaped) return 0;
+
+    size_t length = 0;
+    _string_unescape(token->value.string.start, (size_t)token->value.string.length, NULL, &length);
+    return length;
+}
+
+static inline void _measure_string(const fld_parser *parser, fld_measurement *m, fld_value_type type) {
+    _measure_alloc(m, _measure_string_length(parser, type), 1);
+}
+
+static void _measure_index(fld_measurement *m, uint32_t count) {
+    if (!_index_wanted(count)) return;
+
+    _measure_alloc(m, _index_size(_index_capacity(count)), ALIGNOF(fld_index));
+    m->indexes++;
+}
+
+static bool _measure_field(fld_parser *parser, fld_measurement *m) {
+    if (parser->current->type != TOKEN_KEY) {
+        _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+        return false;
+    }
+
+    _measure_alloc(m, sizeof(fld_object), ALIGNOF(fld_object));
+    m->fields++;
+
+    _parser_advance(parser);
+    if (!_parser_expect(parser, TOKEN_EQUALS, FLD_ERROR_UNEXPECTED_TOKEN)) return false;
+
+    fld_value_type type;
+    if (!_measure_value(parser, m, &type)) return false;
+    _measure_string(parser, m, type);
+
+    return _parser_expect(parser, TOKEN_SEMICOLON, FLD_ERROR_UNEXPECTED_TOKEN);
+}
+
+static bool _measure_object(fld_parser *parser, fld_measurement *m) {
+    m->objects++;
+
+    // Skip the opening brace
+    _parser_advance(parser);
+    if (_parser_match(parser, TOKEN_BRACE_RIGHT)) return true;
+
+    uint32_t count = 0;
+    while (true) {
+        if (!_measure_field(parser, m)) return false;
+        count++;
+
+        if (parser->current->type == TOKEN_BRACE_RIGHT) break;
+    }
+
+    if (!_parser_expect(parser, TOKEN_BRACE_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) return false;
+
+    _measure_index(m, count);
+    return true;
+}
+
+static bool _measure_array(fld_parser *parser, fld_measurement *m) {
+    m->arrays++;
+
+    _parser_advance(parser);  // Skip '['
+    if (_parser_match(parser, TOKEN_BRACKET_RIGHT)) return true;
+
+    fld_value_type array_type;
+    if (!_measure_value(parser, m, &array_type)) return false;
+    // Decoded strings go after the items
+    size_t strings = _measure_string_length(parser, array_type);
+
+    if (array_type == FLD_VALUE_ARRAY || array_type == FLD_VALUE_OBJECT) {
+        _parser_error(parser, FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE);
+        return false;
+    }
+
+    // The run starts at the aligned arena top and grows by one item at a time
+    _measure_alloc(m, 0, _get_type_alignment(array_type));
+    size_t item_size = _get_type_size(array_type);
+    size_t count = 0;
+
+    while (true) {
+        if (_array_is_full(count)) {
+            _parser_error(parser, FLD_ERROR_ARRAY_TOO_MANY_ITEMS);
+            return false;
+        }
+
+        m->bytes += item_size;
+        count++;
+
+        if (!_parser_match(parser, TOKEN_COMMA)) break;
+
+        fld_value_type type;
+        if (!_measure_value(parser, m, &type)) return false;
+        strings += _measure_string_length(parser, type);
+
+        if (type != array_type) {
+            if (type == FLD_VALUE_INT64 && array_type == FLD_VALUE_INT) {
+                // Widened into a fresh run, see _array_widen
+                _measure_alloc(m, count * sizeof(int64_t), ALIGNOF(int64_t));
+                array_type = FLD_VALUE_INT64;
+                item_size = sizeof(int64_t);
+            } else if (!(type == FLD_VALUE_INT && array_type == FLD_VALUE_INT64)) {
+                _parser_error(parser, FLD_ERROR_ARRAY_TYPE_MISMATCH);
+                return false;
+            }
+        }
+    }
+
+    if (!_parser_expect(parser, TOKEN_BRACKET_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) return false;
+
+    m->bytes += strings;
+    m->items[array_type] += count;
+    return true;
+}
+
+static bool _measure_value(fld_parser *parser, fld_measurement *m, fld_value_type *out_type) {
+    if (parser->current->type == TOKEN_BRACE_LEFT) {
+        *out_type = FLD_VALUE_OBJECT;
+        return _measure_object(parser, m);
+    }
+    if (parser->current->type == TOKEN_BRACKET_LEFT) {
+        *out_type = FLD_VALUE_ARRAY;
+        return _measure_array(parser, m);
+    }
+
+    // Everything else is a primitive, parsing those never allocates
+    fld_value value;
+    if (!_parse_value(parser, NULL, &value)) return false;
+
+    *out_type = value.type;
+    return true;
+}
+
+static void _parser_begin(fld_parser *parser) {
+    FLD_STAT(memset(&parser->stats, 0, sizeof(parser->stats)));
+    parser->generation++;
+    parser->root = NULL;
+    parser->free_fields = NULL;
+    parser->last_error.code = FLD_ERROR_NONE;
+    parser->last_error.line = 1;
+    parser->last_error.column = 1;
+}
+
+// Sets up a parser that only ever lexes, the caller's memory is read in place
+static void _parser_begin_lexing(fld_parser *parser, const char *source, size_t length) {
+    memset(parser, 0, sizeof(fld_parser));
+    _parser_begin(parser);
+
+    parser->source = (char*)source;
+    parser->source_length = length;
+    parser->lexer.start = parser->source;
+    parser->lexer.current = parser->source;
+    parser->lexer.end = parser->source + length;
+    parser->lexer.line_start = parser->source;
+    parser->lexer.line = 1;
+
+    parser->current = _lexer_scan_token(parser);
+}
+
+// Event parsing walks the same grammar once more, calling the handler where
+// the parse functions would build something. A callback stopping the parse
+// returns false up the chain just like an error, only without an error set.
+static bool _events_value(fld_parser *parser, const fld_event_handler *handler);
+
+// Strings with escapes are decoded into the parser's scratch arena, which
+// only has to hold one at a time
+static bool _events_decode(fld_parser *parser, fld_value *value) {
+    if (!_value_is_escaped(parser, value)) return true;
+
+    parser->allocator.current = parser->allocator.start;
+    if (!_string_decode(parser, &value->as.string)) {
+        // Only a string too long for the buffer runs out without chunks
+        if (!parser->allocator.backing.alloc) {
+            parser->last_error.code = FLD_ERROR_STRING_TOO_LONG;
+        }
+        return false;
+    }
+    return true;
+}
+
+static bool _events_field(fld_parser *parser, const fld_event_handler *handler) {
+    if (parser->current->type != TOKEN_KEY) {
+        _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+        return false;
+    }
+
+    if (handler->on_key && !handler->on_key(handler->user, parser->current->value.string)) return false;
+
+    _parser_advance(parser);
+    if (!_parser_expect(parser, TOKEN_EQUALS, FLD_ERROR_UNEXPECTED_TOKEN)) return false;
+    if (!_events_value(parser, handler)) return false;
+
+    return _parser_expect(parser, TOKEN_SEMICOLON, FLD_ERROR_UNEXPECTED_TOKEN);
+}
+
+static bool _events_object(fld_parser *parser, const fld_event_handler *handler) {
+    // Skip the opening brace
+    _parser_advance(parser);
+    if (handler->on_object_begin && !handler->on_object_begin(handler->user)) return false;
+
+    if (!_parser_match(parser, TOKEN_BRACE_RIGHT)) {
+        while (true) {
+            if (!_events_field(parser, handler)) return false;
+            if (parser->current->type == TOKEN_BRACE_RIGHT) break;
+        }
+
+        if (!_parser_expect(parser, TOKEN_BRACE_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) return false;
+    }
+
+    return !handler->on_object_end || handler->on_object_end(handler->user);
+}
+
+static bool _events_array(fld_parser *parser, const fld_event_handler *handler) {
+    _parser_advance(parser);  // Skip '['
+    if (handler->on_array_begin && !handler->on_array_begin(handler->user)) return false;
+
+    if (!_parser_match(parser, TOKEN_BRACKET_RIGHT)) {
+        fld_value_type array_type = FLD_VALUE_EMPTY;
+        size_t count = 0;
+
+        do {
+            if (_array_is_full(count)) {
+                _parser_error(parser, FLD_ERROR_ARRAY_TOO_MANY_ITEMS);
+                return false;
+            }
+
+            // Items can't nest, which also keeps them from allocating
+            if (parser->current->type == TOKEN_BRACE_LEFT || parser->current->type == TOKEN_BRACKET_LEFT) {
+                _parser_error(parser, count == 0 ? FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE : FLD_ERROR_ARRAY_TYPE_MISMATCH);
+                return false;
+            }
+
+            fld_value item;
+            if (!_parse_value(parser, NULL, &item)) return false;
+            if (!_events_decode(parser, &item)) return false;
+
+            // Same rules as _parse_array, ints and int64s mix
+            if (count == 0) {
+                array_type = item.type;
+            } else if (item.type != array_type) {
+                bool integers = (item.type == FLD_VALUE_INT || item.type == FLD_VALUE_INT64) &&
+                    (array_type == FLD_VALUE_INT || array_type == FLD_VALUE_INT64);
+                if (!integers) {
+                    _parser_error(parser, FLD_ERROR_ARRAY_TYPE_MISMATCH);
+                    return false;
+                }
+                array_type = FLD_VALUE_INT64;
+            }
+            count++;
+
+            if (handler->on_value && !handler->on_value(handler->user, &item)) return false;
+        } while (_parser_match(parser, TOKEN_COMMA));
+
+        if (!_parser_expect(parser, TOKEN_BRACKET_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) return false;
+    }
+
+    return !handler->on_array_end || handler->on_array_end(handler->user);
+}
+
+static bool _events_value(fld_parser *parser, const fld_event_handler *handler) {
+    if (parser->current->type == TOKEN_BRACE_LEFT) {
+        return _events_object(parser, handler);
+    }
+    if (parser->current->type == TOKEN_BRACKET_LEFT) {
+        return _events_array(parser, handler);
+    }
+
+    fld_value value;
+    if (!_parse_value(parser, NULL, &value)) return false;
+    if (!_events_decode(parser, &value)) return false;
+
+    return !handler->on_value || handler->on_value(handler->user, &value);
+}
+
+static bool _parse_document(fld_parser *parser, const char *source, size_t length, void *memory, size_t size, uint32_t flags);
+static bool _parse_source(fld_parser *parser, const char *source, size_t length, uint32_t flags);
+static bool _parse_fields(fld_parser *parser, fld_object *parent, fld_object **first, fld_object **last, uint32_t *count);
+
+bool fld_parse(fld_parser *parser, const char *source, void *memory, size_t size) {
+    return fld_parse_ex(parser, source, strlen(source), memory, size, FLD_PARSE_DEFAULT);
+}
+
+bool fld_parse_ex(fld_parser *parser, const char *source, size_t length, void *memory, size_t size, uint32_t flags) {
+    // Set up parser
+    // Running out of memory is reported by the allocations themselves,
+    // use fld_measure to know the exact size up front
+    _parser_begin(parser);
+
+    return _parse_document(parser, source, length, memory, size, flags);
+}
+
+// Parses a whole document, expects the parser to be set up by _parser_begin
+static bool _parse_document(fld_parser *parser, const char *source, size_t length, void *memory, size_t size, uint32_t flags) {
+    // Init bump allocator, the previous tree goes away with its chunks
+    _bump_release(&parser->allocator);
+    _bump_init(&parser->allocator, memory, size);
+
+    return _parse_source(parser, source, length, flags);
+}
+
+// Parses into whatever arena the parser has set up
+static bool _parse_source(fld_parser *parser, const char *source, size_t length, uint32_t flags) {
+    parser->flags = flags;
+    FLD_STAT(uint64_t started = _stats_now());
+    if (flags & FLD_PARSE_BORROW_SOURCE) {
+        // Lex the caller's memory directly, it has to outlive the tree
+        parser->source = (char*)source;
+    } else {
+        // Copy source text so it does not get invalidated
+        parser->source = (char*)_bump_alloc(&parser->allocator, length + 1, ALIGNOF(char));
+        if (!parser->source) {
+            parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+            return false;
+        }
+
+        memcpy(parser->source, source, length);
+        // Null terminate it
+        parser->source[length] = '\0';
+        FLD_STAT(parser->stats.source_bytes = length + 1);
+    }
+    parser->source_length = length;
+    FLD_STAT(uint64_t copied = _stats_now());
+    FLD_STAT(parser->stats.copy_ns = copied - started);
+
+    // Set up the lexer
+    parser->lexer.start = parser->source;
+    parser->lexer.current = parser->source;
+    parser->lexer.end = parser->source + length;
+    parser->lexer.line_start = parser->source;
+    parser->lexer.line = 1;
+
+    // Get the first token
+    parser->current = NULL;
+    parser->previous = NULL;
+    parser->current = _lexer_scan_token(parser);
+
+    fld_object *last = NULL;
+    uint32_t count = 0;
+    bool ok = _parse_fields(parser, NULL, &parser->root, &last, &count) && _index_build(parser, parser->root, count);
+    FLD_STAT(parser->stats.parse_ns = _stats_now() - copied);
+
+    return ok && parser->last_error.code == FLD_ERROR_NONE;
+}
+
+// Parses fields up to the end of the lexer's text and appends them after
+// `*last`, or makes the first one `*first` while the list is still empty.
+// `parent` is NULL for the top level.
+static bool _parse_fields(fld_parser *parser, fld_object *parent, fld_object **first, fld_object **last, uint32_t *count) {
+    while (parser->current->type != TOKEN_EOF) {
+        // Everything starts with a key...
+        if (parser->current->type != TOKEN_KEY) {
+            parser->last_error.code = FLD_ERROR_UNEXPECTED_TOKEN;
+            parser->last_error.line = parser->current->line;
+            parser->last_error.column = parser->current->column;
+            
+            return false;
+        }
+
+        // Parse field -- top level has no parent (like batman)
+        fld_object *field = _parse_field(parser, parent);
+        if (!field) {
+            // TODO: error?
+            return false;
+        }
+
+        // If this is the first, make it root
+        if (!*first) {
+            *first = field;
+        } else {
+            (*last)->next = field;
+        }
+
+        *last = field;
+        (*count)++;
+    }
+
+    return true;
+}
+
+static bool _value_equal(const fld_value *a, const fld_value *b);
+
+static bool _fields_equal(const fld_object *a, const fld_object *b) {
+    for (; a && b; a = a->next, b = b->next) {
+        if (a->key.length != b->key.length ||
+            memcmp(a->key.start, b->key.start, a->key.length) != 0) {
+            return false;
+        }
+        if (!_value_equal(&a->value, &b->value)) return false;
+    }
+    return a == b;
+}
+
+// Deep comparison of two parsed values. Floats are compared bit for bit.
+static bool _value_equal(const fld_value *a, const fld_value *b) {
+    if (a->type != b->type) return false;
+
+    switch (a->type) {
+        case FLD_VALUE_STRING:
+            return a->as.string.length == b->as.string.length &&
+                   memcmp(a->as.string.start, b->as.string.start, a->as.string.length) == 0;
+        case FLD_VALUE_INT: return a->as.integer == b->as.integer;
+        case FLD_VALUE_INT64: return a->as.int64 == b->as.int64;
+        case FLD_VALUE_FLOAT: return memcmp(&a->as.float_val, &b->as.float_val, sizeof(float)) == 0;
+        case FLD_VALUE_BOOL: return a->as.boolean == b->as.boolean;
+        case FLD_VALUE_VEC2: return memcmp(&a->as.vec2, &b->as.vec2, sizeof(a->as.vec2)) == 0;
+        case FLD_VALUE_VEC3: return memcmp(&a->as.vec3, &b->as.vec3, sizeof(a->as.vec3)) == 0;
+        case FLD_VALUE_VEC4: return memcmp(&a->as.vec4, &b->as.vec4, sizeof(a->as.vec4)) == 0;
+        case FLD_VALUE_OBJECT: return _fields_equal(_value_object(a), _value_object(b));
+        case FLD_VALUE_ARRAY: {
+            if (a->as.array.type != b->as.array.type || a->as.array.count != b->as.array.count) return false;
+            if (a->as.array.type != FLD_VALUE_STRING) {
+                size_t size = (size_t)a->as.array.count * _get_type_size(a->as.array.type);
+                return size == 0 || memcmp(a->as.array.items, b->as.array.items, size) == 0;
+            }
+
+            const fld_string_view *x = (const fld_string_view*)a->as.array.items;
+            const fld_string_view *y = (const fld_string_view*)b->as.array.items;
+            for (int i = 0; i < a->as.array.count; ++i) {
+                if (x[i].length != y[i].length || memcmp(x[i].start, y[i].start, x[i].length) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default: return true;
+    }
+}
+
+// Whether the text a previous field was parsed from is `text`. Compared a
+// byte at a time: the old text is only known to go on as long as it agrees,
+// a field ending within the same bytes would have ended `text` there too.
+static bool _reparse_same_text(const char *old, const char *text, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (old[i] != text[i]) return false;
+    }
+    return true;
+}
+
+static inline void _change_push(fld_changes *changes, fld_change_type type, fld_object *field) {
+    fld_change *change = &changes->items[changes->count++];
+    change->type = type;
+    change->path = field->key;
+    change->field = field;
+}
+
+// The body of fld_reparse. Nothing here touches the previous tree until all
+// allocations went through, so failing at any point leaves it intact.
+static bool _reparse_document(fld_parser *parser, const char *source, size_t length, fld_changes *out_changes) {
+    fld_bump_allocator *alloc = &parser->allocator;
+
+    uint32_t old_count = 0;
+    for (fld_object *field = parser->root; field; field = field->next) {
+        old_count++;
+    }
+    size_t new_bound = _scan_count_fields(source, source + length);
+
+    char *copy = (char*)_bump_alloc(alloc, length + 1, ALIGNOF(char));
+    if (!copy) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    memcpy(copy, source, length);
+    copy[length] = '\0';
+
+    // Lookup over the previous top level (whatever its size), with a flag
+    // per slot for the fields that made it into the new tree
+    fld_index *lookup = NULL;
+    uint8_t *taken = NULL;
+    if (old_count > 0) {
+        lookup = _index_alloc(parser, old_count);
+        if (!lookup) return false;
+
+        taken = (uint8_t*)_bump_alloc(alloc, lookup->capacity, ALIGNOF(uint8_t));
+        if (!taken) {
+            _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+
+        _index_fill(lookup, parser->root);
+        memset(taken, 0, lookup->capacity);
+    }
+
+    // Old fields kept for an equal value take on the text of the new one,
+    // so their hash keeps describing the text their key points into
+    fld_object **order = (fld_object**)_bump_alloc(alloc, 2 * new_bound * sizeof(fld_object*), ALIGNOF(fld_object*));
+    fld_object **retexted = order + new_bound;
+    out_changes->items = (fld_change*)_bump_alloc(alloc, (new_bound + old_count) * sizeof(fld_change), ALIGNOF(fld_change));
+    if (!order || !out_changes->items) {
+        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+
+    // Set up the lexer on the copy
+    fld_lexer *lexer = &parser->lexer;
+    lexer->start = copy;
+    lexer->current = copy;
+    lexer->end = copy + length;
+    lexer->line_start = copy;
+    lexer->line = 1;
+
+    parser->current = NULL;
+    parser->previous = NULL;
+    parser->current = _lexer_scan_token(parser);
+
+    size_t count = 0;
+    memset(retexted, 0, new_bound * sizeof(fld_object*));
+    while (parser->current->type != TOKEN_EOF) {
+        if (parser->current->type != TOKEN_KEY || count == new_bound) {
+            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+            return false;
+        }
+
+        fld_string_view key = parser->current->value.string;
+        fld_object *old = NULL;
+        uint32_t slot = FLD_INDEX_NO_SLOT;
+        bool shadowed = false;
+
+        if (lookup) {
+            slot = _index_find_slot(lookup, key.start, key.length, fld_hash_key(key.start, key.length));
+            if (slot != FLD_INDEX_NO_SLOT) {
+                old = lookup->fields[slot];
+                // A repeated key, the first one already took the old field
+                shadowed = taken[slot];
+            }
+        }
+
+        // Same text as before, keep the old subtree and skip over the text.
+        // The hash only picks the candidates, the text has to match too.
+        const char *field_end = _scan_field_end(key.start, lexer->end);
+        size_t field_length = field_end ? (size_t)(field_end - key.start) : 0;
+        if (old && !shadowed && field_end &&
+            old->value.content_hash == _content_hash(key.start, field_length) &&
+            _reparse_same_text(old->key.start, key.start, field_length)) {
+            taken[slot] = 1;
+            order[count++] = old;
+            out_changes->reused++;
+
+            _lexer_skip_to(lexer, (char*)field_end);
+            parser->current = NULL;
+            parser->previous = NULL;
+            parser->current = _lexer_scan_token(parser);
+            continue;
+        }
+
+        fld_object *field = _parse_field(parser, NULL);
+        if (!field) return false;
+
+        if (shadowed) {
+            order[count++] = field;
+        } else if (!old) {
+            _change_push(out_changes, FLD_CHANGE_ADDED, field);
+            order[count++] = field;
+        } else if (_value_equal(&old->value, &field->value)) {
+            // Only comments or formatting changed, keep the old one
+            taken[slot] = 1;
+            retexted[count] = field;
+            order[count++] = old;
+            out_changes->reused++;
+        } else {
+            taken[slot] = 1;
+            _change_push(out_changes, FLD_CHANGE_MODIFIED, field);
+            order[count++] = field;
+        }
+    }
+
+    // Whatever wasn't taken is gone
+    for (uint32_t i = 0; lookup && i < lookup->capacity; ++i) {
+        if (lookup->fields[i] && !taken[i]) {
+            _change_push(out_changes, FLD_CHANGE_REMOVED, lookup->fields[i]);
+        }
+    }
+
+    fld_index *index = NULL;
+    if (_index_wanted(count)) {
+        index = _index_alloc(parser, (uint32_t)count);
+        if (!index) return false;
+    }
+
+    // Everything is in place, relink the top level into the new tree
+    for (size_t i = 0; i < count; ++i) {
+        if (retexted[i]) {
+            order[i]->key = retexted[i]->key;
+            order[i]->value.content_hash = retexted[i]->value.content_hash;
+        }
+        order[i]->index = NULL;
+        order[i]->next = (i + 1 < count) ? order[i + 1] : NULL;
+    }
+
+    parser->root = count > 0 ? order[0] : NULL;
+    if (index) {
+        _index_fill(index, parser->root);
+        parser->root->index = index;
+    }
+
+    parser->source = copy;
+    parser->source_length = length;
+    return true;
+}
+
+bool fld_reparse(fld_parser *parser, const char *source, size_t length, fld_changes *out_changes) {
+    memset(out_changes, 0, sizeof(fld_changes));
+    parser->last_error.code = FLD_ERROR_NONE;
+    parser->last_error.line = 1;
+    parser->last_error.column = 1;
+
+    fld_bump_allocator saved = parser->allocator;
+    if (!_reparse_document(parser, source, length, out_changes)) {
+        // Drop what was allocated, unless it went into chunks chained since
+        if (parser->allocator.chunks == saved.chunks) {
+            parser->allocator.current = saved.current;
+        }
+        memset(out_changes, 0, sizeof(fld_changes));
+        return false;
+    }
+
+    // Bindings have to resolve again
+    parser->generation++;
+    return true;
+}
+
+// Push parsing. Fed text is appended to a run at the top of the arena and
+// scanned for the ends of top-level fields, with the scanner's state kept
+// across pieces. Complete fields are parsed in batches and their text stays
+// where it is, since the tree points into it. The unfinished rest moves up
+// past the objects built from the batch, to be appended to again.
+enum {
+    FLD_STREAM_CODE,
+    FLD_STREAM_STRING,
+    FLD_STREAM_LINE_COMMENT,
+    FLD_STREAM_BLOCK_COMMENT,
+};
+
+// Scans the pending text up to `end` the way _scan_field_end does. It stops
+// short of a '/' or '*' in the last byte, only the next byte tells whether a
+// comment starts or ends there.
+static void _stream_scan(fld_stream *stream, const char *end) {
+    const char *base = (const char*)stream->pending;
+    const char *p = base + stream->scanned;
+
+    while (p < end) {
+        if (stream->state == FLD_STREAM_STRING) {
+            const char *quote = (const char*)memchr(p, '"', (size_t)(end - p));
+            const char *backslash = (const char*)memchr(p, '\\', (size_t)((quote ? quote : end) - p));
+            if (backslash) {
+                // The escaped byte may still be to come
+                if (backslash + 1 == end) {
+                    p = backslash;
+                    break;
+                }
+                p = backslash + 2;
+                continue;
+            }
+            if (!quote) {
+                p = end;
+                break;
+            }
+            p = quote + 1;
+            stream->state = FLD_STREAM_CODE;
+            continue;
+        }
+
+        if (stream->state == FLD_STREAM_LINE_COMMENT) {
+            const char *newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+            if (!newline) {
+                p = end;
+                break;
+            }
+            p = newline;
+            stream->state = FLD_STREAM_CODE;
+            continue;
+        }
+
+        if (stream->state == FLD_STREAM_BLOCK_COMMENT) {
+            const char *star = (const char*)memchr(p, '*', (size_t)(end - p));
+            if (!star) {
+                p = end;
+                break;
+            }
+            if (star + 1 == end) {
+                p = star;
+                break;
+            }
+            p = star + 1;
+            if (*p == '/') {
+                p++;
+                stream->state = FLD_STREAM_CODE;
+            }
+            continue;
+        }
+
+        char c = *p;
+        if (c == '"') {
+            stream->state = FLD_STREAM_STRING;
+        } else if (c == '/') {
+            if (p + 1 == end) {
+                break;
+            }
+            if (p[1] == '/') {
+                stream->state = FLD_STREAM_LINE_COMMENT;
+                p++;
+            } else if (p[1] == '*') {
+                stream->state = FLD_STREAM_BLOCK_COMMENT;
+                p++;
+            }
+        } else if (c == '{' || c == '[' || c == '(') {
+            stream->depth++;
+        } else if (c == '}' || c == ']' || c == ')') {
+            stream->depth--;
+        } else if (c == ';' && stream->depth <= 0) {
+            stream->complete = (size_t)(p + 1 - base);
+        }
+        p++;
+    }
+
+    stream->scanned = (size_t)(p - base);
+}
+
+// Parses the first `length` bytes of the pending text, which end with a
+// complete top-level field (or the source), then moves the rest up.
+static bool _stream_parse(fld_stream *stream, size_t length) {
+    fld_parser *parser = stream->parser;
+    fld_bump_allocator *alloc = &parser->allocator;
+    char *text = (char*)stream->pending;
+    size_t used = (size_t)(alloc->current - stream->pending);
+
+    // The line this text starts on may have begun in text parsed before,
+    // which isn't necessarily in front of it in memory. Columns are only
+    // ever `line_start` subtracted from a position, so shifting it back by
+    // the characters that came before is enough.
+    parser->lexer.start = text;
+    parser->lexer.current = text;
+    parser->lexer.end = text + length;
+    parser->lexer.line_start = (char*)((uintptr_t)text - stream->column);
+
+    parser->current = NULL;
+    parser->previous = NULL;
+    parser->current = _lexer_scan_token(parser);
+    if (!_parse_fields(parser, NULL, &parser->root, &stream->last, &stream->count)) {
+        return false;
+    }
+
+    stream->column = (size_t)((uintptr_t)(text + length) - (uintptr_t)parser->lexer.line_start);
+
+    size_t rest = used - length;
+    uint8_t *moved = (uint8_t*)_bump_alloc(alloc, rest, ALIGNOF(char));
+    if (!moved) {
+        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+    memmove(moved, text + length, rest);
+
+    stream->pending = moved;
+    stream->scanned -= length;
+    stream->complete = 0;
+    return true;
+}
+
+void fld_stream_begin(fld_stream *stream, fld_parser *parser, void *memory, size_t size) {
+    memset(stream, 0, sizeof(fld_stream));
+    stream->parser = parser;
+
+    _parser_begin(parser);
+    _bump_release(&parser->allocator);
+    _bump_init(&parser->allocator, memory, size);
+
+    // There is no single copy of the source, string views point into the
+    // pieces of it copied into the arena
+    parser->source = NULL;
+    parser->source_length = 0;
+    parser->lexer.line = 1;
+    // Pending text moves around, so nothing can point into it later
+    parser->flags = FLD_PARSE_DEFAULT;
+
+    stream->pending = parser->allocator.current;
+}
+
+bool fld_stream_feed(fld_stream *stream, const char *chunk, size_t length) {
+    if (stream->failed) return false;
+    if (length == 0) return true;
+
+    fld_parser *parser = stream->parser;
+    uint8_t *space = (uint8_t*)_bump_extend(&parser->allocator, &stream->pending, length, ALIGNOF(char));
+    if (!space) {
+        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+        stream->failed = true;
+        return false;
+    }
+    memcpy(space, chunk, length);
+    parser->source_length += length;
+
+    _stream_scan(stream, (const char*)space + length);
+
+    // Parse whatever fields are complete by now
+    if (stream->complete > 0 && !_stream_parse(stream, stream->complete)) {
+        stream->failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool fld_stream_end(fld_stream *stream) {
+    if (stream->failed) return false;
+
+    fld_parser *parser = stream->parser;
+    stream->failed = true;  // Nothing can be fed after this
+
+    // The rest is either trailing comments or a field that never ended,
+    // which the parser reports just as it would for the whole source
+    size_t used = stream->pending ? (size_t)(parser->allocator.current - stream->pending) : 0;
+    if (used > 0 && !_stream_parse(stream, used)) {
+        return false;
+    }
+
+    if (!_index_build(parser, parser->root, stream->count)) {
+        return false;
+    }
+
+    return parser->last_error.code == FLD_ERROR_NONE;
+}
+
+// Binary images. fld_serialize deep copies the tree into the output with the
+// arena functions (objects and indexes first, the string pool after them),
+// then turns every pointer into an offset. Loading turns them back. Field
+// lists are written contiguously, which is what lets the loader check that
+// walking an image always moves forward and ends.
+static inline void *_image_offset(const uint8_t *base, const void *pointer) {
+    return pointer ? (void*)(uintptr_t)((const uint8_t*)pointer - base) : NULL;
+}
+
+static void _image_measure_list(const fld_object *first, fld_measurement *nodes, size_t *strings) {
+    uint32_t count = 0;
+    for (const fld_object *field = first; field; field = field->next) {
+        count++;
+    }
+
+    _measure_alloc(nodes, count * sizeof(fld_object), ALIGNOF(fld_object));
+    if (first->index) {
+        _measure_alloc(nodes, _index_size(_index_capacity(count)), ALIGNOF(fld_index));
+    }
+
+    for (const fld_object *field = first; field; field = field->next) {
+        const fld_value *value = &field->value;
+        *strings += field->key.length;
+
+        if (value->type == FLD_VALUE_STRING) {
+            *strings += value->as.string.length;
+        } else if (value->type == FLD_VALUE_ARRAY && value->as.array.count > 0) {
+            fld_value_type type = value->as.array.type;
+            _measure_alloc(nodes, _get_type_size(type) * value->as.array.count, _get_type_alignment(type));
+
+            if (type == FLD_VALUE_STRING) {
+                const fld_string_view *items = (const fld_string_view*)value->as.array.items;
+                for (int i = 0; i < value->as.array.count; ++i) {
+                    *strings += items[i].length;
+                }
+            }
+        } else if (value->type == FLD_VALUE_OBJECT && _value_object(value)) {
+            _image_measure_list(value->as.object, nodes, strings);
+        }
+    }
+}
+
+static inline fld_string_view _image_copy_string(fld_bump_allocator *strings, fld_string_view view) {
+    char *text = (char*)_bump_alloc_raw(strings, view.length);
+    memcpy(text, view.start, view.length);
+    view.start = text;
+    return view;
 }
 
-/**
- * @brief Converts a field error code to a human-readable string.
- *
- * This function takes a field error code and returns a constant string
- * describing the error. It is useful for logging and debugging purposes.
- *
- * @param code The field error code to convert.
- * @return A constant string describing the error.
- */
-static inline const char *fld_error_string(fld_error_code code) {
-    switch (code) {
-        case FLD_ERROR_NONE: return "No error";
-        case FLD_ERROR_OUT_OF_MEMORY: return "Out of memory";
-        case FLD_ERROR_UNEXPECTED_TOKEN: return "Unexpected token";
-        case FLD_ERROR_INVALID_NUMBER: return "Invalid number format";
-        case FLD_ERROR_INSUFFICIENT_MEMORY: return "Insufficient memory provided";
-        case FLD_ERROR_ARRAY_TYPE_MISMATCH: return "Array type mismatch";
-        case FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE: return "Unsupported array type";
-        case FLD_ERROR_ARRAY_TOO_MANY_ITEMS: return "Too many items in array";
-        default: return "Unknown error";
+// Copies the list in the order _image_measure_list counts it, the output is
+// sized up front so none of the allocations can fail
+static fld_object *_image_copy_list(fld_parser *writer, fld_bump_allocator *strings, const fld_object *first, fld_object *parent) {
+    uint32_t count = 0;
+    for (const fld_object *field = first; field; field = field->next) {
+        count++;
+    }
+
+    fld_object *list = (fld_object*)_bump_alloc(&writer->allocator, count * sizeof(fld_object), ALIGNOF(fld_object));
+    uint32_t i = 0;
+    for (const fld_object *field = first; field; field = field->next, ++i) {
+        fld_object *copy = &list[i];
+        if (field->value.type == FLD_VALUE_OBJECT) {
+            _value_object(&field->value);
+        }
+        *copy = *field;
+        copy->key = _image_copy_string(strings, field->key);
+        copy->next = field->next ? &list[i + 1] : NULL;
+        copy->parent = parent;
+        copy->index = NULL;
     }
+
+    // Rebuilt rather than copied, it needs the new addresses anyway
+    if (first->index) {
+        list->index = _index_alloc(writer, count);
+        _index_fill(list->index, list);
+    }
+
+    for (i = 0; i < count; ++i) {
+        fld_value *value = &list[i].value;
+
+        if (value->type == FLD_VALUE_STRING) {
+            value->as.string = _image_copy_string(strings, value->as.string);
+        } else if (value->type == FLD_VALUE_ARRAY && value->as.array.count > 0) {
+            fld_value_type type = value->as.array.type;
+            size_t size = _get_type_size(type) * value->as.array.count;
+            void *items = _bump_alloc(&writer->allocator, size, _get_type_alignment(type));
+            memcpy(items, value->as.array.items, size);
+            value->as.array.items = items;
+
+            if (type == FLD_VALUE_STRING) {
+                fld_string_view *views = (fld_string_view*)items;
+                for (int j = 0; j < value->as.array.count; ++j) {
+                    views[j] = _image_copy_string(strings, views[j]);
+                }
+            }
+        } else if (value->type == FLD_VALUE_OBJECT && value->as.object) {
+            value->as.object = _image_copy_list(writer, strings, value->as.object, &list[i]);
+        }
+    }
+
+    return list;
 }
 
-#ifdef __cplusplus
+static void _image_unlink_list(fld_object *first, const uint8_t *base) {
+    fld_index *index = first->index;
+    if (index) {
+        for (uint32_t i = 0; i < index->capacity; ++i) {
+            index->fields[i] = (fld_object*)_image_offset(base, index->fields[i]);
+        }
+        index->hashes = (uint32_t*)_image_offset(base, index->hashes);
+        index->fields = (fld_object**)_image_offset(base, index->fields);
+        index->last = NULL;     // Found again when the slots are filled on load
+    }
+
+    fld_object *next;
+    for (fld_object *field = first; field; field = next) {
+        next = field->next;
+        fld_value *value = &field->value;
+
+        if (value->type == FLD_VALUE_STRING) {
+            value->as.string.start = (char*)_image_offset(base, value->as.string.start);
+        } else if (value->type == FLD_VALUE_ARRAY) {
+            if (value->as.array.type == FLD_VALUE_STRING) {
+                fld_string_view *views = (fld_string_view*)value->as.array.items;
+                for (int i = 0; i < value->as.array.count; ++i) {
+                    views[i].start = (char*)_image_offset(base, views[i].start);
+                }
+            }
+            value->as.array.items = _image_offset(base, value->as.array.items);
+        } else if (value->type == FLD_VALUE_OBJECT && value->as.object) {
+            _image_unlink_list(value->as.object, base);
+            value->as.object = (fld_object*)_image_offset(base, value->as.object);
+        }
+
+        field->key.start = (char*)_image_offset(base, field->key.start);
+        field->next = (fld_object*)_image_offset(base, field->next);
+        field->index = (fld_index*)_image_offset(base, field->index);
+        field->parent = NULL;   // Restored from the walk on load
+    }
 }
-#endif
 
-// TEMP: For developing
-// #define FLD_PARSER_IMPLEMENTATION
-#ifdef FLD_PARSER_IMPLEMENTATION
+// Bytes of the header and tree, the string pool follows them
+static size_t _image_measure(const fld_object *root, size_t *out_strings) {
+    fld_measurement nodes;
+    memset(&nodes, 0, sizeof(fld_measurement));
+    *out_strings = 0;
 
-// Forward declarations
-static fld_value *_parse_object(fld_parser *parser, fld_object *parent);
-static fld_value *_parse_value(fld_parser *parser, fld_object *parent);
-static fld_object *_parse_field(fld_parser *parser, fld_object *parent);
-static fld_value *_parse_vec(fld_parser *parser, fld_object *parent);
+    _measure_alloc(&nodes, sizeof(fld_binary_header), ALIGNOF(fld_binary_header));
+    if (root) {
+        _image_measure_list(root, &nodes, out_strings);
+    }
+    return nodes.bytes;
+}
 
-static inline void _bump_init(fld_bump_allocator *alloc, void *memory, size_t size) {
-    alloc->start = (uint8_t*)memory;
-    alloc->current = alloc->start;
-    alloc->end = alloc->start + size;
-    // TODO: maybe zero out the whole block of memory?
+// Images are laid out for the strictest alignment of what they hold
+static inline bool _image_is_aligned(const void *image) {
+    return ((uintptr_t)image & (ALIGNOF(fld_object) - 1)) == 0 &&
+        ((uintptr_t)image & (ALIGNOF(int64_t) - 1)) == 0;
 }
 
-static inline uintptr_t _align_up(uintptr_t addr, size_t align) {
-    return (addr + (align - 1) & ~(align - 1));
+size_t fld_serialized_size(const fld_object *root) {
+    size_t strings;
+    return _image_measure(root, &strings) + strings;
 }
 
-static inline void *_bump_alloc(fld_bump_allocator *alloc, size_t size, size_t align) {
-    uint8_t *aligned = (uint8_t*)_align_up((uintptr_t)alloc->current, align);
-    uint8_t *new_current = aligned + size;
+size_t fld_serialize(const fld_object *root, void *out, size_t size) {
+    size_t strings_size;
+    size_t nodes_size = _image_measure(root, &strings_size);
+    size_t needed = nodes_size + strings_size;
+    if (size < needed || !_image_is_aligned(out)) return 0;
+
+    fld_binary_header *header = (fld_binary_header*)out;
+    uint8_t *base = (uint8_t*)out;
+
+    // Objects go through a parser so indexes are built the usual way
+    fld_parser writer;
+    memset(&writer, 0, sizeof(fld_parser));
+    _bump_init(&writer.allocator, base + sizeof(fld_binary_header), nodes_size - sizeof(fld_binary_header));
+    fld_bump_allocator strings;
+    memset(&strings, 0, sizeof(fld_bump_allocator));
+    _bump_init(&strings, base + nodes_size, strings_size);
+
+    fld_object *copy = root ? _image_copy_list(&writer, &strings, root, NULL) : NULL;
+    if (copy) {
+        _image_unlink_list(copy, base);
+    }
 
-    // Check if we have enough space by address comparison
-    if (new_current > alloc->end) {
-        return 0;
+    memset(header, 0, sizeof(fld_binary_header));
+    header->magic = FLD_BINARY_MAGIC;
+    header->version = FLD_BINARY_VERSION;
+    header->pointer_size = (uint8_t)sizeof(void*);
+    header->object_size = (uint8_t)sizeof(fld_object);
+    header->size = needed;
+    header->root = (uint64_t)(uintptr_t)_image_offset(base, copy);
+    header->strings = nodes_size;
+    return needed;
+}
+
+// Turns the offset in `*slot` into a pointer to `count` items of `size`,
+// provided they all lie inside the image
+static bool _image_link(void **slot, uint8_t *base, size_t image_size, size_t count, size_t size, size_t align) {
+    uintptr_t offset = (uintptr_t)*slot;
+    if (offset == 0) {
+        return count == 0;
+    }
+    if (offset >= image_size || (offset & (align - 1)) ||
+        (size > 0 && count > (image_size - offset) / size)) {
+        return false;
     }
 
-    alloc->current = new_current;
-    return aligned;
+    *slot = base + offset;
+    return true;
 }
-// TODO: this can be used by the aligned bump_alloc
-static inline void *_bump_alloc_raw(fld_bump_allocator *alloc, size_t size) {
-    uint8_t *new_current = alloc->current + size;
 
-    // Check if we have enough space by address comparison
-    if (new_current > alloc->end) {
-        return 0;
+static bool _image_link_list(uint8_t *base, size_t image_size, uintptr_t offset, fld_object *parent) {
+    fld_object *first = (fld_object*)(base + offset);
+    fld_object *field = first;
+    uint32_t count = 0;
+
+    while (true) {
+        fld_value *value = &field->value;
+        field->parent = parent;
+        count++;
+
+        // The keys point into the string pool, not at any source text
+        value->content_hash = 0;
+
+        if (field->key.length <= 0 ||
+            !_image_link((void**)&field->key.start, base, image_size, (size_t)field->key.length, 1, 1)) {
+            return false;
+        }
+        if ((unsigned)value->type >= FLD_VALUE_TYPE_COUNT) return false;
+
+        if (value->type == FLD_VALUE_STRING) {
+            if (value->as.string.length < 0 ||
+                !_image_link((void**)&value->as.string.start, base, image_size, (size_t)value->as.string.length, 1, 1)) {
+                return false;
+            }
+        } else if (value->type == FLD_VALUE_ARRAY) {
+            fld_value_type type = value->as.array.type;
+            if (value->as.array.count < 0 || (unsigned)type >= FLD_VALUE_TYPE_COUNT ||
+                type == FLD_VALUE_ARRAY || type == FLD_VALUE_OBJECT) {
+                return false;
+            }
+
+            size_t items = (size_t)value->as.array.count;
+            if (!_image_link(&value->as.array.items, base, image_size, items, _get_type_size(type), _get_type_alignment(type))) {
+                return false;
+            }
+
+            if (type == FLD_VALUE_STRING) {
+                fld_string_view *views = (fld_string_view*)value->as.array.items;
+                for (size_t i = 0; i < items; ++i) {
+                    if (views[i].length < 0 ||
+                        !_image_link((void**)&views[i].start, base, image_size, (size_t)views[i].length, 1, 1)) {
+                        return false;
+                    }
+                }
+            }
+        } else if (value->type == FLD_VALUE_OBJECT) {
+            // Nothing in an image is lazy
+            value->as.lazy.body = NULL;
+
+            // Children are always written after their parent
+            uintptr_t child = (uintptr_t)value->as.object;
+            if (child) {
+                if (child <= (uintptr_t)((uint8_t*)field - base) ||
+                    !_image_link((void**)&value->as.object, base, image_size, 1, sizeof(fld_object), ALIGNOF(fld_object)) ||
+                    !_image_link_list(base, image_size, child, field)) {
+                    return false;
+                }
+            }
+        }
+
+        // The next field has to be the one right after this one
+        uintptr_t next = (uintptr_t)field->next;
+        if (!next) {
+            field->next = NULL;
+            break;
+        }
+        if (next != (uintptr_t)((uint8_t*)(field + 1) - base) ||
+            !_image_link((void**)&field->next, base, image_size, 1, sizeof(fld_object), ALIGNOF(fld_object))) {
+            return false;
+        }
+        field = field->next;
     }
 
-    uint8_t* result = alloc->current;
-    alloc->current = new_current;
-    return result;
+    // Only the first field of a list carries an index, pointing into the list
+    for (field = first->next; field; field = field->next) {
+        if (field->index) return false;
+    }
+    if (first->index) {
+        if (!_image_link((void**)&first->index, base, image_size, 1, sizeof(fld_index), ALIGNOF(fld_index))) {
+            return false;
+        }
+
+        // Lookups probe until they hit an empty slot, so there has to be one
+        fld_index *index = first->index;
+        uint32_t capacity = index->capacity;
+        if (capacity == 0 || (capacity & (capacity - 1)) || capacity <= count ||
+            !_image_link((void**)&index->fields, base, image_size, capacity, sizeof(fld_object*), ALIGNOF(fld_object*)) ||
+            !_image_link((void**)&index->hashes, base, image_size, capacity, sizeof(uint32_t), ALIGNOF(uint32_t))) {
+            return false;
+        }
+
+        // The slots are rebuilt from the linked fields rather than trusted
+        memset(index->fields, 0, capacity * sizeof(fld_object*));
+        index->count = 0;
+        _index_fill(index, first);
+    }
+
+    return true;
+}
+
+bool fld_load_binary(fld_parser *parser, void *image, size_t size) {
+    _parser_begin(parser);
+    _bump_release(&parser->allocator);
+    _bump_init(&parser->allocator, NULL, 0);
+    parser->source = NULL;
+    parser->source_length = 0;
+
+    uint8_t *base = (uint8_t*)image;
+    fld_binary_header *header = (fld_binary_header*)image;
+    bool valid = size >= sizeof(fld_binary_header) && _image_is_aligned(image) &&
+        header->magic == FLD_BINARY_MAGIC &&
+        header->version == FLD_BINARY_VERSION &&
+        header->pointer_size == sizeof(void*) &&
+        header->object_size == sizeof(fld_object) &&
+        header->size <= size;
+
+    if (valid && header->root) {
+        size = (size_t)header->size;
+        void *root = (void*)(uintptr_t)header->root;
+        valid = header->root >= sizeof(fld_binary_header) &&
+            _image_link(&root, base, size, 1, sizeof(fld_object), ALIGNOF(fld_object)) &&
+            _image_link_list(base, size, (uintptr_t)header->root, NULL);
+        if (valid) {
+            parser->root = (fld_object*)root;
+        }
+    }
+
+    if (!valid) {
+        parser->root = NULL;
+        parser->last_error.code = FLD_ERROR_INVALID_IMAGE;
+        return false;
+    }
+    return true;
+}
+
+// Compact trees. A first walk counts nodes and sizes the text and data
+// pools, the second fills the arrays in pre-order.
+typedef struct {
+    uint32_t nodes;
+    size_t text;
+    size_t data;
+} fld_compact_counts;
+
+static inline size_t _compact_vec_size(fld_value_type type) {
+    return type == FLD_VALUE_VEC2 ? 2 * sizeof(float) : type == FLD_VALUE_VEC3 ? 3 * sizeof(float) : 4 * sizeof(float);
 }
 
-// TODO: Run a couple tests to see how close this estimate is
-static inline size_t _estimate_memory_needed(const char *source, size_t *out_len) {
-    *out_len = strlen(source);
+// Counts one field, everything but the children of objects
+static void _compact_count_field(const fld_object *field, fld_compact_counts *counts) {
+    const fld_value *value = &field->value;
+    counts->nodes++;
+    counts->text += field->key.length;
 
-    // Heuristic
-    // - Assume we might need a value/object for every ~4 chars on avg.
-    // - Plus the full length of the source text as we'll be copying it.
-    // - With some overhead for worst case.
-    size_t estimate = (*out_len / 4) * (sizeof(fld_value) + sizeof(fld_object));
-    size_t overhead = 1024;
+    switch (value->type) {
+        case FLD_VALUE_STRING:
+            counts->text += value->as.string.length;
+            break;
+        case FLD_VALUE_VEC2:
+        case FLD_VALUE_VEC3:
+        case FLD_VALUE_VEC4:
+            counts->data = (size_t)_align_up((uintptr_t)counts->data, ALIGNOF(float)) + _compact_vec_size(value->type);
+            break;
+        case FLD_VALUE_ARRAY: {
+            fld_value_type type = value->as.array.type;
+            if (value->as.array.count == 0) break;
+
+            counts->data = (size_t)_align_up((uintptr_t)counts->data, _get_type_alignment(type)) +
+                _get_type_size(type) * value->as.array.count;
+            if (type == FLD_VALUE_STRING) {
+                const fld_string_view *items = (const fld_string_view*)value->as.array.items;
+                for (int i = 0; i < value->as.array.count; ++i) {
+                    counts->text += items[i].length;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
 
-    return estimate + overhead;
+static void _compact_count(const fld_object *first, fld_compact_counts *counts) {
+    for (const fld_object *field = first; field; field = field->next) {
+        _compact_count_field(field, counts);
+        if (field->value.type == FLD_VALUE_OBJECT) {
+            _compact_count(_value_object(&field->value), counts);
+        }
+    }
 }
 
-static inline bool _is_digit(char c) {
-    return c >= '0' && c <= '9';
+// Carves the arrays out of `alloc`, widest elements first
+static bool _compact_layout(fld_bump_allocator *alloc, const fld_compact_counts *counts, fld_compact_tree *tree) {
+    uint32_t n = counts->nodes;
+    tree->count = n;
+    tree->payloads = (fld_compact_payload*)_bump_alloc(alloc, n * sizeof(fld_compact_payload), ALIGNOF(fld_compact_payload));
+    tree->data = (uint8_t*)_bump_alloc(alloc, counts->data, ALIGNOF(fld_compact_payload));
+    tree->keys = (uint32_t*)_bump_alloc(alloc, n * sizeof(uint32_t), ALIGNOF(uint32_t));
+    tree->key_lengths = (uint32_t*)_bump_alloc(alloc, n * sizeof(uint32_t), ALIGNOF(uint32_t));
+    tree->next = (uint32_t*)_bump_alloc(alloc, n * sizeof(uint32_t), ALIGNOF(uint32_t));
+    tree->parents = (uint32_t*)_bump_alloc(alloc, n * sizeof(uint32_t), ALIGNOF(uint32_t));
+    tree->types = (uint8_t*)_bump_alloc(alloc, n, 1);
+    tree->item_types = (uint8_t*)_bump_alloc(alloc, n, 1);
+    tree->text = (char*)_bump_alloc(alloc, counts->text, 1);
+
+    return tree->payloads && tree->data && tree->keys && tree->key_lengths &&
+        tree->next && tree->parents && tree->types && tree->item_types && tree->text;
 }
 
-static inline bool _is_alpha(char c) {
-    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+static inline uint32_t _compact_text(const fld_compact_tree *tree, fld_compact_counts *filled, fld_string_view view) {
+    uint32_t offset = (uint32_t)filled->text;
+    memcpy(tree->text + offset, view.start, view.length);
+    filled->text += view.length;
+    return offset;
 }
 
-// Only handles only digit positive numbers
-static int _fast_atoi(const char *str) {
-    int res = *str - '0';
-    ++str;
-    while (*str) {
-        res = res * 10 + (*str++ - '0');
+// Writes one field as node `filled->nodes`, everything but the children of
+// objects and the link from the previous sibling
+static uint32_t _compact_fill_field(const fld_object *field, uint32_t parent, fld_compact_tree *tree, fld_compact_counts *filled) {
+    const fld_value *value = &field->value;
+    uint32_t node = filled->nodes++;
+    fld_compact_payload *payload = &tree->payloads[node];
+
+    tree->keys[node] = _compact_text(tree, filled, field->key);
+    tree->key_lengths[node] = (uint32_t)field->key.length;
+    tree->types[node] = (uint8_t)value->type;
+    tree->item_types[node] = FLD_VALUE_EMPTY;
+    tree->next[node] = FLD_COMPACT_NONE;
+    tree->parents[node] = parent;
+    memset(payload, 0, sizeof(fld_compact_payload));
+
+    switch (value->type) {
+        case FLD_VALUE_STRING:
+            payload->string.length = (uint32_t)value->as.string.length;
+            payload->string.offset = _compact_text(tree, filled, value->as.string);
+            break;
+        case FLD_VALUE_INT:
+            payload->integer = value->as.integer;
+            break;
+        case FLD_VALUE_INT64:
+            payload->int64 = value->as.int64;
+            break;
+        case FLD_VALUE_FLOAT:
+            payload->float_val = value->as.float_val;
+            break;
+        case FLD_VALUE_BOOL:
+            payload->boolean = value->as.boolean;
+            break;
+        case FLD_VALUE_VEC2:
+        case FLD_VALUE_VEC3:
+        case FLD_VALUE_VEC4:
+            // The vec members all start with x, y, ...
+            filled->data = (size_t)_align_up((uintptr_t)filled->data, ALIGNOF(float));
+            payload->vec = (uint32_t)filled->data;
+            memcpy(tree->data + filled->data, &value->as.vec4, _compact_vec_size(value->type));
+            filled->data += _compact_vec_size(value->type);
+            break;
+        case FLD_VALUE_ARRAY: {
+            fld_value_type type = value->as.array.type;
+            size_t size = _get_type_size(type) * value->as.array.count;
+            tree->item_types[node] = (uint8_t)type;
+            payload->array.count = (uint32_t)value->as.array.count;
+            if (value->as.array.count == 0) break;
+
+            filled->data = (size_t)_align_up((uintptr_t)filled->data, _get_type_alignment(type));
+            payload->array.offset = (uint32_t)filled->data;
+            memcpy(tree->data + filled->data, value->as.array.items, size);
+
+            // String items point into the tree's own text
+            if (type == FLD_VALUE_STRING) {
+                fld_string_view *items = (fld_string_view*)(tree->data + filled->data);
+                for (int i = 0; i < value->as.array.count; ++i) {
+                    items[i].start = tree->text + _compact_text(tree, filled, items[i]);
+                }
+            }
+            filled->data += size;
+            break;
+        }
+        default:
+            break;
     }
-    return res;
+    return node;
 }
 
-// Only sign and digits, no white-spaces
-static double _fast_atof(const char* str) {
-    double value = 0;
-    while (*str != '.') {
-        value = value * 10 + (*str++ - '0');
-        if (!*str) return value;  // No decimal point
+// Writes the list starting at node `filled->nodes` and everything below it
+static void _compact_fill(const fld_object *first, uint32_t parent, fld_compact_tree *tree, fld_compact_counts *filled) {
+    uint32_t previous = FLD_COMPACT_NONE;
+
+    for (const fld_object *field = first; field; field = field->next) {
+        uint32_t node = _compact_fill_field(field, parent, tree, filled);
+        if (previous != FLD_COMPACT_NONE) {
+            tree->next[previous] = node;
+        }
+        previous = node;
+
+        if (field->value.type == FLD_VALUE_OBJECT) {
+            uint32_t children = 0;
+            const fld_object *first = _value_object(&field->value);
+            for (const fld_object *child = first; child; child = child->next) {
+                children++;
+            }
+            tree->payloads[node].children = children;
+            _compact_fill(first, node, tree, filled);
+        }
     }
-    double factor = 0.1;
-    while (*++str) {
-        value += (*str - '0') * factor;
-        factor *= 0.1;
+}
+
+// Laid out like _compact_layout does it, from an aligned start
+static size_t _compact_bytes(const fld_compact_counts *counts) {
+    fld_measurement m;
+    memset(&m, 0, sizeof(fld_measurement));
+    _measure_alloc(&m, counts->nodes * sizeof(fld_compact_payload), ALIGNOF(fld_compact_payload));
+    _measure_alloc(&m, counts->data, ALIGNOF(fld_compact_payload));
+    _measure_alloc(&m, 4 * counts->nodes * sizeof(uint32_t), ALIGNOF(uint32_t));
+    _measure_alloc(&m, 2 * counts->nodes + counts->text, 1);
+    return m.bytes;
+}
+
+// Lays the arrays for the counted tree out in `memory`
+static bool _compact_begin(const fld_compact_counts *counts, void *memory, size_t size, fld_compact_tree *out) {
+    if (counts->text > UINT32_MAX || counts->data > UINT32_MAX) return false;
+
+    fld_bump_allocator alloc;
+    memset(&alloc, 0, sizeof(fld_bump_allocator));
+    _bump_init(&alloc, memory, size);
+    if (!_compact_layout(&alloc, counts, out)) {
+        memset(out, 0, sizeof(fld_compact_tree));
+        return false;
     }
-    return value;
+    return true;
 }
 
-static bool _lexer_is_at_end(fld_lexer *lexer) {
-    return *lexer->current == '\0';
+size_t fld_compact_size(const fld_object *root) {
+    fld_compact_counts counts = {0, 0, 0};
+    _compact_count(root, &counts);
+    return _compact_bytes(&counts);
 }
 
-static char _lexer_advance(fld_lexer *lexer) {
-    lexer->column++;
-    return *lexer->current++;
+bool fld_compact(const fld_object *root, void *memory, size_t size, fld_compact_tree *out) {
+    memset(out, 0, sizeof(fld_compact_tree));
+
+    fld_compact_counts counts = {0, 0, 0};
+    _compact_count(root, &counts);
+    if (!_compact_begin(&counts, memory, size, out)) return false;
+
+    fld_compact_counts filled = {0, 0, 0};
+    _compact_fill(root, FLD_COMPACT_NONE, out, &filled);
+    return true;
 }
 
-static char _lexer_peek(fld_lexer *lexer) {
-    return *lexer->current;
+uint32_t fld_compact_find(const fld_compact_tree *tree, const char *path) {
+    if (!path || tree->count == 0) return FLD_COMPACT_NONE;
+
+    uint32_t node = 0;
+    const char *segment = path;
+    while (true) {
+        const char *dot = strchr(segment, '.');
+        size_t length = dot ? (size_t)(dot - segment) : strlen(segment);
+
+        // Siblings, first match wins like in a linear scan
+        while (node != FLD_COMPACT_NONE &&
+               !(tree->key_lengths[node] == length && memcmp(tree->text + tree->keys[node], segment, length) == 0)) {
+            node = tree->next[node];
+        }
+        if (node == FLD_COMPACT_NONE || !dot) return node;
+
+        // More segments to go, this has to be an object with children
+        if (tree->types[node] != FLD_VALUE_OBJECT || tree->payloads[node].children == 0) {
+            return FLD_COMPACT_NONE;
+        }
+        node++;
+        segment = dot + 1;
+    }
 }
 
-static char _lexer_peek_next(fld_lexer *lexer) {
-    if (_lexer_is_at_end(lexer)) return '\0';
-    return lexer->current[1];
+static fld_object *_find_field_linear(fld_object *object, const char *key, int key_len) {
+    fld_object *current = object;
+    while (current) {
+        if (current->key.length == key_len &&
+            memcmp(current->key.start, key, key_len) == 0) {
+            return current;
+        }
+        current = current->next;
+    }
+    return NULL;
 }
 
-static fld_token *_token_create(fld_parser *parser, fld_token_type type, int line, int column) {
-    fld_token *token = (fld_token*)_bump_alloc(&parser->allocator, sizeof(fld_token), ALIGNOF(fld_token));
-    if (token == NULL) {
-        parser->last_error.line = line;
-        parser->last_error.column = column;
-        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+static fld_object *_find_field(fld_object *object, const char *key, int key_len) {
+    if (!object) return NULL;
+
+    // Large lists carry an index on their first field
+    if (object->index) {
+        return _index_find(object->index, key, key_len, fld_hash_key(key, key_len));
+    }
+    return _find_field_linear(object, key, key_len);
+}
+
+static fld_object *_find_field_hashed(fld_object *object, const char *key, int key_len, uint32_t hash) {
+    if (!object) return NULL;
+
+    if (object->index) {
+        return _index_find(object->index, key, key_len, hash);
+    }
+    return _find_field_linear(object, key, key_len);
+}
+
+fld_object *fld_get_field(fld_object *object, const char *path) {
+    return _find_field(object, path, strlen(path));
+}
+
+fld_object *fld_get_field_by_path(fld_object *object, const char *path) {
+    // Empty or NULL path
+    if (!path || !*path) {
         return NULL;
     }
 
-    token->type = type;
-    token->line = line;
-    token->column = column;
+    // Walk the segments in place, empty ones (".." or a leading dot) are skipped
+    fld_object *current = object;
+    const char *segment = path;
+    while (true) {
+        while (*segment == '.') {
+            segment++;
+        }
+        if (!*segment) {
+            return NULL;
+        }
+
+        const char *end = segment;
+        while (*end && *end != '.') {
+            end++;
+        }
+
+        // Find the field
+        fld_object *field = _find_field(current, segment, (int)(end - segment));
+        if (!field) {
+            return NULL;
+        }
+
+        // Last segment (trailing dots don't count) - this is our target field
+        const char *rest = end;
+        while (*rest == '.') {
+            rest++;
+        }
+        if (!*rest) {
+            return field;
+        }
+
+        // If there are more segments, this must be an object
+        if (field->value.type != FLD_VALUE_OBJECT) {
+            return NULL;
+        }
+        current = _value_object(&field->value);
+        segment = rest;
+    }
+}
+
+bool fld_path_compile(fld_path *out_path, const char *path) {
+    out_path->segment_count = 0;
+    if (!path) return false;
+
+    size_t length = strlen(path);
+    if (length == 0 || length >= FLD_MAX_PATH_LENGTH) return false;
+    memcpy(out_path->text, path, length + 1);
+
+    size_t i = 0;
+    while (i < length) {
+        // Skip separators, empty segments are ignored
+        if (path[i] == '.') {
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < length && path[i] != '.') {
+            i++;
+        }
+
+        if (out_path->segment_count >= FLD_MAX_PATH_SEGMENTS) {
+            out_path->segment_count = 0;
+            return false;
+        }
+
+        fld_path_segment *segment = &out_path->segments[out_path->segment_count++];
+        segment->offset = (uint16_t)start;
+        segment->length = (uint16_t)(i - start);
+        segment->hash = fld_hash_key(path + start, i - start);
+    }
+
+    return out_path->segment_count > 0;
+}
+
+fld_object *fld_path_resolve(fld_object *object, const fld_path *path) {
+    fld_object *current = object;
 
-    return token;
-}
+    for (int i = 0; i < path->segment_count; ++i) {
+        const fld_path_segment *segment = &path->segments[i];
+        fld_object *field = _find_field_hashed(current, path->text + segment->offset, segment->length, segment->hash);
+        if (!field) {
+            return NULL;
+        }
 
-static fld_token *_lexer_handle_string(fld_parser *parser, fld_lexer *lexer) {
-    while (_lexer_peek(lexer) != '"' && !_lexer_is_at_end(lexer)) {
-        if (_lexer_peek(lexer) == '\n') {
-            lexer->line++;
-            lexer->column = 1;
+        // Last segment - this is our target field
+        if (i == path->segment_count - 1) {
+            return field;
         }
-        _lexer_advance(lexer);
-    }
 
-    if (_lexer_is_at_end(lexer)) {
-        // Unterminated string
-        return _token_create(parser, TOKEN_ERROR, lexer->line, lexer->column);
+        // If there are more segments, this must be an object
+        if (field->value.type != FLD_VALUE_OBJECT) {
+            return NULL;
+        }
+        current = _value_object(&field->value);
     }
 
-    // Consume the closing quote
-    _lexer_advance(lexer);
+    return NULL;
+}
 
-    // Create token pointing to the string's contents (excluding quotes)
-    fld_token *token = _token_create(parser, TOKEN_STRING, lexer->line, lexer->column);
-    token->value.string.start = lexer->start + 1; // Skipping opening quote
-    token->value.string.length = (lexer->current - lexer->start) - 2; // Exclude both quotes
+fld_object *fld_bind(fld_binding *binding, const fld_path *path, fld_parser *parser) {
+    binding->path = path;
+    binding->parser = parser;
+    binding->generation = parser->generation;
+    binding->field = fld_path_resolve(parser->root, path);
+    return binding->field;
+}
 
-    return token;
+static inline bool _schema_type_supported(fld_value_type type) {
+    switch (type) {
+        case FLD_VALUE_INT:
+        case FLD_VALUE_INT64:
+        case FLD_VALUE_FLOAT:
+        case FLD_VALUE_BOOL:
+        case FLD_VALUE_STRING:
+        case FLD_VALUE_VEC2:
+        case FLD_VALUE_VEC3:
+        case FLD_VALUE_VEC4:
+            return true;
+        default:
+            return false;
+    }
 }
 
-static fld_token *_lexer_handle_number(fld_parser *parser, fld_lexer *lexer, bool is_negative) {
-    // TODO: Add error for too long/large numbers
-    
-    // A bit larger than max digits for null terminator and safety
-    char num_str[FLD_MAX_DIGITS + 3];
-    char *num_ptr = num_str;
-    uint8_t digit_count = 0;
+bool fld_schema_compile(fld_schema *schema, const fld_schema_field *fields, uint32_t count, fld_schema_node *nodes, uint32_t capacity) {
+    memset(schema, 0, sizeof(fld_schema));
+    schema->fields = fields;
+    schema->field_count = count;
+    schema->nodes = nodes;
+
+    // The first top-level segment, always node 0 once there is one
+    uint32_t top = FLD_SCHEMA_NONE;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const char *path = fields[i].path;
+        if (!path || !_schema_type_supported(fields[i].type)) return false;
+        if (fields[i].flags & FLD_SCHEMA_REQUIRED) schema->required_count++;
+
+        // Walk down the trie, adding the segments it doesn't have yet.
+        // Empty segments are skipped like in fld_get_field_by_path.
+        uint32_t *link = NULL;
+        uint32_t node = FLD_SCHEMA_NONE;
+        const char *segment = path;
+        while (true) {
+            while (*segment == '.') {
+                segment++;
+            }
+            if (!*segment) break;
 
-    // Skip the sign in input but don't copy it
-    if (*lexer->current == '+' || *lexer->current == '-') {
-        _lexer_advance(lexer);
-    }
+            const char *end = segment;
+            while (*end && *end != '.') {
+                end++;
+            }
+            uint32_t length = (uint32_t)(end - segment);
+
+            // Siblings stay in the order they were first listed
+            uint32_t *head = node == FLD_SCHEMA_NONE ? &top : &nodes[node].first_child;
+            uint32_t child = *head;
+            uint32_t last = FLD_SCHEMA_NONE;
+            while (child != FLD_SCHEMA_NONE &&
+                   !(nodes[child].length == length && memcmp(nodes[child].key, segment, length) == 0)) {
+                last = child;
+                child = nodes[child].next;
+            }
+
+            if (child == FLD_SCHEMA_NONE) {
+                if (schema->node_count >= capacity) return false;
+
+                child = schema->node_count++;
+                nodes[child].key = segment;
+                nodes[child].length = length;
+                nodes[child].hash = fld_hash_key(segment, length);
+                nodes[child].first_child = FLD_SCHEMA_NONE;
+                nodes[child].next = FLD_SCHEMA_NONE;
+                nodes[child].field = FLD_SCHEMA_NONE;
+
+                if (last != FLD_SCHEMA_NONE) {
+                    nodes[last].next = child;
+                } else {
+                    *head = child;
+                }
+            }
 
-    // Conver bool to 1/-1 for multiplication without branching
-    int sign = 1 - (2 * is_negative);
-    fld_token *token;
+            link = &nodes[child].field;
+            node = child;
+            segment = end;
+        }
 
-    // As long as we are encountering digits, let's advance
-    while (_is_digit(_lexer_peek(lexer))) {
-        *num_ptr++ = _lexer_advance(lexer);
-        digit_count++;
+        if (!link || *link != FLD_SCHEMA_NONE) return false;
+        *link = i;
     }
 
-    // Look for decimal point followed by numbers
-    if (_lexer_peek(lexer) == '.' && _is_digit(_lexer_peek_next(lexer))) {
-        // Consume the '.'
-        *num_ptr++ = _lexer_advance(lexer);
+    return true;
+}
+
+// Stores the field's value as the descriptor asks for, if the types match
+static bool _schema_store(const fld_schema_field *descriptor, const fld_object *field, void *out) {
+    uint8_t *destination = (uint8_t*)out + descriptor->offset;
+    const fld_value *value = &field->value;
+
+    switch (descriptor->type) {
+        case FLD_VALUE_INT64:
+            if (value->type == FLD_VALUE_INT) {
+                int64_t widened = value->as.integer;
+                memcpy(destination, &widened, sizeof(int64_t));
+                return true;
+            }
+            if (value->type != FLD_VALUE_INT64) return false;
+            memcpy(destination, &value->as.int64, sizeof(int64_t));
+            return true;
+        case FLD_VALUE_INT:
+            if (value->type != FLD_VALUE_INT) return false;
+            memcpy(destination, &value->as.integer, sizeof(int));
+            return true;
+        case FLD_VALUE_FLOAT:
+            if (value->type != FLD_VALUE_FLOAT) return false;
+            memcpy(destination, &value->as.float_val, sizeof(float));
+            return true;
+        case FLD_VALUE_BOOL:
+            if (value->type != FLD_VALUE_BOOL) return false;
+            memcpy(destination, &value->as.boolean, sizeof(bool));
+            return true;
+        case FLD_VALUE_STRING:
+            if (value->type != FLD_VALUE_STRING) return false;
+            memcpy(destination, &value->as.string, sizeof(fld_string_view));
+            return true;
+        case FLD_VALUE_VEC2:
+        case FLD_VALUE_VEC3:
+        case FLD_VALUE_VEC4:
+            if (value->type != descriptor->type) return false;
+            // All the vec members start with x, y, ...
+            memcpy(destination, &value->as.vec4, (size_t)(descriptor->type - FLD_VALUE_VEC2 + 2) * sizeof(float));
+            return true;
+        default:
+            return false;
+    }
+}
 
-        // Continue with the remaining digits
-        while (_is_digit(_lexer_peek(lexer)) && digit_count < FLD_MAX_DIGITS) {
-            *num_ptr++ = _lexer_advance(lexer);
-            digit_count++;
+static void _schema_fill_level(const fld_schema *schema, uint32_t first, fld_object *list, void *out, uint64_t *missing, uint32_t *required) {
+    for (uint32_t n = first; n != FLD_SCHEMA_NONE; n = schema->nodes[n].next) {
+        const fld_schema_node *node = &schema->nodes[n];
+        fld_object *field = _find_field_hashed(list, node->key, (int)node->length, node->hash);
+        if (!field) continue;
+
+        if (node->field != FLD_SCHEMA_NONE) {
+            const fld_schema_field *descriptor = &schema->fields[node->field];
+            if (_schema_store(descriptor, field, out)) {
+                if (missing) missing[node->field / 64] &= ~((uint64_t)1 << (node->field % 64));
+                if (descriptor->flags & FLD_SCHEMA_REQUIRED) (*required)++;
+            }
         }
 
-        // Check if we hit the digit limit, and if we have more
-        if (_is_digit(_lexer_peek(lexer))) {
-            parser->last_error.code = FLD_ERROR_INVALID_NUMBER;
-            parser->last_error.line = lexer->line;
-            parser->last_error.column = lexer->column;
-            return _token_create(parser, TOKEN_ERROR, lexer->line, lexer->column);
+        if (node->first_child != FLD_SCHEMA_NONE && field->value.type == FLD_VALUE_OBJECT) {
+            _schema_fill_level(schema, node->first_child, _value_object(&field->value), out, missing, required);
         }
+    }
+}
 
-        *num_ptr = '\0';
-        
-        token = _token_create(parser, TOKEN_FLOAT, lexer->line, lexer->column);
-        token->value.float_val = _fast_atof(num_str) * sign;
-    } else {
-        if (_is_digit(_lexer_peek(lexer))) {
-            parser->last_error.code = FLD_ERROR_INVALID_NUMBER;
-            parser->last_error.line = lexer->line;
-            parser->last_error.column = lexer->column;
-            return _token_create(parser, TOKEN_ERROR, lexer->line, lexer->column);
+bool fld_schema_fill(const fld_schema *schema, fld_object *root, void *out, uint64_t *out_missing) {
+    if (out_missing) {
+        // Everything is missing until it is found
+        uint32_t words = (schema->field_count + 63) / 64;
+        for (uint32_t i = 0; i < words; ++i) {
+            uint32_t bits = schema->field_count - i * 64;
+            out_missing[i] = bits >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1);
         }
+    }
 
-        *num_ptr = '\0';
-        token = _token_create(parser, TOKEN_INT, lexer->line, lexer->column);
-        token->value.integer = _fast_atoi(num_str) * sign;
+    uint32_t required = 0;
+    if (schema->node_count > 0) {
+        _schema_fill_level(schema, 0, root, out, out_missing, &required);
     }
-    return token;
+    return required == schema->required_count;
 }
 
-static fld_token *_lexer_handle_keyword(fld_parser *parser, fld_lexer *lexer) {
-    while (_is_alpha(_lexer_peek(lexer)) || _is_digit(_lexer_peek(lexer))) {
-        _lexer_advance(lexer);
+bool fld_get_str_view(fld_object *object, const char *path, fld_string_view *str_view) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_STRING) {
+        return false;
     }
+    str_view->start = field->value.as.string.start;
+    str_view->length = field->value.as.string.length;
+    return true;
+}
 
-    // Check if it's a keyword (true/false)
-    int length = lexer->current - lexer->start;
-    if (length == 4) {
-        // false
-        // TODO: Make it case insensitive!
-        if (strncmp(lexer->start, "true", 4) == 0) {
-            fld_token *token = _token_create(parser, TOKEN_BOOL, lexer->line, lexer->column);
-            token->value.boolean = true;
-            return token;
-        }
-        // We just check if it starts with Vec and according to the number
-        // that follows we emit the right token. If something is fishy, we error.
-        if (strncmp(lexer->start, "vec", 3) == 0) {
-            // If it's not 2, 3, 4 -> error!
-            if (lexer->start[3] > '4' || lexer->start[3] < '2') {
-                return _token_create(parser, TOKEN_ERROR, lexer->line, lexer->column);
-            }
+bool fld_get_cstr(fld_object *object, const char *path, char *buffer, size_t buffer_size) {
+    fld_string_view str_view;
 
-            // Emit Vec token where the integer value contains the supposed size
-            fld_token *token = _token_create(parser, TOKEN_VEC, lexer->line, lexer->column);
-            token->value.integer = lexer->start[3] - 48;
-            return token;
-        }
-    }
-    if (length == 5 && strncmp(lexer->start, "false", 5) == 0) {
-        fld_token *token = _token_create(parser, TOKEN_BOOL, lexer->line, lexer->column);
-        token->value.boolean = false;
-        return token;
+    // Validate input
+    if (!buffer || buffer_size == 0) return false;
+    
+    // Try to get string view first
+    if (!fld_get_str_view(object, path, &str_view)) {
+        // Null terminate on failure
+        buffer[0] = '\0';
+        return false;
     }
 
-    // Regular key
-    fld_token *token = _token_create(parser, TOKEN_KEY, lexer->line, lexer->column);
-    token->value.string.start = lexer->start;
-    token->value.string.length = length;
+    // Check if buffer is large enough plus null terminator
+    if (str_view.length >= buffer_size) {
+        buffer[0] = '\0';
+        return false;
+    }
 
-    return token;
+    memcpy(buffer, str_view.start, str_view.length);
+    buffer[str_view.length] = '\0';
+    return true;
 }
 
-static fld_token *_lexer_scan_token(fld_parser *parser) {
-    fld_lexer *lexer = &parser->lexer;
-    
-    // Skip whitespace
-    while (!_lexer_is_at_end(lexer)) {
-        char c = _lexer_peek(lexer);
-        if (c == ' ' || c == '\r' || c == '\t') {
-            _lexer_advance(lexer);
-            continue;
-        }
-        else if (c == '\n') {
-            lexer->line++;
-            lexer->column = 1;
-            _lexer_advance(lexer);
-            continue;
-        }
-        break;
+bool fld_get_int(fld_object *object, const char *path, int *out_value) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_INT) {
+        return false;
     }
+    *out_value = field->value.as.integer;
+    return true;
+}
 
-    // Store the start of the token
-    lexer->start = lexer->current;
+bool fld_get_int64(fld_object *object, const char *path, int64_t *out_value) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field) return false;
 
-    if (_lexer_is_at_end(lexer)) {
-        return _token_create(parser, TOKEN_EOF, lexer->line, lexer->column);
+    if (field->value.type == FLD_VALUE_INT) {
+        *out_value = field->value.as.integer;
+        return true;
+    }
+    if (field->value.type != FLD_VALUE_INT64) {
+        return false;
     }
+    *out_value = field->value.as.int64;
+    return true;
+}
 
-    char c = _lexer_advance(lexer);
+bool fld_get_float(fld_object *object, const char *path, float *out_value) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_FLOAT) {
+        return false;
+    }
+    *out_value = field->value.as.float_val;
+    return true;
+}
 
-    // Handle comments
-    if (c == '/') {
-        // Line comment
-        if (_lexer_peek(lexer) == '/') {
-            while (_lexer_peek(lexer) != '\n' && !_lexer_is_at_end(lexer)) {
-                _lexer_advance(lexer);
-            }
-            // Recursively get the next token
-            return _lexer_scan_token(parser);
-        }
-        // Block comment
-        else if (_lexer_peek(lexer) == '*') {
-            // Consume the '*'
-            _lexer_advance(lexer);
-
-            while (!_lexer_is_at_end(lexer)) {
-                if (_lexer_peek(lexer) == '*' && _lexer_peek_next(lexer) == '/') {
-                    // Consume '*'
-                    _lexer_advance(lexer);
-                    // Consume '/'
-                    _lexer_advance(lexer);
-                    // Recursively get the next token
-                    return _lexer_scan_token(parser);
-                }
+bool fld_get_bool(fld_object *object, const char *path, bool *out_value) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_BOOL) {
+        return false;
+    }
+    *out_value = field->value.as.boolean;
+    return true;
+}
 
-                // Handle newlines in block comments
-                if (_lexer_peek(lexer) == '\n') {
-                    lexer->line++;
-                    lexer->column = 1;
-                }
+bool fld_get_array(fld_object *object, const char *path, fld_value_type *out_type, void** out_items, size_t* out_count) {
+    fld_object* field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_ARRAY) {
+        return false;
+    }
+    *out_type = field->value.as.array.type;
+    *out_items = field->value.as.array.items;
+    *out_count = field->value.as.array.count;
+    return true;
+}
 
-                _lexer_advance(lexer);
-            }
-        }
+bool fld_get_vec2(fld_object *object, const char *path, float *out_x, float *out_y) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_VEC2) {
+        return false;
     }
+    *out_x = field->value.as.vec2.x;
+    *out_y = field->value.as.vec2.y;
+    return true;
+}
 
-    // Handle string literals
-    if (c == '"') return _lexer_handle_string(parser, lexer);
+bool fld_get_vec3(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_VEC3) {
+        return false;
+    }
+    *out_x = field->value.as.vec3.x;
+    *out_y = field->value.as.vec3.y;
+    *out_z = field->value.as.vec3.z;
+    return true;
+}
 
-    // Handle numbers
-    if (_is_digit(c) || (c == '-' && _is_digit(_lexer_peek(lexer)))) {
-        // Back up so number() sees the first digit
-        lexer->current--;
-        bool is_negative = (*lexer->current == '-');
-        return _lexer_handle_number(parser, lexer, is_negative);
+bool fld_get_vec4(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z, float *out_w) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_VEC4) {
+        return false;
+    }
+    *out_x = field->value.as.vec4.x;
+    *out_y = field->value.as.vec4.y;
+    *out_z = field->value.as.vec4.z;
+    *out_w = field->value.as.vec4.w;
+    return true;
+}
+
+bool fld_get_vec_components(fld_object *object, const char *path, float *out_components, size_t* out_count) {
+    fld_object* field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type < FLD_VALUE_VEC2 || field->value.type > FLD_VALUE_VEC4) {
+        return false;
     }
 
-    // Handle key and keywords
-    if (_is_alpha(c)) {
-        // Back up so the keywords() sees the first character
-        lexer->current--;
-        return _lexer_handle_keyword(parser, lexer);
+    // Calculate component count from type
+    *out_count = (field->value.type - FLD_VALUE_VEC2) + 2;
+
+    // Copy components using the fact that vectors are contiguous in memory
+    const float *src = (const float*)&field->value.as.vec2;
+    memcpy(out_components, src, *out_count * sizeof(float));
+    return true;
+}
+
+bool fld_get_object(fld_object *object, const char *path, fld_object **out_object) {
+    fld_object* field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_OBJECT) {
+        return false;
     }
+    *out_object = _value_object(&field->value);
+    return true;
+}
 
-    // Handle single character tokens
-    switch (c) {
-        case '=': return _token_create(parser, TOKEN_EQUALS, lexer->line, lexer->column - 1);
-        case '{': return _token_create(parser, TOKEN_BRACE_LEFT, lexer->line, lexer->column - 1);
-        case '}': return _token_create(parser, TOKEN_BRACE_RIGHT, lexer->line, lexer->column - 1);
-        case '[': return _token_create(parser, TOKEN_BRACKET_LEFT, lexer->line, lexer->column - 1);
-        case ']': return _token_create(parser, TOKEN_BRACKET_RIGHT, lexer->line, lexer->column - 1);
-        case '(': return _token_create(parser, TOKEN_PAREN_LEFT, lexer->line, lexer->column - 1);
-        case ')': return _token_create(parser, TOKEN_PAREN_RIGHT, lexer->line, lexer->column - 1);
-        case ';': return _token_create(parser, TOKEN_SEMICOLON, lexer->line, lexer->column - 1);
-        case ',': return _token_create(parser, TOKEN_COMMA, lexer->line, lexer->column - 1);
+fld_object *fld_get_children(fld_object *field) {
+    if (!field || field->value.type != FLD_VALUE_OBJECT) {
+        return NULL;
     }
+    return _value_object(&field->value);
+}
 
-    // If we get here, error
-    return _token_create(parser, TOKEN_ERROR, lexer->line, lexer->column - 1);
+bool fld_has_field(fld_object *object, const char *path) {
+    return fld_get_field_by_path(object, path) != NULL;
 }
 
-static void _parser_error(fld_parser *parser, fld_error_code error_code) {
-    // Avoid cascading errors
-    if (parser->last_error.code != FLD_ERROR_NONE) return;
+fld_value_type fld_get_type(fld_object *object, const char *path) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field) {
+        return FLD_VALUE_EMPTY;
+    }
+    return field->value.type;
+}
 
-    parser->last_error.code = error_code;
-    parser->last_error.line = parser->current->line;
-    parser->last_error.column = parser->current->column;
+bool fld_get_array_size(fld_object *object, const char *path, size_t *out_size) {
+    fld_object *field = fld_get_field_by_path(object, path);
+    if (!field || field->value.type != FLD_VALUE_ARRAY) {
+        return false;
+    }
+    *out_size = field->value.as.array.count;
+    return true;
 }
 
-static void _parser_advance(fld_parser *parser) {
-    // Save the current token for error reporting
-    parser->previous = parser->current;
+// Editing. New fields come from the parser's free list before the arena,
+// removed ones go onto it through their `next` link. Only fields are reused,
+// key, string and item bytes stay where they are until the arena is reset.
+static void _edit_error(fld_parser *parser, fld_error_code code) {
+    // Edits have no place in the source to report
+    parser->last_error.code = code;
+    parser->last_error.line = 0;
+    parser->last_error.column = 0;
+}
+
+static void *_edit_alloc(fld_parser *parser, size_t size, size_t align) {
+    void *memory = _bump_alloc(&parser->allocator, size, align);
+    if (!memory) {
+        _edit_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+    }
+    return memory;
+}
 
-    // Keep getting tokens until we get a non-error one or reach EOF
-    while (true) {
-        parser->current = _lexer_scan_token(parser);
-        if (parser->current->type != TOKEN_ERROR) break;
+static void _edit_release_list(fld_parser *parser, fld_object *first);
 
-        // Handle error token by reporting it
-        _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
+// Hands back the fields a value holds before it is overwritten
+static void _edit_release_value(fld_parser *parser, fld_value *value) {
+    // A lazy body that was never parsed has no fields yet
+    if (value->type == FLD_VALUE_OBJECT && value->as.object) {
+        _edit_release_list(parser, value->as.object);
+        parser->generation++;
     }
 }
 
-static void _parser_consume(fld_parser *parser, fld_token_type type, fld_error_code error_code) {
-    // Like match, but raises an error if the token isn't what we expect
-    if (parser->current->type == type) {
-        _parser_advance(parser);
-        return;
+static void _edit_release_list(fld_parser *parser, fld_object *first) {
+    while (first) {
+        fld_object *next = first->next;
+        _edit_release_value(parser, &first->value);
+
+        first->next = parser->free_fields;
+        parser->free_fields = first;
+        first = next;
     }
+}
 
-    _parser_error(parser, error_code);
+// The top-level field above an edit no longer matches its source text, so
+// fld_reparse mustn't keep it for the same text
+static void _edit_touch(fld_object *field) {
+    while (field->parent) {
+        field = field->parent;
+    }
+    field->value.content_hash = 0;
 }
 
-static bool _parser_match(fld_parser *parser, fld_token_type type) {
-    // Check if current token matches expected type
-    if (parser->current->type != type) return false;
-    _parser_advance(parser);
+// Adds `field` to the index of the list starting at `first`, which holds
+// `count` fields with it. Lists that grew large enough get an index.
+static bool _edit_index_add(fld_parser *parser, fld_object *first, fld_object *field, uint32_t count) {
+    if (FLD_INDEX_MIN_FIELDS <= 0) return true;
+
+    uint32_t hash = fld_hash_key(field->key.start, field->key.length);
+    fld_index *index = first->index;
+    if (index && _index_capacity(index->count + 1) <= index->capacity) {
+        _index_insert(index, field, hash);
+        return true;
+    }
+    if (!index && !_index_wanted(count)) return true;
+
+    // Rebuilt with room for twice as many, so the rebuilds stay O(1) per
+    // added field on average
+    uint32_t capacity = _index_capacity(2 * count);
+    void *memory = _edit_alloc(parser, _index_size(capacity), ALIGNOF(fld_index));
+    if (!memory) return false;
+    FLD_STAT(parser->stats.index_bytes += _index_size(capacity));
+
+    index = _index_place(memory, capacity);
+    _index_fill(index, first == field ? NULL : first);
+    if (!_index_find(index, field->key.start, field->key.length, hash)) {
+        _index_insert(index, field, hash);
+    }
+    first->index = index;
     return true;
 }
 
-static bool _parser_expect(fld_parser *parser, fld_token_type type, fld_error_code error_code) {
-    if (!_parser_match(parser, type)) {
-        _parser_error(parser, error_code);
+// Appends `field` to the list at `*list`, keeping its index up to date.
+// An indexed list knows its last field, only the short lists below
+// FLD_INDEX_MIN_FIELDS are walked to find it.
+static bool _edit_link(fld_parser *parser, fld_object *parent, fld_object **list, fld_object *field) {
+    field->parent = parent;
+    field->next = NULL;
+    field->index = NULL;
+
+    fld_object *first = *list;
+    fld_object *last = first;
+    uint32_t count = 1;
+    if (first && first->index) {
+        last = first->index->last;
+        count += first->index->count;
+    } else {
+        for (; last && last->next; last = last->next) count++;
+        if (last) count++;
+    }
+
+    // The index first, the field only joins the list once it can be found
+    if (!_edit_index_add(parser, last ? first : field, field, count)) {
         return false;
     }
+    if (last) {
+        last->next = field;
+    } else {
+        *list = field;
+    }
+    if ((*list)->index) {
+        (*list)->index->last = field;
+    }
 
+    // Bindings that found nothing have to look again
+    parser->generation++;
     return true;
 }
 
-static fld_object *_parse_object_fields(fld_parser *parser, fld_object *parent) {
-    // Skip the opening brace
-    _parser_advance(parser);
+// Appends a new field to the list at `*list`, its value an empty object
+static fld_object *_edit_add(fld_parser *parser, fld_object *parent, fld_object **list, const char *key, int length) {
+    char *text = (char*)_edit_alloc(parser, (size_t)length, 1);
+    if (!text) return NULL;
+    memcpy(text, key, (size_t)length);
 
-    // Handle empty object
-    if (_parser_match(parser, TOKEN_BRACE_RIGHT)) {
-        // Empty object has no fields
+    fld_object *field = parser->free_fields;
+    if (field) {
+        parser->free_fields = field->next;
+    } else {
+        field = (fld_object*)_edit_alloc(parser, sizeof(fld_object), ALIGNOF(fld_object));
+        if (!field) return NULL;
+        FLD_STAT(parser->stats.object_bytes += sizeof(fld_object));
+    }
+
+    memset(field, 0, sizeof(fld_object));
+    field->key.start = text;
+    field->key.length = length;
+    field->value.type = FLD_VALUE_OBJECT;
+
+    if (!_edit_link(parser, parent, list, field)) {
+        field->next = parser->free_fields;
+        parser->free_fields = field;
         return NULL;
     }
+    return field;
+}
 
-    fld_object *first_field = NULL;
-    fld_object *last_field = NULL;
+// The field at `path`, adding the missing ones as empty objects. NULL if a
+// field before the last segment isn't an object.
+static fld_object *_edit_field(fld_parser *parser, const char *path) {
+    if (!path) return NULL;
 
-    // Parse fields until we hit the closing brace
+    fld_object *parent = NULL;
+    fld_object **list = &parser->root;
+    const char *segment = path;
     while (true) {
-        // Expect a key token
-        if (parser->current->type != TOKEN_KEY) {
-            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
-            return NULL;
+        while (*segment == '.') {
+            segment++;
         }
+        if (!*segment) return NULL;
 
-        // Parse a field
-        fld_object *field = _parse_field(parser, parent);
-        if (!field) {
-            return NULL;
+        const char *end = segment;
+        while (*end && *end != '.') {
+            end++;
         }
 
-        // Add to the linked list
-        if (!first_field) {
-            first_field = field;
-        } else {
-            last_field->next = field;
+        int length = (int)(end - segment);
+        fld_object *field = _find_field(*list, segment, length);
+        if (!field) {
+            field = _edit_add(parser, parent, list, segment, length);
+            if (!field) return NULL;
         }
-        last_field = field;
 
-        // If we see a closing brace, we're done
-        if (parser->current->type == TOKEN_BRACE_RIGHT) {
-            break;
+        const char *rest = end;
+        while (*rest == '.') {
+            rest++;
         }
-    }
+        if (!*rest) return field;
 
-    // Consume the closing brace
-    if (!_parser_expect(parser, TOKEN_BRACE_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) {
-        return NULL;
+        if (field->value.type != FLD_VALUE_OBJECT) return NULL;
+        _value_object(&field->value);
+        parent = field;
+        list = &field->value.as.object;
+        segment = rest;
     }
-
-    last_field->next = NULL;
-    return first_field;
 }
 
-static fld_value *_parse_object(fld_parser *parser, fld_object *parent) {
-    // Allocate and init value
-    fld_value *value = (fld_value*)_bump_alloc(&parser->allocator, sizeof(fld_value), ALIGNOF(fld_value));
-    if (!value) {
-        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
-        return NULL;
-    }
+static fld_object *_edit_set(fld_parser *parser, const char *path, const fld_value *value) {
+    fld_object *field = _edit_field(parser, path);
+    if (!field) return NULL;
 
-    // Init the structure to zero
-    memset(value, 0, sizeof(fld_value));
-    value->type = FLD_VALUE_OBJECT;
+    _edit_release_value(parser, &field->value);
+    uint32_t content_hash = field->value.content_hash;
+    field->value = *value;
+    field->value.content_hash = content_hash;
 
-    // Parse the object's fields
-    value->as.object = _parse_object_fields(parser, parent);
-    if (parser->last_error.code != FLD_ERROR_NONE) {
-        return NULL;
-    }
+    _edit_touch(field);
+    return field;
+}
 
-    return value;
+fld_object *fld_set_int(fld_parser *parser, const char *path, int value) {
+    fld_value v;
+    memset(&v, 0, sizeof(v));
+    v.type = FLD_VALUE_INT;
+    v.as.integer = value;
+    return _edit_set(parser, path, &v);
 }
 
-static size_t _get_type_size(fld_value_type type) {
-    switch (type) {
-        case FLD_VALUE_STRING: return sizeof(fld_string_view);
-        case FLD_VALUE_INT: return sizeof(int);
-        case FLD_VALUE_FLOAT: return sizeof(float);
-        case FLD_VALUE_BOOL: return sizeof(bool);
-        default: return sizeof(fld_value);
+fld_object *fld_set_int64(fld_parser *parser, const char *path, int64_t value) {
+    // Stored like a parse would store the same number
+    if (_fits_int(value)) {
+        return fld_set_int(parser, path, (int)value);
     }
+
+    fld_value v;
+    memset(&v, 0, sizeof(v));
+    v.type = FLD_VALUE_INT64;
+    v.as.int64 = value;
+    return _edit_set(parser, path, &v);
 }
 
-static size_t _get_type_alignment(fld_value_type type) {
-    switch (type) {
-        case FLD_VALUE_STRING: return ALIGNOF(fld_string_view);
-        case FLD_VALUE_INT: return ALIGNOF(int);
-        case FLD_VALUE_FLOAT: return ALIGNOF(float);
-        case FLD_VALUE_BOOL: return ALIGNOF(bool);
-        default: return ALIGNOF(fld_value);
-    }
+fld_object *fld_set_float(fld_parser *parser, const char *path, float value) {
+    fld_value v;
+    memset(&v, 0, sizeof(v));
+    v.type = FLD_VALUE_FLOAT;
+    v.as.float_val = value;
+    return _edit_set(parser, path, &v);
 }
 
-static fld_value *_parse_array(fld_parser *parser, fld_object *parent) {
-    // Save lexer state for rewinding
-    char* start_pos = parser->lexer.current;
-    int start_line = parser->lexer.line;
-    int start_column = parser->lexer.column;
+fld_object *fld_set_bool(fld_parser *parser, const char *path, bool value) {
+    fld_value v;
+    memset(&v, 0, sizeof(v));
+    v.type = FLD_VALUE_BOOL;
+    v.as.boolean = value;
+    return _edit_set(parser, path, &v);
+}
 
-    // First pass - count items and validate first type
-    _parser_advance(parser);  // Skip '['
+// A copy of a string in the arena, NULL for empty ones
+static char *_edit_copy_string(fld_parser *parser, const char *text, size_t length) {
+    if (!text || length == 0) return NULL;
 
-    // Handle empty array fast path
-    if (_parser_match(parser, TOKEN_BRACKET_RIGHT)) {
-        fld_value *array = (fld_value*)_bump_alloc(&parser->allocator, sizeof(fld_value), ALIGNOF(fld_value));
-        if (!array) {
-            _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
-            return NULL;
-        }
-        array->type = FLD_VALUE_ARRAY;
-        array->as.array.count = 0;
-        array->as.array.items = NULL;
-        array->as.array.type = FLD_VALUE_EMPTY;
-        return array;
+    char *copy = (char*)_edit_alloc(parser, length, 1);
+    if (copy) {
+        memcpy(copy, text, length);
+        FLD_STAT(parser->stats.string_bytes += length);
     }
+    return copy;
+}
 
-    // Parse first value to get type
-    fld_value *first_value = _parse_value(parser, parent);
-    if (!first_value) return NULL;
+fld_object *fld_set_str(fld_parser *parser, const char *path, const char *text) {
+    size_t length = text ? strlen(text) : 0;
+    char *copy = _edit_copy_string(parser, text, length);
+    if (!copy) return NULL;
+
+    fld_value v;
+    memset(&v, 0, sizeof(v));
+    v.type = FLD_VALUE_STRING;
+    v.as.string.start = copy;
+    v.as.string.length = (int)length;
+    return _edit_set(parser, path, &v);
+}
 
-    // Validate array element type - no nested arrays or objects allowed
-    if (first_value->type == FLD_VALUE_ARRAY || first_value->type == FLD_VALUE_OBJECT) {
-        _parser_error(parser, FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE);
-        return NULL;
-    }
+fld_object *fld_set_vec(fld_parser *parser, const char *path, const float *components, int count) {
+    if (count < 2 || count > 4) return NULL;
 
-    // Count remaining items
-    size_t count = 1;  // We already have one
-    while (_parser_match(parser, TOKEN_COMMA)) {
-        if (count >= FLD_MAX_ARRAY_ITEMS) {
-            _parser_error(parser, FLD_ERROR_ARRAY_TOO_MANY_ITEMS);
-            return NULL;
-        }
-        
-        // Skip the value token, don't need to parse it yet
-        _parser_advance(parser);
-        count++;
-    }
+    fld_value v;
+    memset(&v, 0, sizeof(v));
+    v.type = (fld_value_type)(FLD_VALUE_VEC2 + count - 2);
+    memcpy(&v.as.vec4, components, (size_t)count * sizeof(float));
+    return _edit_set(parser, path, &v);
+}
 
-    if (!_parser_expect(parser, TOKEN_BRACKET_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) {
-        return NULL;
-    }
+fld_object *fld_add_object(fld_parser *parser, const char *path) {
+    fld_object *field = _edit_field(parser, path);
+    if (!field || field->value.type == FLD_VALUE_OBJECT) return field;
 
-    // Restore lexer state
-    parser->lexer.current = start_pos;
-    parser->lexer.line = start_line;
-    parser->lexer.column = start_column;
-    parser->current = _lexer_scan_token(parser);
+    fld_value v;
+    memset(&v, 0, sizeof(v));
+    v.type = FLD_VALUE_OBJECT;
+    return _edit_set(parser, path, &v);
+}
 
-    // Now allocate array and storage
-    fld_value *array = (fld_value*)_bump_alloc(&parser->allocator, sizeof(fld_value), ALIGNOF(fld_value));
-    if (!array) {
-        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
-        return NULL;
-    }
+// Moves parsed fields into the list of `target`, the top level when NULL.
+// An object meeting an object is merged into it, anything else replaces
+// the old value and the node it came in is freed.
+static bool _merge_fields(fld_parser *parser, fld_object *target, fld_object *incoming) {
+    fld_object **list = target ? &target->value.as.object : &parser->root;
 
-    array->type = FLD_VALUE_ARRAY;
-    array->as.array.type = first_value->type;
-    array->as.array.count = count;
+    while (incoming) {
+        fld_object *field = incoming;
+        incoming = incoming->next;
 
-    // Allocate storage for all items
-    size_t item_size = _get_type_size(array->as.array.type);
-    size_t item_align = _get_type_alignment(array->as.array.type);
+        fld_object *existing = _find_field(*list, field->key.start, field->key.length);
+        if (!existing) {
+            if (!_edit_link(parser, target, list, field)) return false;
+            continue;
+        }
 
-    void* items = _bump_alloc(&parser->allocator, item_size * count, item_align);
-    if (!items) {
-        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
-        return NULL;
+        if (existing->value.type == FLD_VALUE_OBJECT && field->value.type == FLD_VALUE_OBJECT) {
+            _value_object(&existing->value);
+            if (!_merge_fields(parser, existing, field->value.as.object)) return false;
+            _edit_touch(existing);
+        } else {
+            _edit_release_value(parser, &existing->value);
+            // A top-level field also takes the hash of its new text
+            existing->value = field->value;
+            if (existing->value.type == FLD_VALUE_OBJECT) {
+                for (fld_object *child = existing->value.as.object; child; child = child->next) {
+                    child->parent = existing;
+                }
+            }
+            if (existing->parent) _edit_touch(existing);
+        }
+
+        field->next = parser->free_fields;
+        parser->free_fields = field;
     }
-    array->as.array.items = items;
+    return true;
+}
 
-    // Second pass - parse and store values
-    char* current = (char*)items;
+bool fld_parse_into(fld_parser *parser, const char *path, const char *source) {
+    parser->last_error.code = FLD_ERROR_NONE;
+    parser->last_error.line = 1;
+    parser->last_error.column = 1;
 
-    for (size_t i = 0; i < count; i++) {
-        fld_value *value = _parse_value(parser, parent);
-        if (!value) return NULL;
+    size_t length = strlen(source);
+    char *copy = (char*)_edit_alloc(parser, length + 1, ALIGNOF(char));
+    if (!copy) return false;
+    memcpy(copy, source, length);
+    copy[length] = '\0';
+    FLD_STAT(parser->stats.source_bytes += length + 1);
+
+    parser->lexer.start = copy;
+    parser->lexer.current = copy;
+    parser->lexer.end = copy + length;
+    parser->lexer.line_start = copy;
+    parser->lexer.line = 1;
 
-        if (value->type != array->as.array.type) {
-            _parser_error(parser, FLD_ERROR_ARRAY_TYPE_MISMATCH);
-            return NULL;
-        }
+    parser->current = NULL;
+    parser->previous = NULL;
+    parser->current = _lexer_scan_token(parser);
 
-        // Copy value based on type
-        switch (array->as.array.type) {
-            case FLD_VALUE_STRING:
-                *((fld_string_view*)current) = value->as.string;
-                break;
-            case FLD_VALUE_INT:
-                *((int*)current) = value->as.integer;
-                break;
-            case FLD_VALUE_FLOAT:
-                *((float*)current) = value->as.float_val;
-                break;
-            case FLD_VALUE_BOOL:
-                *((bool*)current) = value->as.boolean;
-                break;
-            default:
-                _parser_error(parser, FLD_ERROR_ARRAY_TYPE_MISMATCH);
-                return NULL;
+    // Parsed as a top level of its own, objects right away since they are
+    // merged next anyway
+    uint32_t flags = parser->flags;
+    parser->flags &= ~(uint32_t)FLD_PARSE_LAZY_OBJECTS;
+    fld_object *first = NULL;
+    fld_object *last = NULL;
+    uint32_t count = 0;
+    bool ok = _parse_fields(parser, NULL, &first, &last, &count);
+    parser->flags = flags;
+    if (!ok || parser->last_error.code != FLD_ERROR_NONE) return false;
+
+    fld_object *target = NULL;
+    if (path && *path) {
+        target = fld_add_object(parser, path);
+        if (!target) {
+            if (parser->last_error.code == FLD_ERROR_NONE) {
+                _edit_error(parser, FLD_ERROR_INVALID_PATH);
+            }
+            return false;
         }
+        _value_object(&target->value);
 
-        current += item_size;
-        
-        // Skip comma except for last item
-        if (i < count - 1) {
-            _parser_consume(parser, TOKEN_COMMA, FLD_ERROR_UNEXPECTED_TOKEN);
+        // The hashes of the text only mean something at the top level
+        for (fld_object *field = first; field; field = field->next) {
+            field->value.content_hash = 0;
         }
     }
 
-    // Consume final bracket
-    _parser_consume(parser, TOKEN_BRACKET_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN);
+    return _merge_fields(parser, target, first);
+}
 
-    return array;
+// Takes a field out of its index, moving the next entries of its probe run
+// back so they stay reachable
+static void _index_remove(fld_index *index, uint32_t slot) {
+    uint32_t mask = index->capacity - 1;
+    index->fields[slot] = NULL;
+    index->count--;
+
+    for (uint32_t i = (slot + 1) & mask; index->fields[i]; i = (i + 1) & mask) {
+        // An entry can fill the hole if the hole is on its way from its home slot
+        uint32_t home = index->hashes[i] & mask;
+        if (((i - home) & mask) >= ((i - slot) & mask)) {
+            index->fields[slot] = index->fields[i];
+            index->hashes[slot] = index->hashes[i];
+            index->fields[i] = NULL;
+            slot = i;
+        }
+    }
 }
 
-static fld_value *_parse_vec(fld_parser *parser, fld_object *parent) {
-    // Get vector size from keyword token
-    int vec_size = parser->current->value.integer;
+bool fld_remove_field(fld_parser *parser, const char *path) {
+    fld_object *field = fld_get_field_by_path(parser->root, path);
+    if (!field) return false;
+
+    // Lists are only linked forward, so the field before this one has to be
+    // walked to. A back link would cost every field of every tree 8 bytes.
+    fld_object **list = field->parent ? &field->parent->value.as.object : &parser->root;
+    fld_object *first = *list;
+    fld_object *before = NULL;
+    for (fld_object *at = first; at != field; at = at->next) {
+        before = at;
+    }
 
-    // Consume vec token
-    _parser_advance(parser);
+    // The index lives on the first field, it moves to the next one
+    fld_index *index = first->index;
+    if (before) {
+        before->next = field->next;
+    } else {
+        *list = field->next;
+        if (field->next) field->next->index = index;
+    }
+    if (index && index->last == field) {
+        index->last = before;
+    }
+    field->index = NULL;
 
-    // We expect opening parenthesis here
-    if(!_parser_expect(parser, TOKEN_PAREN_LEFT, FLD_ERROR_UNEXPECTED_TOKEN)) {
-        return NULL;
+    if (index && *list) {
+        uint32_t hash = fld_hash_key(field->key.start, field->key.length);
+        uint32_t slot = _index_find_slot(index, field->key.start, field->key.length, hash);
+        if (slot != FLD_INDEX_NO_SLOT && index->fields[slot] == field) {
+            _index_remove(index, slot);
+
+            // A later field with the same key takes over
+            fld_object *same = _find_field_linear(field->next, field->key.start, field->key.length);
+            if (same) _index_insert(index, same, hash);
+        }
     }
 
-    // Allocate value
-    fld_value *value = (fld_value*)_bump_alloc(&parser->allocator, sizeof(fld_value), ALIGNOF(fld_value));
-    if (!value) {
-        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+    if (field->parent) {
+        _edit_touch(field->parent);
     }
-    memset(value, 0, sizeof(fld_value));
+    field->next = NULL;
+    _edit_release_list(parser, field);
+    parser->generation++;
+    return true;
+}
 
-    // Set appropriate vector type based on size
-    value->type = (fld_value_type)(FLD_VALUE_VEC2 + vec_size - 2);
+bool fld_array_append(fld_parser *parser, const char *path, const fld_value *item) {
+    switch (item->type) {
+        case FLD_VALUE_STRING:
+        case FLD_VALUE_INT:
+        case FLD_VALUE_INT64:
+        case FLD_VALUE_FLOAT:
+        case FLD_VALUE_BOOL:
+            break;
+        default:
+            return false;
+    }
 
-    // Parse the components (they can only be float!)
-    // Here, we are casting to the first vec size in the union
-    // so we can get all the others from this address
-    float *components = (float*)&value->as.vec2;
-    for (int i = 0; i < vec_size; ++i) {
-        // Check for comma between components (except first)
-        if (i > 0 && !_parser_expect(parser, TOKEN_COMMA, FLD_ERROR_UNEXPECTED_TOKEN)) {
-            return NULL;
+    // The string first, nothing is changed if it doesn't fit
+    fld_value value = *item;
+    if (value.type == FLD_VALUE_STRING) {
+        value.as.string.start = _edit_copy_string(parser, item->as.string.start, (size_t)item->as.string.length);
+        if (!value.as.string.start) return false;
+    }
+    if (value.type == FLD_VALUE_INT64 && _fits_int(value.as.int64)) {
+        value.type = FLD_VALUE_INT;
+        value.as.integer = (int)item->as.int64;
+    }
+
+    fld_object *field = fld_get_field_by_path(parser->root, path);
+    if (!field) {
+        field = _edit_field(parser, path);
+        if (!field) return false;
+        memset(&field->value.as, 0, sizeof(field->value.as));
+        field->value.type = FLD_VALUE_ARRAY;
+        field->value.as.array.type = FLD_VALUE_EMPTY;
+    }
+    if (field->value.type != FLD_VALUE_ARRAY) return false;
+
+    fld_value *array = &field->value;
+    size_t count = (size_t)array->as.array.count;
+    if (_array_is_full(count)) return false;
+
+    fld_value_type type = array->as.array.type;
+    if (type == FLD_VALUE_EMPTY) {
+        type = value.type;
+    } else if (value.type == FLD_VALUE_INT && type == FLD_VALUE_INT64) {
+        value.type = FLD_VALUE_INT64;
+        value.as.int64 = value.as.integer;
+    } else if (value.type != type && !(value.type == FLD_VALUE_INT64 && type == FLD_VALUE_INT)) {
+        return false;
+    }
+
+    fld_bump_allocator *alloc = &parser->allocator;
+    uint8_t *run = (uint8_t*)array->as.array.items;
+    size_t size = _get_type_size(type);
+    size_t align = _get_type_alignment(type);
+
+    if (value.type == FLD_VALUE_INT64 && type == FLD_VALUE_INT) {
+        // Widened into a fresh run on top of the arena, like _array_widen
+        int64_t *wide = (int64_t*)_edit_alloc(parser, count * sizeof(int64_t), ALIGNOF(int64_t));
+        if (!wide) return false;
+        for (size_t i = 0; i < count; ++i) {
+            wide[i] = ((const int*)run)[i];
         }
+        FLD_STAT(parser->stats.array_widenings++);
+        type = FLD_VALUE_INT64;
+        size = sizeof(int64_t);
+        align = ALIGNOF(int64_t);
+        run = (uint8_t*)wide;
+    } else if (!run || run + count * size != alloc->current) {
+        // Only the run at the top of the arena can grow in place
+        uint8_t *moved = (uint8_t*)_edit_alloc(parser, count * size, align);
+        if (!moved) return false;
+        if (count > 0) memcpy(moved, run, count * size);
+        run = moved;
+    }
 
-        // Each component must be a number (int or float)
-        if (parser->current->type != TOKEN_INT && parser->current->type != TOKEN_FLOAT) {
-            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
-            return NULL;
+    void *slot = _bump_extend(alloc, &run, size, align);
+    if (!slot) {
+        _edit_error(parser, FLD_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    _store_array_item(parser, slot, &value);
+    FLD_STAT(parser->stats.array_items++);
+    FLD_STAT(parser->stats.item_bytes += size);
+
+    array->as.array.type = type;
+    array->as.array.items = run;
+    array->as.array.count = (int)count + 1;
+    _edit_touch(field);
+    return true;
+}
+
+void fld_overlay_init(fld_overlay *overlay, fld_overlay_entry *cache, uint32_t capacity) {
+    memset(overlay, 0, sizeof(fld_overlay));
+
+    uint32_t usable = 0;
+    if (cache && capacity > 0) {
+        usable = 1;
+        while (usable <= capacity / 2) {
+            usable <<= 1;
         }
+        memset(cache, 0, usable * sizeof(fld_overlay_entry));
+    }
+    overlay->cache = usable ? cache : NULL;
+    overlay->cache_capacity = usable;
+}
 
-        // Store the component value (convert to float from int if needed)
-        components[i] = (parser->current->type == TOKEN_INT)
-            ? (float)parser->current->value.integer
-            : (float)parser->current->value.float_val;
+bool fld_overlay_push(fld_overlay *overlay, fld_parser *parser) {
+    if (overlay->layer_count >= FLD_OVERLAY_MAX_LAYERS) return false;
 
-        _parser_advance(parser);
+    overlay->layers[overlay->layer_count] = parser;
+    overlay->generations[overlay->layer_count] = parser->generation;
+    overlay->layer_count++;
+
+    // A new top layer can hide anything that was resolved so far
+    if (overlay->cache) {
+        memset(overlay->cache, 0, overlay->cache_capacity * sizeof(fld_overlay_entry));
     }
+    return true;
+}
 
-    // Expect closing parenthesis
-    if (!_parser_expect(parser, TOKEN_PAREN_RIGHT, FLD_ERROR_UNEXPECTED_TOKEN)) {
-        return NULL;
+// Empties the cache once any layer parsed something new
+static void _overlay_check_cache(fld_overlay *overlay) {
+    bool stale = false;
+    for (int i = 0; i < overlay->layer_count; ++i) {
+        if (overlay->generations[i] != overlay->layers[i]->generation) {
+            overlay->generations[i] = overlay->layers[i]->generation;
+            stale = true;
+        }
+    }
+    if (stale) {
+        memset(overlay->cache, 0, overlay->cache_capacity * sizeof(fld_overlay_entry));
     }
+}
 
-    return value;
+static void _overlay_top(const fld_overlay *overlay, fld_overlay_level *level) {
+    level->count = 0;
+    for (int i = overlay->layer_count - 1; i >= 0; --i) {
+        if (overlay->layers[i]->root) {
+            level->lists[level->count++] = overlay->layers[i]->root;
+        }
+    }
 }
 
-static fld_value *_parse_value(fld_parser *parser, fld_object *parent) {
-    // For objects and arrays we'll just use their appropriate parse functions
-    if (parser->current->type == TOKEN_BRACE_LEFT) {
-        return _parse_object(parser, parent);
+// Finds a key on a level. Returns the topmost layer's field and, when that
+// is an object, fills `child` with the levels below it down to the first
+// layer where the key is something else.
+static fld_object *_overlay_descend(const fld_overlay_level *level, const char *key, int length, uint32_t hash, fld_overlay_level *child) {
+    fld_object *found = NULL;
+    if (child) {
+        child->count = 0;
     }
-    if (parser->current->type == TOKEN_BRACKET_LEFT) {
-        return _parse_array(parser, parent);
+
+    for (int i = 0; i < level->count; ++i) {
+        fld_object *field = _find_field_hashed(level->lists[i], key, length, hash);
+        if (!field) continue;
+
+        if (!found) {
+            found = field;
+        }
+        if (field->value.type != FLD_VALUE_OBJECT || !child) break;
+        if (_value_object(&field->value)) {
+            child->lists[child->count++] = field->value.as.object;
+        }
     }
-    
-    // For primitive types allocate and init a value
-    fld_value *value = (fld_value*)_bump_alloc(&parser->allocator, sizeof(fld_value), ALIGNOF(fld_value));
-    if (!value) {
-        _parser_error(parser, FLD_ERROR_OUT_OF_MEMORY);
-        return NULL;
+    return found;
+}
+
+// Walks the segments of a path down the levels, `level` ends up below the
+// last one. Empty segments are skipped like everywhere else.
+static fld_object *_overlay_resolve(const fld_overlay *overlay, const char *path, fld_overlay_level *level) {
+    _overlay_top(overlay, level);
+
+    fld_object *field = NULL;
+    const char *segment = path;
+    while (true) {
+        while (*segment == '.') {
+            segment++;
+        }
+        if (!*segment) return field;
+
+        const char *end = segment;
+        while (*end && *end != '.') {
+            end++;
+        }
+        if (field && field->value.type != FLD_VALUE_OBJECT) return NULL;
+
+        fld_overlay_level below;
+        int length = (int)(end - segment);
+        field = _overlay_descend(level, segment, length, fld_hash_key(segment, length), &below);
+        if (!field) return NULL;
+        *level = below;
+        segment = end;
     }
+}
 
-    // Init the structure to zero for safety
-    memset(value, 0, sizeof(fld_value));
+// Whether the keys from a field up to the top level spell out the path
+static bool _field_has_path(const fld_object *field, const char *path, size_t length) {
+    const char *end = path + length;
+    while (true) {
+        while (end > path && end[-1] == '.') {
+            end--;
+        }
+        if (end == path) return field == NULL;
+        if (!field) return false;
 
-    switch (parser->current->type) {
-        case TOKEN_STRING: {
-            // Validate string view
-            if (parser->current->value.string.length > 0 &&
-                parser->current->value.string.start != NULL) {
-                value->type = FLD_VALUE_STRING;
-                value->as.string = parser->current->value.string;
-                _parser_advance(parser);
-                return value;
-            }
-            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
-            return NULL;
+        const char *start = end;
+        while (start > path && start[-1] != '.') {
+            start--;
+        }
+        if (field->key.length != (int)(end - start) || memcmp(field->key.start, start, end - start) != 0) {
+            return false;
         }
+        field = field->parent;
+        end = start;
+    }
+}
 
-        case TOKEN_INT: {
-            value->type = FLD_VALUE_INT;
-            value->as.integer = parser->current->value.integer;
-            _parser_advance(parser);
-            return value;
+fld_object *fld_overlay_get(fld_overlay *overlay, const char *path) {
+    if (!path || !*path) return NULL;
+
+    fld_overlay_entry *entry = NULL;
+    size_t length = strlen(path);
+    uint32_t hash = 0;
+    if (overlay->cache) {
+        _overlay_check_cache(overlay);
+
+        hash = fld_hash_key(path, length);
+        entry = &overlay->cache[hash & (overlay->cache_capacity - 1)];
+        if (entry->field && entry->hash == hash && _field_has_path(entry->field, path, length)) {
+            return entry->field;
         }
+    }
 
-        case TOKEN_FLOAT: {
-            value->type = FLD_VALUE_FLOAT;
-            value->as.float_val = parser->current->value.float_val;
-            _parser_advance(parser);
-            return value;
+    fld_overlay_level level;
+    fld_object *field = _overlay_resolve(overlay, path, &level);
+    if (field && entry) {
+        entry->hash = hash;
+        entry->field = field;
+    }
+    return field;
+}
+
+static void _overlay_iter_begin(fld_overlay_iter *iter, const fld_overlay_level *level) {
+    iter->level = *level;
+    iter->list = level->count - 1;
+    iter->next = iter->list >= 0 ? level->lists[iter->list] : NULL;
+}
+
+void fld_overlay_iter_init(fld_overlay_iter *iter, fld_overlay *overlay, const char *path) {
+    fld_overlay_level level;
+    if (!path || !*path) {
+        _overlay_top(overlay, &level);
+    } else {
+        fld_object *field = _overlay_resolve(overlay, path, &level);
+        if (!field || field->value.type != FLD_VALUE_OBJECT) {
+            level.count = 0;
         }
+    }
+    _overlay_iter_begin(iter, &level);
+}
 
-        case TOKEN_BOOL: {
-            value->type = FLD_VALUE_BOOL;
-            value->as.boolean = parser->current->value.boolean;
-            _parser_advance(parser);
-            return value;
+fld_object *fld_overlay_iter_next(fld_overlay_iter *iter) {
+    while (iter->list >= 0) {
+        fld_object *field = iter->next;
+        if (!field) {
+            // On to the layer above
+            iter->list--;
+            iter->next = iter->list >= 0 ? iter->level.lists[iter->list] : NULL;
+            continue;
         }
+        iter->next = field->next;
 
-        case TOKEN_VEC: {
-            return _parse_vec(parser, parent);
+        // Keys a lower layer has were visited with it
+        uint32_t hash = fld_hash_key(field->key.start, field->key.length);
+        bool seen = false;
+        for (int i = iter->list + 1; i < iter->level.count && !seen; ++i) {
+            seen = _find_field_hashed(iter->level.lists[i], field->key.start, field->key.length, hash) != NULL;
         }
+        if (seen) continue;
 
-        default: {
-            _parser_error(parser, FLD_ERROR_UNEXPECTED_TOKEN);
-            return NULL;
+        // The topmost layer with the key wins
+        for (int i = 0; i < iter->list; ++i) {
+            fld_object *top = _find_field_hashed(iter->level.lists[i], field->key.start, field->key.length, hash);
+            if (top) return top;
         }
+        return field;
     }
-
-    // Should never reach here
     return NULL;
 }
 
-static fld_object *_parse_field(fld_parser *parser, fld_object *parent) {
-    // Allocate new object
-    fld_object *obj = (fld_object*)_bump_alloc(&parser->allocator, sizeof(fld_object), ALIGNOF(fld_object));
-    if (!obj) {
-        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
-        return NULL;
+// Flattening walks the merged levels the way the compact walks go over lists
+static void _flatten_count(const fld_overlay_level *level, fld_compact_counts *counts) {
+    fld_overlay_iter iter;
+    _overlay_iter_begin(&iter, level);
+    for (fld_object *field; (field = fld_overlay_iter_next(&iter)) != NULL;) {
+        _compact_count_field(field, counts);
+        if (field->value.type == FLD_VALUE_OBJECT) {
+            fld_overlay_level below;
+            _overlay_descend(level, field->key.start, field->key.length, fld_hash_key(field->key.start, field->key.length), &below);
+            _flatten_count(&below, counts);
+        }
     }
+}
 
-    memset(obj, 0, sizeof(fld_object));
-
-    // Null initialize links
-    obj->next = NULL;
-    obj->parent = parent;
+static uint32_t _flatten_fill(const fld_overlay_level *level, uint32_t parent, fld_compact_tree *tree, fld_compact_counts *filled) {
+    uint32_t previous = FLD_COMPACT_NONE;
+    uint32_t count = 0;
 
-    // Store the key
-    obj->key = parser->current->value.string;
+    fld_overlay_iter iter;
+    _overlay_iter_begin(&iter, level);
+    for (fld_object *field; (field = fld_overlay_iter_next(&iter)) != NULL;) {
+        uint32_t node = _compact_fill_field(field, parent, tree, filled);
+        if (previous != FLD_COMPACT_NONE) {
+            tree->next[previous] = node;
+        }
+        previous = node;
+        count++;
 
-    // Consume key
-    _parser_advance(parser);
-    
-    // Expect the equals sign
-    _parser_consume(parser, TOKEN_EQUALS, FLD_ERROR_UNEXPECTED_TOKEN);
-    if (parser->last_error.code != FLD_ERROR_NONE) {
-        return NULL;
+        if (field->value.type == FLD_VALUE_OBJECT) {
+            fld_overlay_level below;
+            _overlay_descend(level, field->key.start, field->key.length, fld_hash_key(field->key.start, field->key.length), &below);
+            tree->payloads[node].children = _flatten_fill(&below, node, tree, filled);
+        }
     }
+    return count;
+}
 
-    // Now parse the value
-    fld_value *value = _parse_value(parser, obj);
-    if (!value) {
-        // TODO: error?
-        return NULL;
-    }
+size_t fld_flatten_size(fld_overlay *overlay) {
+    fld_overlay_level top;
+    _overlay_top(overlay, &top);
 
-    // Store the value
-    obj->value = *value;
+    fld_compact_counts counts = {0, 0, 0};
+    _flatten_count(&top, &counts);
+    return _compact_bytes(&counts);
+}
 
-    // Expect the semicolon
-    _parser_consume(parser, TOKEN_SEMICOLON, FLD_ERROR_UNEXPECTED_TOKEN);
-    if (parser->last_error.code != FLD_ERROR_NONE) {
-        return NULL;
-    }
+bool fld_flatten(fld_overlay *overlay, void *memory, size_t size, fld_compact_tree *out) {
+    memset(out, 0, sizeof(fld_compact_tree));
 
-    return obj;
+    fld_overlay_level top;
+    _overlay_top(overlay, &top);
+
+    fld_compact_counts counts = {0, 0, 0};
+    _flatten_count(&top, &counts);
+    if (!_compact_begin(&counts, memory, size, out)) return false;
+
+    fld_compact_counts filled = {0, 0, 0};
+    _flatten_fill(&top, FLD_COMPACT_NONE, out, &filled);
+    return true;
 }
 
-bool fld_parse(fld_parser *parser, const char *source, void *memory, size_t size) {
-    // Set up parser
-    parser->root = NULL;
-    parser->last_error.code = FLD_ERROR_NONE;
-    parser->last_error.line = 1;
-    parser->last_error.column = 1;
-    
-    // Calculate memory needed and if enought was passed in or not...
-    size_t string_length;
-    size_t needed = _estimate_memory_needed(source, &string_length);
-    if (size < needed) {
-        parser->last_error.code = FLD_ERROR_INSUFFICIENT_MEMORY;
-        return false;
+bool fld_string_view_to_cstr(fld_string_view str_view, char *buffer, size_t buffer_size) {
+    if (buffer_size <= str_view.length) return false;
+    memcpy(buffer, str_view.start, str_view.length);
+    buffer[str_view.length] = '\0';
+    return true;
+}
+
+bool fld_string_view_eq(fld_string_view str_view, const char* cstr) {
+    size_t cstr_len = strlen(cstr);
+    if (cstr_len != str_view.length) return false;
+    return memcmp(str_view.start, cstr, str_view.length) == 0;
+}
+
+void fld_parser_set_allocator(fld_parser *parser, const fld_chunk_allocator *allocator) {
+    if (allocator) {
+        parser->allocator.backing = *allocator;
+    } else {
+        memset(&parser->allocator.backing, 0, sizeof(fld_chunk_allocator));
     }
+}
 
-    // Init bump allocator
-    _bump_init(&parser->allocator, memory, size);
+void fld_parser_release(fld_parser *parser) {
+    _bump_release(&parser->allocator);
+    parser->root = NULL;
+}
 
-    // Copy source text so it does not get invalidated
-    parser->source = (char*)_bump_alloc(&parser->allocator, string_length + 1, ALIGNOF(char));
-    if (!parser->source) {
-        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
-        return false;
+void fld_parser_reset(fld_parser *parser) {
+    fld_bump_allocator *alloc = &parser->allocator;
+    _bump_note_peak(alloc);
+
+    // Every chunk in use joins the spare ones
+    if (alloc->chunks) {
+        fld_chunk *oldest = alloc->chunks;
+        while (oldest->prev) {
+            oldest = oldest->prev;
+        }
+        oldest->prev = alloc->spare;
+        alloc->spare = alloc->chunks;
+        alloc->chunks = NULL;
     }
 
-    memcpy(parser->source, source, string_length + 1);
-    // Null terminate it
-    parser->source[string_length] = '\0';
+    alloc->start = alloc->base;
+    alloc->current = alloc->base;
+    alloc->end = alloc->base_end;
+    alloc->retired = 0;
 
-    // Set up the lexer
-    parser->lexer.start = parser->source;
-    parser->lexer.current = parser->source;
-    parser->lexer.line = 1;
-    parser->lexer.column = 1;
+    // Bindings have to resolve again
+    _parser_begin(parser);
+    parser->source = NULL;
+    parser->source_length = 0;
+}
 
-    // Get the first token
-    parser->current = _lexer_scan_token(parser);
-    parser->previous = NULL;
+bool fld_parse_reuse(fld_parser *parser, const char *source, size_t length, uint32_t flags) {
+    fld_parser_reset(parser);
+    return _parse_source(parser, source, length, flags);
+}
 
-    fld_object *last = NULL;
+bool fld_measure(const char *source, size_t length, uint32_t flags, fld_measurement *out) {
+    memset(out, 0, sizeof(fld_measurement));
 
-    // Parse all top-level fields
-    while (parser->current->type != TOKEN_EOF) {
-        // Everything starts with a key...
-        if (parser->current->type != TOKEN_KEY) {
-            parser->last_error.code = FLD_ERROR_UNEXPECTED_TOKEN;
-            parser->last_error.line = parser->current->line;
-            parser->last_error.column = parser->current->column;
-            
-            return false;
-        }
+    fld_parser parser;
+    _parser_begin_lexing(&parser, source, length);
 
-        // Parse field -- top level has no parent (like batman)
-        fld_object *field = _parse_field(parser, NULL);
-        if (!field) {
-            // TODO: error?
-            return false;
-        }
+    if (!(flags & FLD_PARSE_BORROW_SOURCE)) {
+        _measure_alloc(out, length + 1, ALIGNOF(char));
+    }
 
-        // If this is the first, make it root
-        if (!parser->root) {
-            parser->root = field;
-        } else {
-            last->next = field;
-        }
+    uint32_t count = 0;
+    while (parser.current->type != TOKEN_EOF) {
+        if (!_measure_field(&parser, out)) break;
+        count++;
+    }
 
-        last = field;
+    if (parser.last_error.code == FLD_ERROR_NONE) {
+        _measure_index(out, count);
     }
 
-    return parser->last_error.code == FLD_ERROR_NONE;
+    if (flags & FLD_PARSE_LAZY_OBJECTS) {
+        // Every object gets a body record, and expanding bodies in any order
+        // can move each aligned allocation (fields, item runs and their
+        // int64 copies, indexes) by up to its alignment
+        size_t padding = ALIGNOF(fld_object) - 1;
+        out->bytes += out->objects * (sizeof(fld_lazy_body) + ALIGNOF(fld_lazy_body) - 1);
+        out->bytes += (out->fields + 2 * out->arrays + out->indexes) * padding;
+    }
+
+    out->error = parser.last_error;
+    return out->error.code == FLD_ERROR_NONE;
 }
 
-fld_object *fld_get_field(fld_object *object, const char *path) {
-    fld_object *current = object;
-    int key_len = strlen(path);
+// Writing. Everything goes through _writer_put, which copies into `out` and
+// flushes the callback's buffer when it is full.
+static void _writer_put(fld_writer *writer, const char *text, size_t length) {
+    writer->length += length;
+    if (writer->failed) return;
+
+    if (writer->write) {
+        if (writer->used + length > writer->capacity) {
+            if (writer->used > 0 && !writer->write(writer->user, writer->out, writer->used)) {
+                writer->failed = true;
+                return;
+            }
+            writer->used = 0;
 
-    while (current) {
-        if (current->key.length == key_len &&
-            memcmp(current->key.start, path, key_len) == 0) {
-            return current;
+            // Too big to be worth buffering
+            if (length > writer->capacity) {
+                if (!writer->write(writer->user, text, length)) writer->failed = true;
+                return;
+            }
         }
-        current = current->next;
+        memcpy(writer->out + writer->used, text, length);
+        writer->used += length;
+        return;
+    }
+
+    size_t room = writer->capacity - writer->used;
+    size_t copied = length < room ? length : room;
+    if (copied > 0) {
+        memcpy(writer->out + writer->used, text, copied);
+        writer->used += copied;
     }
-    return NULL;
 }
 
-fld_object *fld_get_field_by_path(fld_object *object, const char *path) {
-    // Empty or NULL path
-    if (!path || !*path) {
-        return NULL;
+static inline void _writer_put_char(fld_writer *writer, char c) {
+    _writer_put(writer, &c, 1);
+}
+
+static const char _fld_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Writes the digits of `value` ending right before `end`, two at a time.
+// Returns where they start.
+static char *_format_digits(char *end, uint64_t value) {
+    while (value >= 100) {
+        end -= 2;
+        memcpy(end, &_fld_digit_pairs[(value % 100) * 2], 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        end -= 2;
+        memcpy(end, &_fld_digit_pairs[value * 2], 2);
+    } else {
+        *--end = (char)('0' + value);
     }
+    return end;
+}
 
-    // Make a copy of the path
-    char path_copy[FLD_MAX_PATH_LENGTH];
-    strcpy(path_copy, path);
+static size_t _format_int(char *out, int64_t value) {
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    char *start = _format_digits(end, magnitude);
+    if (value < 0) *--start = '-';
 
-    fld_object *current = object;
-    char *token = strtok(path_copy, ".");
-    char *next_token;
+    size_t length = (size_t)(end - start);
+    memcpy(out, start, length);
+    return length;
+}
 
-    while (token) {
-        // Get the next token to see if we're at the final part
-        next_token = strtok(NULL, ".");
+// 10^-46 to 10^53, enough to scale every float to up to nine digits.
+// Only used for first guesses, the digits are checked exactly by
+// _decimal_to_float_bits.
+#define FLD_POW10_MIN (-46)
+static const double _fld_pow10[] = {
+    1e-46, 1e-45, 1e-44, 1e-43, 1e-42, 1e-41, 1e-40, 1e-39,
+    1e-38, 1e-37, 1e-36, 1e-35, 1e-34, 1e-33, 1e-32, 1e-31,
+    1e-30, 1e-29, 1e-28, 1e-27, 1e-26, 1e-25, 1e-24, 1e-23,
+    1e-22, 1e-21, 1e-20, 1e-19, 1e-18, 1e-17, 1e-16, 1e-15,
+    1e-14, 1e-13, 1e-12, 1e-11, 1e-10, 1e-9, 1e-8, 1e-7,
+    1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1,
+    1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+    1e18, 1e19, 1e20, 1e21, 1e22, 1e23, 1e24, 1e25,
+    1e26, 1e27, 1e28, 1e29, 1e30, 1e31, 1e32, 1e33,
+    1e34, 1e35, 1e36, 1e37, 1e38, 1e39, 1e40, 1e41,
+    1e42, 1e43, 1e44, 1e45, 1e46, 1e47, 1e48, 1e49,
+    1e50, 1e51, 1e52, 1e53
+};
+
+static const uint64_t _fld_pow10_int[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// The shortest decimal that reads back as `value`, as digits and the power
+// of ten of the first one. Tries one to nine digits: the closest decimal
+// with that many is the only candidate, and nine always round-trip.
+static int _float_shortest(float value, uint64_t *out_digits, int *out_point) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits &= 0x7FFFFFFFu;
+    double magnitude = (double)value < 0 ? -(double)value : (double)value;
+
+    // Power of ten of the first digit, from the binary exponent and then
+    // corrected against the table
+    int exponent2 = (int)(bits >> 23) - 127;
+    if ((bits >> 23) == 0) exponent2 = -127 - 22;
+    int point = (int)((exponent2 * 78913L) >> 18);
+    if (point < FLD_POW10_MIN) point = FLD_POW10_MIN;
+    while (point > FLD_POW10_MIN && magnitude < _fld_pow10[point - FLD_POW10_MIN]) point--;
+    while (magnitude >= _fld_pow10[point + 1 - FLD_POW10_MIN]) point++;
+
+    for (int n = 1; n <= 9; ++n) {
+        int scale = n - 1 - point;
+        double scaled = magnitude * _fld_pow10[scale - FLD_POW10_MIN];
+        uint64_t digits = (uint64_t)(scaled + 0.5);
+        int first = point;
+        if (digits >= _fld_pow10_int[n]) {
+            digits /= 10;
+            first++;
+        }
 
-        // Find the field
-        fld_object *field = fld_get_field(current, token);
-        if (!field) {
-            return NULL;
+        // Nine digits are kept even if the check disagrees, they are as
+        // close as a decimal that long gets
+        uint32_t decoded;
+        if (n == 9 || (digits > 0 && _decimal_to_float_bits(digits, first - n + 1, &decoded) && decoded == bits)) {
+            *out_digits = digits;
+            *out_point = first;
+            return n;
         }
+    }
+    return 9;
+}
 
-        if (next_token) {
-            // If there are more tokens, this must be an object
-            if (field->value.type != FLD_VALUE_OBJECT) {
-                return NULL;
-            }
-            current = field->value.as.object;
+// Writes a finite float so that the lexer reads it back as the same float,
+// always with a '.' or an exponent so it stays a float
+static size_t _format_float(char *out, float value) {
+    char *p = out;
+    if (value < 0 || (value == 0 && 1.0f / value < 0)) *p++ = '-';
+    if (value == 0) {
+        memcpy(p, "0.0", 3);
+        return (size_t)(p - out) + 3;
+    }
+
+    uint64_t digits = 0;
+    int point = 0;
+    int n = _float_shortest(value, &digits, &point);
+
+    char text[10];
+    char *end = text + n;
+    _format_digits(end, digits);
+
+    if (point >= 0 && point < 9) {
+        // 123.45, 12300.0
+        if (point + 1 >= n) {
+            memcpy(p, text, (size_t)n);
+            p += n;
+            for (int i = n; i <= point; ++i) *p++ = '0';
+            memcpy(p, ".0", 2);
+            p += 2;
         } else {
-            // Last token - this is our target field
-            fld_object *result = field;
-            return result;
+            memcpy(p, text, (size_t)point + 1);
+            p += point + 1;
+            *p++ = '.';
+            memcpy(p, text + point + 1, (size_t)(n - point - 1));
+            p += n - point - 1;
         }
-        token = next_token;
+    } else if (point < 0 && point >= -5) {
+        // 0.00123
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = -1; i > point; --i) *p++ = '0';
+        memcpy(p, text, (size_t)n);
+        p += n;
+    } else {
+        // 1.5e-7, 1e20
+        *p++ = text[0];
+        if (n > 1) {
+            *p++ = '.';
+            memcpy(p, text + 1, (size_t)n - 1);
+            p += n - 1;
+        }
+        *p++ = 'e';
+        p += _format_int(p, point);
     }
-
-    return NULL;
+    return (size_t)(p - out);
 }
 
-bool fld_get_str_view(fld_object *object, const char *path, fld_string_view *str_view) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_STRING) {
+static bool _writer_float(fld_writer *writer, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7F800000u) == 0x7F800000u) {
+        // Infinity and NaN have no FLD spelling
+        writer->failed = true;
         return false;
     }
-    str_view->start = field->value.as.string.start;
-    str_view->length = field->value.as.string.length;
+
+    char text[24];
+    _writer_put(writer, text, _format_float(text, value));
     return true;
 }
 
-bool fld_get_cstr(fld_object *object, const char *path, char *buffer, size_t buffer_size) {
-    fld_string_view str_view;
+static void _writer_int(fld_writer *writer, int64_t value) {
+    char text[24];
+    _writer_put(writer, text, _format_int(text, value));
+}
 
-    // Validate input
-    if (!buffer || buffer_size == 0) return false;
-    
-    // Try to get string view first
-    if (!fld_get_str_view(object, path, &str_view)) {
-        // Null terminate on failure
-        buffer[0] = '\0';
-        return false;
+// Quotes a string, escaping quotes, backslashes and control characters.
+// Runs without any of those are copied in one go.
+static void _writer_string(fld_writer *writer, fld_string_view string) {
+    _writer_put_char(writer, '"');
+
+    const char *p = string.start;
+    const char *end = p + string.length;
+    const char *run = p;
+    for (; p < end; ++p) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        _writer_put(writer, run, (size_t)(p - run));
+        run = p + 1;
+
+        char escape[6] = {'\\', 0};
+        switch (c) {
+            case '"': escape[1] = '"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            default:
+                memcpy(escape + 1, "u00", 3);
+                escape[4] = "0123456789abcdef"[c >> 4];
+                escape[5] = "0123456789abcdef"[c & 0xF];
+                _writer_put(writer, escape, 6);
+                continue;
+        }
+        _writer_put(writer, escape, 2);
     }
+    _writer_put(writer, run, (size_t)(p - run));
 
-    // Check if buffer is large enough plus null terminator
-    if (str_view.length >= buffer_size) {
-        buffer[0] = '\0';
-        return false;
+    _writer_put_char(writer, '"');
+}
+
+static void _writer_newline(fld_writer *writer, int depth) {
+    static const char spaces[] = "                                ";
+    _writer_put_char(writer, '\n');
+
+    size_t indent = (size_t)depth * FLD_WRITE_INDENT;
+    while (indent > 0) {
+        size_t n = indent < sizeof(spaces) - 1 ? indent : sizeof(spaces) - 1;
+        _writer_put(writer, spaces, n);
+        indent -= n;
     }
+}
 
-    memcpy(buffer, str_view.start, str_view.length);
-    buffer[str_view.length] = '\0';
-    return true;
+// Ends a field after its value
+static void _writer_field_end(fld_writer *writer) {
+    _writer_put_char(writer, ';');
+    writer->separate = true;
 }
 
-bool fld_get_int(fld_object *object, const char *path, int *out_value) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_INT) {
-        return false;
-    }
-    *out_value = field->value.as.integer;
-    return true;
+void fld_writer_init(fld_writer *writer, char *buffer, size_t size, uint32_t flags) {
+    memset(writer, 0, sizeof(*writer));
+    writer->out = buffer;
+    // One byte is kept for the terminator
+    writer->capacity = (buffer && size > 0) ? size - 1 : 0;
+    writer->flags = flags;
 }
 
-bool fld_get_float(fld_object *object, const char *path, float *out_value) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_FLOAT) {
-        return false;
-    }
-    *out_value = field->value.as.float_val;
-    return true;
+void fld_writer_init_callback(fld_writer *writer, fld_write_fn write, void *user, uint32_t flags) {
+    memset(writer, 0, sizeof(*writer));
+    writer->out = writer->buffer;
+    writer->capacity = sizeof(writer->buffer);
+    writer->write = write;
+    writer->user = user;
+    writer->flags = flags;
 }
 
-bool fld_get_bool(fld_object *object, const char *path, bool *out_value) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_BOOL) {
-        return false;
+bool fld_write_key(fld_writer *writer, fld_string_view key) {
+    if (writer->separate) {
+        if (writer->flags & FLD_WRITE_SINGLE_LINE) {
+            _writer_put_char(writer, ' ');
+        } else {
+            _writer_newline(writer, writer->depth);
+        }
     }
-    *out_value = field->value.as.boolean;
-    return true;
+    writer->separate = false;
+    writer->open = false;
+
+    _writer_put(writer, key.start, (size_t)key.length);
+    _writer_put(writer, " = ", 3);
+    return !writer->failed;
 }
 
-bool fld_get_array(fld_object *object, const char *path, fld_value_type *out_type, void** out_items, size_t* out_count) {
-    fld_object* field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_ARRAY) {
-        return false;
+bool fld_write_object_begin(fld_writer *writer) {
+    _writer_put_char(writer, '{');
+    writer->depth++;
+    writer->separate = true;
+    writer->open = true;
+    return !writer->failed;
+}
+
+bool fld_write_object_end(fld_writer *writer) {
+    if (writer->depth > 0) writer->depth--;
+    if (!writer->open) {
+        if (writer->flags & FLD_WRITE_SINGLE_LINE) {
+            _writer_put_char(writer, ' ');
+        } else {
+            _writer_newline(writer, writer->depth);
+        }
     }
-    *out_type = field->value.as.array.type;
-    *out_items = field->value.as.array.items;
-    *out_count = field->value.as.array.count;
-    return true;
+    writer->open = false;
+
+    _writer_put_char(writer, '}');
+    _writer_field_end(writer);
+    return !writer->failed;
 }
 
-bool fld_get_vec2(fld_object *object, const char *path, float *out_x, float *out_y) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_VEC2) {
-        return false;
+bool fld_write_array_begin(fld_writer *writer) {
+    _writer_put_char(writer, '[');
+    writer->in_array = true;
+    writer->items = 0;
+    return !writer->failed;
+}
+
+bool fld_write_array_end(fld_writer *writer) {
+    _writer_put_char(writer, ']');
+    writer->in_array = false;
+    _writer_field_end(writer);
+    return !writer->failed;
+}
+
+static bool _writer_scalar(fld_writer *writer, const fld_value *value) {
+    switch (value->type) {
+        case FLD_VALUE_STRING:
+            if (value->as.string.length <= 0) {
+                // FLD has no empty strings, `""` wouldn't parse back
+                writer->failed = true;
+                return false;
+            }
+            _writer_string(writer, value->as.string);
+            return true;
+        case FLD_VALUE_INT:
+            _writer_int(writer, value->as.integer);
+            return true;
+        case FLD_VALUE_INT64:
+            _writer_int(writer, value->as.int64);
+            return true;
+        case FLD_VALUE_FLOAT:
+            return _writer_float(writer, value->as.float_val);
+        case FLD_VALUE_BOOL:
+            if (value->as.boolean) _writer_put(writer, "true", 4);
+            else _writer_put(writer, "false", 5);
+            return true;
+        case FLD_VALUE_VEC2:
+        case FLD_VALUE_VEC3:
+        case FLD_VALUE_VEC4: {
+            int count = value->type == FLD_VALUE_VEC2 ? 2 : value->type == FLD_VALUE_VEC3 ? 3 : 4;
+            // The components are laid out one after another in every vecN
+            const float *components = &value->as.vec4.x;
+            _writer_put(writer, "vec", 3);
+            _writer_put_char(writer, (char)('0' + count));
+            _writer_put_char(writer, '(');
+            for (int i = 0; i < count; ++i) {
+                if (i > 0) _writer_put(writer, ", ", 2);
+                if (!_writer_float(writer, components[i])) return false;
+            }
+            _writer_put_char(writer, ')');
+            return true;
+        }
+        default:
+            return true;
     }
-    *out_x = field->value.as.vec2.x;
-    *out_y = field->value.as.vec2.y;
-    return true;
 }
 
-bool fld_get_vec3(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_VEC3) {
-        return false;
+// The items of a parsed array, as the values they were parsed from
+static bool _writer_array_items(fld_writer *writer, const fld_value *array) {
+    const uint8_t *items = (const uint8_t*)array->as.array.items;
+    size_t size = _get_type_size(array->as.array.type);
+
+    for (size_t i = 0; i < (size_t)array->as.array.count; ++i) {
+        fld_value item;
+        item.type = array->as.array.type;
+        const void *slot = items + i * size;
+        switch (item.type) {
+            case FLD_VALUE_STRING: memcpy(&item.as.string, slot, sizeof(fld_string_view)); break;
+            case FLD_VALUE_INT: memcpy(&item.as.integer, slot, sizeof(int)); break;
+            case FLD_VALUE_INT64: memcpy(&item.as.int64, slot, sizeof(int64_t)); break;
+            case FLD_VALUE_FLOAT: memcpy(&item.as.float_val, slot, sizeof(float)); break;
+            case FLD_VALUE_BOOL: memcpy(&item.as.boolean, slot, sizeof(bool)); break;
+            default: memcpy(&item, slot, sizeof(fld_value)); break;
+        }
+        if (!fld_write_value(writer, &item)) return false;
     }
-    *out_x = field->value.as.vec3.x;
-    *out_y = field->value.as.vec3.y;
-    *out_z = field->value.as.vec3.z;
     return true;
 }
 
-bool fld_get_vec4(fld_object *object, const char *path, float *out_x, float *out_y, float *out_z, float *out_w) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_VEC4) {
-        return false;
+bool fld_write_value(fld_writer *writer, const fld_value *value) {
+    if (writer->failed) return false;
+
+    if (value->type == FLD_VALUE_OBJECT) {
+        return fld_write_object_begin(writer) &&
+               fld_write_fields(writer, _value_object(value)) &&
+               fld_write_object_end(writer);
     }
-    *out_x = field->value.as.vec4.x;
-    *out_y = field->value.as.vec4.y;
-    *out_z = field->value.as.vec4.z;
-    *out_w = field->value.as.vec4.w;
-    return true;
+    if (value->type == FLD_VALUE_ARRAY) {
+        return fld_write_array_begin(writer) &&
+               _writer_array_items(writer, value) &&
+               fld_write_array_end(writer);
+    }
+
+    if (writer->in_array && writer->items++ > 0) {
+        _writer_put(writer, ", ", 2);
+    }
+    if (!_writer_scalar(writer, value)) return false;
+    if (!writer->in_array) {
+        _writer_field_end(writer);
+    }
+    return !writer->failed;
 }
 
-bool fld_get_vec_components(fld_object *object, const char *path, float *out_components, size_t* out_count) {
-    fld_object* field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type < FLD_VALUE_VEC2 || field->value.type > FLD_VALUE_VEC4) {
-        return false;
+bool fld_write_fields(fld_writer *writer, const fld_object *first) {
+    for (const fld_object *field = first; field; field = field->next) {
+        if (!fld_write_key(writer, field->key) || !fld_write_value(writer, &field->value)) {
+            return false;
+        }
     }
+    return !writer->failed;
+}
 
-    // Calculate component count from type
-    *out_count = (field->value.type - FLD_VALUE_VEC2) + 2;
+static bool _writer_on_key(void *user, fld_string_view key) {
+    return fld_write_key((fld_writer*)user, key);
+}
 
-    // Copy components using the fact that vectors are contiguous in memory
-    const float *src = (const float*)&field->value.as.vec2;
-    memcpy(out_components, src, *out_count * sizeof(float));
-    return true;
+static bool _writer_on_value(void *user, const fld_value *value) {
+    return fld_write_value((fld_writer*)user, value);
 }
 
-bool fld_get_object(fld_object *object, const char *path, fld_object **out_object) {
-    fld_object* field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_OBJECT) {
-        return false;
-    }
-    *out_object = field->value.as.object;
-    return true;
+static bool _writer_on_object_begin(void *user) {
+    return fld_write_object_begin((fld_writer*)user);
 }
 
-bool fld_has_field(fld_object *object, const char *path) {
-    return fld_get_field_by_path(object, path) != NULL;
+static bool _writer_on_object_end(void *user) {
+    return fld_write_object_end((fld_writer*)user);
 }
 
-fld_value_type fld_get_type(fld_object *object, const char *path) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field) {
-        return FLD_VALUE_EMPTY;
-    }
-    return field->value.type;
+static bool _writer_on_array_begin(void *user) {
+    return fld_write_array_begin((fld_writer*)user);
 }
 
-bool fld_get_array_size(fld_object *object, const char *path, size_t *out_size) {
-    fld_object *field = fld_get_field_by_path(object, path);
-    if (!field || field->value.type != FLD_VALUE_ARRAY) {
-        return false;
+static bool _writer_on_array_end(void *user) {
+    return fld_write_array_end((fld_writer*)user);
+}
+
+fld_event_handler fld_writer_handler(fld_writer *writer) {
+    fld_event_handler handler;
+    handler.user = writer;
+    handler.on_key = _writer_on_key;
+    handler.on_value = _writer_on_value;
+    handler.on_object_begin = _writer_on_object_begin;
+    handler.on_object_end = _writer_on_object_end;
+    handler.on_array_begin = _writer_on_array_begin;
+    handler.on_array_end = _writer_on_array_end;
+    handler.strings = NULL;
+    return handler;
+}
+
+bool fld_writer_finish(fld_writer *writer, size_t *out_length) {
+    // Multi-line text ends with a newline like any text file
+    if (writer->length > 0 && !(writer->flags & FLD_WRITE_SINGLE_LINE)) {
+        _writer_put_char(writer, '\n');
     }
-    *out_size = field->value.as.array.count;
-    return true;
+    if (out_length) *out_length = writer->length;
+
+    if (writer->write) {
+        if (!writer->failed && writer->used > 0 && !writer->write(writer->user, writer->out, writer->used)) {
+            writer->failed = true;
+        }
+        writer->used = 0;
+        return !writer->failed;
+    }
+
+    if (writer->out) {
+        writer->out[writer->used] = '\0';
+    }
+    return !writer->failed && writer->used == writer->length;
 }
 
-bool fld_string_view_to_cstr(fld_string_view str_view, char *buffer, size_t buffer_size) {
-    if (buffer_size <= str_view.length) return false;
-    memcpy(buffer, str_view.start, str_view.length);
-    buffer[str_view.length] = '\0';
-    return true;
+size_t fld_write(const fld_object *root, char *buffer, size_t size, uint32_t flags) {
+    fld_writer writer;
+    fld_writer_init(&writer, buffer, size, flags);
+
+    size_t length = 0;
+    fld_write_fields(&writer, root);
+    fld_writer_finish(&writer, &length);
+    return writer.failed ? 0 : length;
 }
 
-bool fld_string_view_eq(fld_string_view str_view, const char* cstr) {
-    size_t cstr_len = strlen(cstr);
-    if (cstr_len != str_view.length) return false;
-    return memcmp(str_view.start, cstr, str_view.length) == 0;
+bool fld_parse_events(const char *source, size_t length, const fld_event_handler *handler, fld_error *out_error) {
+    fld_parser parser;
+    _parser_begin_lexing(&parser, source, length);
+
+    char strings[FLD_EVENT_STRING_SIZE];
+    _bump_init(&parser.allocator, strings, sizeof(strings));
+    if (handler->strings) {
+        parser.allocator.backing = *handler->strings;
+    }
+
+    bool done = true;
+    while (parser.current->type != TOKEN_EOF) {
+        if (!_events_field(&parser, handler)) {
+            done = false;
+            break;
+        }
+    }
+    _bump_release(&parser.allocator);
+
+    if (out_error) {
+        *out_error = parser.last_error;
+    }
+    return done && parser.last_error.code == FLD_ERROR_NONE;
 }
 
 size_t fld_estimate_memory(const char *source) {
-    size_t len;
-    return _estimate_memory_needed(source, &len);
+    size_t length = strlen(source);
+
+    fld_measurement measurement;
+    if (fld_measure(source, length, FLD_PARSE_DEFAULT, &measurement)) {
+        return measurement.bytes;
+    }
+
+    // Invalid sources still get enough memory to reach their error
+    return _prescan_memory_needed(source, length, FLD_PARSE_DEFAULT);
 }
 
 fld_object *fld_iter_next(fld_iterator *iter) {
@@ -1613,7 +7368,7 @@ fld_object *fld_iter_next(fld_iterator *iter) {
     }
 
     // For recursive, try to go deeper if we have an object
-    if (iter->type == FLD_ITER_RECURSIVE && iter->current->value.type == FLD_VALUE_OBJECT && iter->current->value.as.object) {
+    if (iter->type == FLD_ITER_RECURSIVE && iter->current->value.type == FLD_VALUE_OBJECT && _value_object(&iter->current->value)) {
         // Set current as parent and descend
         iter->parent = iter->current;
         iter->current = iter->current->value.as.object;
@@ -1676,5 +7431,522 @@ bool fld_iter_get_path(fld_iterator *iter, char *buffer, size_t buffer_size) {
     return true;
 }
 
+#ifdef FLD_PARSER_THREADS
+typedef struct {
+    size_t length;
+    size_t index;
+} fld_batch_job;
+
+typedef struct {
+    fld_parser *parsers;
+    const fld_document *documents;
+    const fld_batch_job *jobs;  // Largest document first
+    size_t count;
+    volatile long next;         // Position in `jobs` of the next document to take
+    volatile long failed;
+} fld_batch;
+
+static inline long _atomic_increment(volatile long *value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return InterlockedIncrement(value);
+#else
+    return __atomic_add_fetch(value, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+// Sequentially consistent, which the shared config's epochs rely on
+static inline long _atomic_load(volatile long *value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return InterlockedCompareExchange(value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline void _atomic_store(volatile long *value, long desired) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    InterlockedExchange(value, desired);
+#else
+    __atomic_store_n(value, desired, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline fld_parser *_atomic_load_parser(fld_parser *volatile *value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (fld_parser*)InterlockedCompareExchangePointer((PVOID volatile*)value, NULL, NULL);
+#else
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline fld_parser *_atomic_exchange_parser(fld_parser *volatile *value, fld_parser *desired) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (fld_parser*)InterlockedExchangePointer((PVOID volatile*)value, desired);
+#else
+    return __atomic_exchange_n(value, desired, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Takes documents off the shared queue until it is empty. Documents are
+// independent and coarse, so a single cursor over the sorted order is all
+// the balancing there is to do.
+static void _batch_work(fld_batch *batch) {
+    while (true) {
+        size_t taken = (size_t)(_atomic_increment(&batch->next) - 1);
+        if (taken >= batch->count) return;
+
+        size_t i = batch->jobs[taken].index;
+        const fld_document *document = &batch->documents[i];
+        if (!fld_parse_ex(&batch->parsers[i], document->source, document->length,
+                          document->memory, document->size, document->flags)) {
+            _atomic_increment(&batch->failed);
+        }
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI _batch_thread(LPVOID batch) {
+    _batch_work((fld_batch*)batch);
+    return 0;
+}
+#else
+static void *_batch_thread(void *batch) {
+    _batch_work((fld_batch*)batch);
+    return NULL;
+}
+#endif
+
+static int _batch_compare(const void *a, const void *b) {
+    const fld_batch_job *job_a = (const fld_batch_job*)a;
+    const fld_batch_job *job_b = (const fld_batch_job*)b;
+    if (job_a->length != job_b->length) return job_a->length < job_b->length ? 1 : -1;
+    return job_a->index < job_b->index ? -1 : job_a->index > job_b->index ? 1 : 0;
+}
+
+bool fld_parse_batch(fld_parser *parsers, const fld_document *documents, size_t count, int workers) {
+    if (count == 0) return true;
+
+    fld_batch_job *jobs = (fld_batch_job*)malloc(count * sizeof(fld_batch_job));
+    if (!jobs) {
+        for (size_t i = 0; i < count; ++i) {
+            parsers[i].last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+        }
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        jobs[i].length = documents[i].length;
+        jobs[i].index = i;
+    }
+    // Largest first, so the long parses don't end up last on one worker
+    qsort(jobs, count, sizeof(fld_batch_job), _batch_compare);
+
+    fld_batch batch;
+    batch.parsers = parsers;
+    batch.documents = documents;
+    batch.jobs = jobs;
+    batch.count = count;
+    batch.next = 0;
+    batch.failed = 0;
+
+    size_t threads = workers > 1 ? (size_t)workers - 1 : 0;
+    if (threads > count - 1) threads = count - 1;
+
+#if defined(_WIN32)
+    HANDLE *handles = threads ? (HANDLE*)malloc(threads * sizeof(HANDLE)) : NULL;
+    size_t started = 0;
+    if (handles) {
+        for (; started < threads; ++started) {
+            handles[started] = CreateThread(NULL, 0, _batch_thread, &batch, 0, NULL);
+            if (!handles[started]) break;
+        }
+    }
+#else
+    pthread_t *handles = threads ? (pthread_t*)malloc(threads * sizeof(pthread_t)) : NULL;
+    size_t started = 0;
+    if (handles) {
+        for (; started < threads; ++started) {
+            if (pthread_create(&handles[started], NULL, _batch_thread, &batch) != 0) break;
+        }
+    }
+#endif
+
+    // The calling thread works too, and does everything if no thread started
+    _batch_work(&batch);
+
+    for (size_t i = 0; i < started; ++i) {
+#if defined(_WIN32)
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+
+    free(handles);
+    free(jobs);
+    return batch.failed == 0;
+}
+
+static void *_parallel_chunk_alloc(size_t size, void *user) {
+    (void)user;
+    return malloc(size);
+}
+
+static void _parallel_chunk_free(void *memory, size_t size, void *user) {
+    (void)size;
+    (void)user;
+    free(memory);
+}
+
+// Ranges per worker, a few more than one so uneven ranges even out
+#define FLD_PARALLEL_RANGES_PER_WORKER 4
+
+// Splits the source into at most `count` ranges of whole top-level fields,
+// `ends` receives where each one ends. This scan is sequential, but it only
+// looks at brackets, strings and comments and is much faster than parsing.
+static size_t _parallel_split(const char *source, size_t length, size_t count, const char **ends) {
+    const char *end = source + length;
+    const char *p = source;
+    size_t ranges = 0;
+
+    for (size_t k = 1; k < count; ++k) {
+        const char *target = source + length / count * k;
+        while (p < target) {
+            const char *next = _scan_field_end(p, end);
+            if (!next) {
+                p = end;
+                break;
+            }
+            p = next;
+        }
+        if (p >= end) break;
+        if (ranges > 0 && p == ends[ranges - 1]) continue;
+        ends[ranges++] = p;
+    }
+
+    ends[ranges++] = end;
+    return ranges;
+}
+
+// Moves the chunks of `from` behind those of `to`, newest first as always
+static void _parallel_take_chunks(fld_bump_allocator *to, fld_bump_allocator *from) {
+    if (!from->chunks) return;
+
+    fld_chunk *oldest = from->chunks;
+    while (oldest->prev) {
+        oldest = oldest->prev;
+    }
+    oldest->prev = to->chunks;
+    to->chunks = from->chunks;
+    from->chunks = NULL;
+}
+
+bool fld_parse_parallel(fld_parser *parser, const char *source, size_t length, uint32_t flags, int workers) {
+    _parser_begin(parser);
+    _bump_release(&parser->allocator);
+    _bump_init(&parser->allocator, NULL, 0);
+    parser->source = (flags & FLD_PARSE_BORROW_SOURCE) ? (char*)source : NULL;
+    parser->source_length = length;
+    parser->flags = flags & ~FLD_PARSE_LAZY_OBJECTS;
+
+    if (!parser->allocator.backing.alloc) {
+        parser->allocator.backing.alloc = _parallel_chunk_alloc;
+        parser->allocator.backing.free = _parallel_chunk_free;
+        parser->allocator.backing.user = NULL;
+    }
+
+    size_t wanted = (size_t)(workers > 1 ? workers : 1) * FLD_PARALLEL_RANGES_PER_WORKER;
+    const char **ends = (const char**)malloc(wanted * sizeof(const char*));
+    fld_document *documents = (fld_document*)malloc(wanted * sizeof(fld_document));
+    fld_parser *parsers = (fld_parser*)calloc(wanted, sizeof(fld_parser));
+    if (!ends || !documents || !parsers) {
+        free(ends);
+        free(documents);
+        free(parsers);
+        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+
+    size_t count = _parallel_split(source, length, wanted, ends);
+    const char *start = source;
+    for (size_t i = 0; i < count; ++i) {
+        documents[i].source = start;
+        documents[i].length = (size_t)(ends[i] - start);
+        documents[i].memory = NULL;
+        documents[i].size = 0;
+        // The range parsers go away, nothing can be left for later
+        documents[i].flags = flags & ~FLD_PARSE_LAZY_OBJECTS;
+        parsers[i].allocator.backing = parser->allocator.backing;
+        start = ends[i];
+    }
+
+    bool ok = fld_parse_batch(parsers, documents, count, workers);
+
+    // The first range that failed has the error, moved to whole-source
+    // coordinates with the lines of the ranges before it
+    int lines = 0;
+    for (size_t i = 0; i < count && !ok; ++i) {
+        fld_error error = parsers[i].last_error;
+        if (error.code == FLD_ERROR_NONE) {
+            lines += parsers[i].lexer.line - 1;
+            continue;
+        }
+
+        if (error.line == 1) {
+            const char *line_start = documents[i].source;
+            while (line_start > source && line_start[-1] != '\n') {
+                line_start--;
+            }
+            error.column += (int)(documents[i].source - line_start);
+        }
+        error.line += lines;
+        parser->last_error = error;
+        break;
+    }
+
+    // Every range's chunks go to the parser, the last range's block
+    // becomes the parser's current one
+    fld_object *last = NULL;
+    uint32_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        fld_bump_allocator *alloc = &parsers[i].allocator;
+        if (i + 1 < count) {
+            parser->allocator.retired += fld_get_memory_used(&parsers[i]);
+        } else {
+            parser->allocator.retired += alloc->retired;
+            parser->allocator.start = alloc->start;
+            parser->allocator.current = alloc->current;
+            parser->allocator.end = alloc->end;
+        }
+        _parallel_take_chunks(&parser->allocator, alloc);
+
+        if (!ok || !parsers[i].root) continue;
+
+        // Only the whole list gets an index, built below
+        parsers[i].root->index = NULL;
+        if (last) {
+            last->next = parsers[i].root;
+        } else {
+            parser->root = parsers[i].root;
+        }
+        for (last = parsers[i].root; ; last = last->next) {
+            total++;
+            if (!last->next) break;
+        }
+    }
+
+    free(ends);
+    free(documents);
+    free(parsers);
+
+    if (!ok) {
+        parser->root = NULL;
+        return false;
+    }
+
+    return _index_build(parser, parser->root, total);
+}
+
+// Parses every object a FLD_PARSE_LAZY_OBJECTS parse left for later
+static void _lazy_expand_all(fld_object *first) {
+    for (fld_object *field = first; field; field = field->next) {
+        if (field->value.type == FLD_VALUE_OBJECT) {
+            _lazy_expand_all(_value_object(&field->value));
+        }
+    }
+}
+
+void fld_shared_init(fld_shared_config *shared, fld_parser *parser, fld_shared_release_fn release, void *user) {
+    memset(shared, 0, sizeof(*shared));
+    if (parser) {
+        _lazy_expand_all(parser->root);
+    }
+    shared->release = release;
+    shared->user = user;
+    // Idle slots are 0, so epochs start at 1
+    _atomic_store(&shared->epoch, 1);
+    _atomic_exchange_parser(&shared->current, parser);
+}
+
+fld_parser *fld_shared_acquire(fld_shared_config *shared, int reader) {
+    // Announcing the epoch before loading the parser means a writer that
+    // doesn't see the announcement replaced it before the load, so the
+    // load already gets the new one
+    _atomic_store(&shared->readers[reader], _atomic_load(&shared->epoch));
+    return _atomic_load_parser(&shared->current);
+}
+
+void fld_shared_release(fld_shared_config *shared, int reader) {
+    _atomic_store(&shared->readers[reader], 0);
+}
+
+int fld_shared_reclaim(fld_shared_config *shared) {
+    // The oldest epoch any reader is in, readers that started after a
+    // parser was replaced can't have it
+    long oldest = _atomic_load(&shared->epoch);
+    for (int i = 0; i < FLD_SHARED_MAX_READERS; ++i) {
+        long epoch = _atomic_load(&shared->readers[i]);
+        if (epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+
+    int kept = 0;
+    for (int i = 0; i < shared->retired_count; ++i) {
+        if (shared->retired_epochs[i] <= oldest) {
+            if (shared->release) shared->release(shared->retired[i], shared->user);
+            continue;
+        }
+        shared->retired[kept] = shared->retired[i];
+        shared->retired_epochs[kept] = shared->retired_epochs[i];
+        kept++;
+    }
+    shared->retired_count = kept;
+    return kept;
+}
+
+bool fld_shared_publish(fld_shared_config *shared, fld_parser *parser) {
+    if (fld_shared_reclaim(shared) >= FLD_SHARED_MAX_RETIRED) {
+        return false;
+    }
+
+    if (parser) {
+        _lazy_expand_all(parser->root);
+    }
+    // Only this thread writes the epoch, but the store has to come after
+    // the exchange for every reader
+    fld_parser *old = _atomic_exchange_parser(&shared->current, parser);
+    long epoch = _atomic_load(&shared->epoch) + 1;
+    _atomic_store(&shared->epoch, epoch);
+    if (old) {
+        shared->retired[shared->retired_count] = old;
+        shared->retired_epochs[shared->retired_count] = epoch;
+        shared->retired_count++;
+    }
+
+    // Often nobody is reading the old one anymore
+    fld_shared_reclaim(shared);
+    return true;
+}
+
+void fld_shared_close(fld_shared_config *shared) {
+    fld_parser *current = _atomic_exchange_parser(&shared->current, NULL);
+    for (int i = 0; i < shared->retired_count; ++i) {
+        if (shared->release) shared->release(shared->retired[i], shared->user);
+    }
+    shared->retired_count = 0;
+    if (current && shared->release) {
+        shared->release(current, shared->user);
+    }
+}
+#endif // FLD_PARSER_THREADS
+
+#ifdef FLD_PARSER_FILE_IO
+static void *_file_map(const char *path, size_t *out_size) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    *out_size = (size_t)size.QuadPart;
+    if (*out_size == 0) {
+        // Empty files can't be mapped, hand back something non-null
+        CloseHandle(file);
+        return (void*)"";
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return NULL;
+
+    // The view keeps the mapping alive, the handle isn't needed anymore
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    return view;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    *out_size = (size_t)st.st_size;
+    if (*out_size == 0) {
+        // Empty files can't be mapped, hand back something non-null
+        close(fd);
+        return (void*)"";
+    }
+
+    void *view = mmap(NULL, *out_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return view == MAP_FAILED ? NULL : view;
+#endif
+}
+
+static void _file_unmap(void *view, size_t size) {
+    if (!view || size == 0) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(view);
+#else
+    munmap(view, size);
+#endif
+}
+
+bool fld_parse_file(fld_parser *parser, const char *path) {
+    // The mapping and arena of a previous file go first
+    fld_close(parser);
+    _parser_begin(parser);
+
+    size_t length = 0;
+    const char *source = (const char*)_file_map(path, &length);
+    if (!source) {
+        parser->last_error.code = FLD_ERROR_FILE_IO;
+        return false;
+    }
+
+    // The file is lexed in place, so the arena only holds the tree
+    size_t size = _prescan_memory_needed(source, length, FLD_PARSE_BORROW_SOURCE);
+    void *arena = malloc(size ? size : 1);
+    if (!arena) {
+        _file_unmap((void*)source, length);
+        parser->last_error.code = FLD_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+
+    parser->file_view = (void*)source;
+    parser->file_size = length;
+    parser->file_arena = arena;
+
+    if (!_parse_document(parser, source, length, arena, size, FLD_PARSE_BORROW_SOURCE)) {
+        fld_error error = parser->last_error;
+        fld_close(parser);
+        parser->last_error = error;
+        return false;
+    }
+
+    return true;
+}
+
+void fld_close(fld_parser *parser) {
+    _bump_release(&parser->allocator);
+    _bump_init(&parser->allocator, NULL, 0);
+    _file_unmap(parser->file_view, parser->file_size);
+    free(parser->file_arena);
+
+    parser->file_view = NULL;
+    parser->file_size = 0;
+    parser->file_arena = NULL;
+    parser->root = NULL;
+    parser->source = NULL;
+    parser->source_length = 0;
+}
+#endif // FLD_PARSER_FILE_IO
+
 #endif // FLD_PARSER_IMPLEMENTATION
 #endif // FLD_PARSER_H
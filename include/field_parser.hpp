@@ -0,0 +1,434 @@
+/*
+*   fld_parser C++ companion - requires C++17
+*   Thin wrappers over field_parser.h: path literals hashed at compile time,
+*   typed accessors, an owning document and range-for iteration.
+*
+*   Include this instead of field_parser.h. FLD_PARSER_IMPLEMENTATION and the
+*   other options are defined before including it, the same as for the C header.
+*
+*   LICENSE: MIT License, see field_parser.h
+*/
+
+#ifndef FLD_PARSER_HPP
+#define FLD_PARSER_HPP
+
+#include "field_parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string_view>
+
+#if defined(_MSVC_LANG)
+    #define FLD_CPLUSPLUS _MSVC_LANG
+#else
+    #define FLD_CPLUSPLUS __cplusplus
+#endif
+
+#if FLD_CPLUSPLUS >= 202002L && defined(__has_include)
+    #if __has_include(<span>)
+        #include <span>
+        #define FLD_STD_SPAN
+    #endif
+#endif
+
+namespace fld {
+
+#ifdef FLD_STD_SPAN
+template <typename T>
+using span = std::span<T>;
+#else
+// Stand-in for std::span before C++20, just enough for array items
+template <typename T>
+class span {
+public:
+    constexpr span() = default;
+    constexpr span(T *data, size_t size) : data_(data), size_(size) {}
+
+    constexpr T *data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr T *begin() const { return data_; }
+    constexpr T *end() const { return data_ + size_; }
+    constexpr T &operator[](size_t i) const { return data_[i]; }
+
+private:
+    T *data_ = nullptr;
+    size_t size_ = 0;
+};
+#endif
+
+struct vec2 { float x, y; };
+struct vec3 { float x, y, z; };
+struct vec4 { float x, y, z, w; };
+
+/**
+ * @brief fld_hash_key as a constant expression.
+ */
+constexpr uint32_t hash_key(const char *key, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)key[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief fld_path_compile as a constant expression.
+ *
+ * Paths that fld_path_compile refuses come out with no segments and resolve
+ * to nothing.
+ */
+constexpr fld_path make_path(const char *text, size_t length) {
+    fld_path path{};
+    if (length == 0 || length >= FLD_MAX_PATH_LENGTH) return path;
+
+    for (size_t i = 0; i < length; ++i) {
+        path.text[i] = text[i];
+    }
+
+    size_t i = 0;
+    while (i < length) {
+        // Skip separators, empty segments are ignored
+        if (text[i] == '.') {
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < length && text[i] != '.') {
+            i++;
+        }
+
+        if (path.segment_count >= FLD_MAX_PATH_SEGMENTS) {
+            path.segment_count = 0;
+            return path;
+        }
+
+        fld_path_segment &segment = path.segments[path.segment_count++];
+        segment.offset = (uint16_t)start;
+        segment.length = (uint16_t)(i - start);
+        segment.hash = hash_key(text + start, i - start);
+    }
+
+    return path;
+}
+
+inline namespace literals {
+/**
+ * @brief `"settings.window.size"_fld` is a compiled fld_path.
+ *
+ * Bind it to a constexpr variable to be sure the hashing happens at compile
+ * time, resolving it is then only hash and key compares per segment.
+ */
+constexpr fld_path operator""_fld(const char *text, size_t length) {
+    return make_path(text, length);
+}
+} // namespace literals
+
+class field;
+class fields;
+
+// How get<T>() reads a value of type T, specialized for every supported T.
+// Using anything else fails to compile.
+template <typename T>
+struct value_traits;
+
+template <>
+struct value_traits<int> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_INT; }
+    static int read(const fld_value &value) { return value.as.integer; }
+};
+
+// Any integer, like fld_get_int64
+template <>
+struct value_traits<int64_t> {
+    static bool matches(const fld_value &value) {
+        return value.type == FLD_VALUE_INT || value.type == FLD_VALUE_INT64;
+    }
+    static int64_t read(const fld_value &value) {
+        return value.type == FLD_VALUE_INT ? value.as.integer : value.as.int64;
+    }
+};
+
+template <>
+struct value_traits<float> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_FLOAT; }
+    static float read(const fld_value &value) { return value.as.float_val; }
+};
+
+template <>
+struct value_traits<bool> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_BOOL; }
+    static bool read(const fld_value &value) { return value.as.boolean; }
+};
+
+template <>
+struct value_traits<std::string_view> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_STRING; }
+    static std::string_view read(const fld_value &value) {
+        return std::string_view(value.as.string.start, (size_t)value.as.string.length);
+    }
+};
+
+template <>
+struct value_traits<vec2> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_VEC2; }
+    static vec2 read(const fld_value &value) { return vec2{value.as.vec2.x, value.as.vec2.y}; }
+};
+
+template <>
+struct value_traits<vec3> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_VEC3; }
+    static vec3 read(const fld_value &value) {
+        return vec3{value.as.vec3.x, value.as.vec3.y, value.as.vec3.z};
+    }
+};
+
+template <>
+struct value_traits<vec4> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_VEC4; }
+    static vec4 read(const fld_value &value) {
+        return vec4{value.as.vec4.x, value.as.vec4.y, value.as.vec4.z, value.as.vec4.w};
+    }
+};
+
+// Element type of the arrays whose items are stored as T
+template <typename T>
+struct array_item;
+
+template <> struct array_item<int> { static constexpr fld_value_type type = FLD_VALUE_INT; };
+template <> struct array_item<int64_t> { static constexpr fld_value_type type = FLD_VALUE_INT64; };
+template <> struct array_item<float> { static constexpr fld_value_type type = FLD_VALUE_FLOAT; };
+template <> struct array_item<bool> { static constexpr fld_value_type type = FLD_VALUE_BOOL; };
+template <> struct array_item<fld_string_view> { static constexpr fld_value_type type = FLD_VALUE_STRING; };
+
+// Empty arrays match every element type
+template <typename T>
+struct value_traits<span<const T>> {
+    static bool matches(const fld_value &value) {
+        return value.type == FLD_VALUE_ARRAY &&
+               (value.as.array.type == array_item<T>::type || value.as.array.count == 0);
+    }
+    static span<const T> read(const fld_value &value) {
+        return span<const T>((const T*)value.as.array.items, (size_t)value.as.array.count);
+    }
+};
+
+template <>
+struct value_traits<fields> {
+    static bool matches(const fld_value &value) { return value.type == FLD_VALUE_OBJECT; }
+    static fields read(const fld_value &value);
+};
+
+// Forward iterator over fld_iter_next, what fields and walks hand to range-for
+class iterator {
+public:
+    iterator() = default;
+    iterator(fld_object *root, fld_iter_type type) {
+        fld_iter_init(&state_, root, type);
+        current_ = fld_iter_next(&state_);
+    }
+
+    field operator*() const;
+    iterator &operator++() {
+        current_ = fld_iter_next(&state_);
+        return *this;
+    }
+
+    bool operator==(const iterator &other) const { return current_ == other.current_; }
+    bool operator!=(const iterator &other) const { return current_ != other.current_; }
+
+    // Nesting depth of the current field, 0 at the level iteration started on
+    int depth() const { return state_.depth; }
+
+private:
+    fld_iterator state_{};
+    fld_object *current_ = nullptr;
+};
+
+/**
+ * @brief A single field, or none. Wraps a fld_object pointer.
+ */
+class field {
+public:
+    field() = default;
+    field(fld_object *object) : object_(object) {}
+
+    explicit operator bool() const { return object_ != nullptr; }
+    fld_object *object() const { return object_; }
+
+    std::string_view key() const {
+        return object_ ? std::string_view(object_->key.start, (size_t)object_->key.length) : std::string_view();
+    }
+    fld_value_type type() const { return object_ ? object_->value.type : FLD_VALUE_EMPTY; }
+
+    // Whether the value can be read as T
+    template <typename T>
+    bool is() const {
+        return object_ && value_traits<T>::matches(object_->value);
+    }
+
+    /**
+     * @brief Reads the value as T, nothing if the field is missing or has
+     * another type. The type check is picked at compile time.
+     */
+    template <typename T>
+    std::optional<T> get() const {
+        if (!is<T>()) return std::nullopt;
+        return value_traits<T>::read(object_->value);
+    }
+
+    template <typename T>
+    T get_or(T fallback) const {
+        return is<T>() ? value_traits<T>::read(object_->value) : fallback;
+    }
+
+    // The fields of an object value, empty for anything else
+    fields children() const;
+
+private:
+    fld_object *object_ = nullptr;
+};
+
+// Recursive iteration, see fields::walk
+class walk {
+public:
+    explicit walk(fld_object *first) : first_(first) {}
+    iterator begin() const { return iterator(first_, FLD_ITER_RECURSIVE); }
+    iterator end() const { return iterator(); }
+
+private:
+    fld_object *first_;
+};
+
+/**
+ * @brief A list of fields (the top level, or an object's value) to look
+ * paths up in and iterate over. Wraps the list's first fld_object.
+ */
+class fields {
+public:
+    fields() = default;
+    fields(fld_object *first) : first_(first) {}
+
+    explicit operator bool() const { return first_ != nullptr; }
+    fld_object *object() const { return first_; }
+
+    field find(const fld_path &path) const { return fld_path_resolve(first_, &path); }
+    field find(const char *path) const { return fld_get_field_by_path(first_, path); }
+
+    template <typename T>
+    std::optional<T> get(const fld_path &path) const { return find(path).template get<T>(); }
+    template <typename T>
+    std::optional<T> get(const char *path) const { return find(path).template get<T>(); }
+
+    template <typename T>
+    T get_or(const fld_path &path, T fallback) const { return find(path).get_or(fallback); }
+    template <typename T>
+    T get_or(const char *path, T fallback) const { return find(path).get_or(fallback); }
+
+    // The fields on this level only
+    iterator begin() const { return iterator(first_, FLD_ITER_FIELDS); }
+    iterator end() const { return iterator(); }
+
+    // Every field below as well, depth first
+    walk all() const { return walk(first_); }
+
+private:
+    fld_object *first_ = nullptr;
+};
+
+inline fields value_traits<fields>::read(const fld_value &value) {
+    // Values are only ever read in place, through the field that holds
+    // them, which lazy objects need to be parsed
+    const char *field = reinterpret_cast<const char *>(&value) - offsetof(fld_object, value);
+    return fields(fld_get_children(reinterpret_cast<fld_object *>(const_cast<char *>(field))));
+}
+
+inline field iterator::operator*() const {
+    return field(current_);
+}
+
+inline fields field::children() const {
+    return fields(fld_get_children(object_));
+}
+
+/**
+ * @brief A parser with the arena it owns.
+ *
+ * parse() measures the source and allocates exactly what the tree needs,
+ * the arena is freed by the next parse or the destructor. Set a chunk
+ * allocator to grow the arena instead, its chunks are handed back the same
+ * way. Not copyable or movable, bindings point at the parser.
+ */
+class document {
+public:
+    document() = default;
+    ~document() { release(); }
+
+    document(const document &) = delete;
+    document &operator=(const document &) = delete;
+
+    bool parse(std::string_view source, uint32_t flags = FLD_PARSE_DEFAULT) {
+        release();
+
+        fld_measurement measurement;
+        if (!fld_measure(source.data(), source.size(), flags, &measurement)) {
+            parser_.last_error = measurement.error;
+            return false;
+        }
+
+        arena_.reset(new (std::nothrow) unsigned char[measurement.bytes ? measurement.bytes : 1]);
+        if (!arena_) {
+            parser_.last_error = fld_error{FLD_ERROR_OUT_OF_MEMORY, 0, 0};
+            return false;
+        }
+        return fld_parse_ex(&parser_, source.data(), source.size(), arena_.get(), measurement.bytes, flags);
+    }
+
+#ifdef FLD_PARSER_FILE_IO
+    bool parse_file(const char *path) {
+        release();
+        file_ = fld_parse_file(&parser_, path);
+        return file_;
+    }
+#endif
+
+    void set_allocator(const fld_chunk_allocator *allocator) { fld_parser_set_allocator(&parser_, allocator); }
+
+    // Frees the tree, the document is empty afterwards
+    void release() {
+#ifdef FLD_PARSER_FILE_IO
+        if (file_) {
+            fld_close(&parser_);
+            file_ = false;
+        }
+#endif
+        fld_parser_release(&parser_);
+        arena_.reset();
+    }
+
+    fields root() const { return fields(parser_.root); }
+    fld_error error() const { return parser_.last_error; }
+
+    // For the C API, fld_bind and friends
+    fld_parser &parser() { return parser_; }
+    const fld_parser &parser() const { return parser_; }
+
+    template <typename T>
+    std::optional<T> get(const fld_path &path) const { return root().get<T>(path); }
+    template <typename T>
+    std::optional<T> get(const char *path) const { return root().get<T>(path); }
+
+private:
+    fld_parser parser_{};
+    std::unique_ptr<unsigned char[]> arena_;
+    bool file_ = false;
+};
+
+} // namespace fld
+
+#endif // FLD_PARSER_HPP
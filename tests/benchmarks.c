@@ -0,0 +1,338 @@
+#define VF_TEST_IMPLEMENTATION
+#include "lib/vf_test.h"
+
+#define FLD_PARSER_IMPLEMENTATION
+#include "../include/field_parser.h"
+
+#include <stdarg.h>
+
+#define BENCH_ITERATIONS 5
+#define BENCH_MAX_PATHS 1024
+#define BENCH_LOOKUP_ROUNDS 200
+#define BENCH_MAX_RESULTS 64
+
+// Default allowed slowdown against a baseline, in percent
+#define BENCH_DEFAULT_TOLERANCE 15.0
+
+// Growable text buffer the corpora are written into
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} bench_text;
+
+static void text_printf(bench_text *text, const char *format, ...) {
+    va_list args;
+
+    while (true) {
+        size_t room = text->capacity - text->length;
+        va_start(args, format);
+        int written = vsnprintf(text->data ? text->data + text->length : NULL, room, format, args);
+        va_end(args);
+        if (written < 0) return;
+
+        if ((size_t)written < room) {
+            text->length += (size_t)written;
+            return;
+        }
+
+        size_t capacity = text->capacity ? text->capacity * 2 : 4096;
+        while (capacity - text->length <= (size_t)written) {
+            capacity *= 2;
+        }
+        char *data = (char*)realloc(text->data, capacity);
+        if (!data) return;
+        text->data = data;
+        text->capacity = capacity;
+    }
+}
+
+// Builds `values = [f, f, f, ...];` with the given number of floats
+static void make_float_array(bench_text *text, size_t item_count) {
+    text_printf(text, "values = [");
+    for (size_t i = 0; i < item_count; ++i) {
+        text_printf(text, i ? ", %zu.%02zu" : "%zu.%02zu", i % 1000, i % 97);
+    }
+    text_printf(text, "];\n");
+}
+
+// Integer and vector heavy fields, one array per line
+static void make_number_arrays(bench_text *text, size_t line_count) {
+    for (size_t i = 0; i < line_count; ++i) {
+        text_printf(text, "ints_%zu = [", i);
+        for (size_t j = 0; j < 32; ++j) {
+            text_printf(text, j ? ", %zu" : "%zu", (i * 31 + j * 7919) % 100000);
+        }
+        text_printf(text, "]; pos_%zu = vec3(%zu.5, -%zu.25, 1.0e-3);\n", i, i % 100, i % 50);
+    }
+}
+
+// Objects nested `depth` levels deep, repeated
+static void make_deep_nesting(bench_text *text, size_t tree_count, size_t depth) {
+    for (size_t i = 0; i < tree_count; ++i) {
+        text_printf(text, "tree_%zu = ", i);
+        for (size_t d = 0; d < depth; ++d) {
+            text_printf(text, "{ level_%zu = %zu; child = ", d, d);
+        }
+        text_printf(text, "true;");
+        for (size_t d = 0; d < depth; ++d) {
+            text_printf(text, " };");
+        }
+        text_printf(text, "\n");
+    }
+}
+
+// One object with a great many fields, and as many at the top level
+static void make_wide_objects(bench_text *text, size_t field_count) {
+    text_printf(text, "wide = {\n");
+    for (size_t i = 0; i < field_count; ++i) {
+        text_printf(text, "    field_%zu = %zu;\n", i, i);
+    }
+    text_printf(text, "};\n");
+    for (size_t i = 0; i < field_count; ++i) {
+        text_printf(text, "top_%zu = %zu.5;\n", i, i);
+    }
+}
+
+// More comments than data
+static void make_comment_heavy(bench_text *text, size_t field_count) {
+    for (size_t i = 0; i < field_count; ++i) {
+        text_printf(text, "// Field %zu: this comment explains the value below in far more words than needed\n", i);
+        text_printf(text, "/* Block comments span\n   several lines\n   before the field */\n");
+        text_printf(text, "value_%zu = %zu; // trailing remark\n\n", i, i);
+    }
+}
+
+// Long string values and string arrays
+static void make_long_strings(bench_text *text, size_t field_count) {
+    for (size_t i = 0; i < field_count; ++i) {
+        text_printf(text, "text_%zu = \"", i);
+        for (size_t j = 0; j < 16; ++j) {
+            text_printf(text, "lorem ipsum dolor sit amet %zu ", j);
+        }
+        text_printf(text, "\"; names_%zu = [\"alpha\", \"beta\", \"gamma\", \"delta\"];\n", i);
+    }
+}
+
+typedef struct {
+    char corpus[32];
+    char metric[32];
+    double value;
+} bench_result;
+
+typedef struct {
+    bench_result items[BENCH_MAX_RESULTS];
+    int count;
+} bench_results;
+
+static void report(bench_results *results, const char *corpus, const char *metric, double value) {
+    printf("%s,%s,%.4f\n", corpus, metric, value);
+    if (results->count >= BENCH_MAX_RESULTS) return;
+
+    bench_result *result = &results->items[results->count++];
+    snprintf(result->corpus, sizeof(result->corpus), "%s", corpus);
+    snprintf(result->metric, sizeof(result->metric), "%s", metric);
+    result->value = value;
+}
+
+// Returns false if the corpus didn't parse or its lookups failed, which
+// fails the run whatever the numbers say
+static bool bench_corpus(bench_results *results, const char *name, const bench_text *text) {
+    fld_measurement measurement;
+    if (!fld_measure(text->data, text->length, FLD_PARSE_DEFAULT, &measurement)) {
+        fprintf(stderr, "%s: does not parse (%s)\n", name, fld_error_string(measurement.error.code));
+        return false;
+    }
+
+    void *memory = malloc(measurement.bytes);
+    if (!memory) return false;
+    bool passed = true;
+
+    // Parse throughput, best of a few runs
+    fld_parser parser = {0};
+    double best = 0.0;
+    for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+        vf_test_timer timer = {0};
+        _timer_start(&timer);
+        bool ok = fld_parse_ex(&parser, text->data, text->length, memory, measurement.bytes, FLD_PARSE_DEFAULT);
+        double elapsed = _timer_get_elapsed(&timer);
+
+        if (!ok) {
+            fprintf(stderr, "%s: parse failed (%s)\n", name, fld_error_string(parser.last_error.code));
+            free(memory);
+            return false;
+        }
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+    report(results, name, "parse_mb_s", (text->length / (1024.0 * 1024.0)) / best);
+    report(results, name, "arena_bytes_per_byte", (double)fld_get_memory_used(&parser) / (double)text->length);
+
+    // Recursive iteration, collecting paths to look up along the way
+    static char paths[BENCH_MAX_PATHS][FLD_MAX_PATH_LENGTH];
+    size_t path_count = 0;
+    size_t nodes = 0;
+    best = 0.0;
+    for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+        fld_iterator iter;
+        fld_iter_init(&iter, parser.root, FLD_ITER_RECURSIVE);
+        nodes = 0;
+
+        vf_test_timer timer = {0};
+        _timer_start(&timer);
+        while (fld_iter_next(&iter)) {
+            nodes++;
+        }
+        double elapsed = _timer_get_elapsed(&timer);
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+    report(results, name, "iter_nodes_s", nodes / (best > 0.0 ? best : 1e-9));
+
+    // Spread the sampled paths over the whole tree
+    size_t stride = nodes / BENCH_MAX_PATHS + 1;
+    fld_iterator iter;
+    fld_iter_init(&iter, parser.root, FLD_ITER_RECURSIVE);
+    for (size_t i = 0; fld_iter_next(&iter) && path_count < BENCH_MAX_PATHS; ++i) {
+        if (i % stride == 0 && fld_iter_get_path(&iter, paths[path_count], FLD_MAX_PATH_LENGTH)) {
+            path_count++;
+        }
+    }
+
+    // Enough rounds for every corpus to do about the same number of lookups
+    size_t rounds = BENCH_LOOKUP_ROUNDS * BENCH_MAX_PATHS / (path_count ? path_count : 1);
+    size_t lookups = rounds * path_count;
+    best = 0.0;
+    for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+        size_t found = 0;
+        vf_test_timer timer = {0};
+        _timer_start(&timer);
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t j = 0; j < path_count; ++j) {
+                found += fld_get_field_by_path(parser.root, paths[j]) != NULL;
+            }
+        }
+        double elapsed = _timer_get_elapsed(&timer);
+
+        if (found != lookups) {
+            fprintf(stderr, "%s: %zu of %zu lookups failed\n", name, lookups - found, lookups);
+            passed = false;
+        }
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+    report(results, name, "lookups_s", (double)lookups / (best > 0.0 ? best : 1e-9));
+
+    // Writing the tree back out, into a buffer sized by a measuring pass
+    size_t written = fld_write(parser.root, NULL, 0, FLD_WRITE_PRETTY);
+    char *output = (char*)malloc(written + 1);
+    if (output && written > 0) {
+        best = 0.0;
+        for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+            vf_test_timer timer = {0};
+            _timer_start(&timer);
+            fld_write(parser.root, output, written + 1, FLD_WRITE_PRETTY);
+            double elapsed = _timer_get_elapsed(&timer);
+            if (i == 0 || elapsed < best) best = elapsed;
+        }
+        report(results, name, "write_mb_s", (written / (1024.0 * 1024.0)) / (best > 0.0 ? best : 1e-9));
+    }
+    free(output);
+
+    free(memory);
+    return passed;
+}
+
+// Compares against a previous run's output, returns the number of regressions.
+// Everything is higher-is-better except the arena ratio. A baseline row this
+// run has no result for counts as a regression too.
+static int compare_baseline(const bench_results *results, const char *path, double tolerance) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "could not open baseline %s\n", path);
+        return 1;
+    }
+
+    int regressions = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char corpus[32], metric[32];
+        double baseline;
+        if (sscanf(line, "%31[^,],%31[^,],%lf", corpus, metric, &baseline) != 3) continue;
+
+        bool found = false;
+        for (int i = 0; i < results->count; ++i) {
+            const bench_result *result = &results->items[i];
+            if (strcmp(result->corpus, corpus) != 0 || strcmp(result->metric, metric) != 0) continue;
+            found = true;
+
+            // A zero baseline has no percentage, only going above it counts
+            bool lower_is_better = strcmp(metric, "arena_bytes_per_byte") == 0;
+            double change = baseline != 0.0 ? (result->value - baseline) / baseline * 100.0 : 0.0;
+            bool regressed = baseline != 0.0 ? (lower_is_better ? change > tolerance : change < -tolerance)
+                                             : (lower_is_better && result->value > 0.0);
+            if (regressed) {
+                fprintf(stderr, "REGRESSION %s,%s: %.4f -> %.4f (%+.1f%%)\n", corpus, metric, baseline, result->value, change);
+                regressions++;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "REGRESSION %s,%s: %.4f -> missing\n", corpus, metric, baseline);
+            regressions++;
+        }
+    }
+
+    fclose(file);
+    return regressions;
+}
+
+typedef struct {
+    const char *name;
+    void (*make)(bench_text *text, size_t size);
+    size_t size;
+} bench_corpus_def;
+
+static void make_deep(bench_text *text, size_t size) {
+    make_deep_nesting(text, size, 24);
+}
+
+int main(int argc, char **argv) {
+    // The timer needs its frequency on Windows, normally set by RUN_ALL_TESTS
+    #if VF_PLATFORM_WINDOWS
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        timer_frequency = 1.0 / (double)frequency.QuadPart;
+    #endif
+
+    // Usage: benchmarks [--compare baseline.csv] [--tolerance percent]
+    const char *baseline = NULL;
+    double tolerance = BENCH_DEFAULT_TOLERANCE;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        }
+    }
+
+    const bench_corpus_def corpora[] = {
+        {"float_array", make_float_array, 1000 * 1000},
+        {"number_arrays", make_number_arrays, 20 * 1000},
+        {"deep_nesting", make_deep, 10 * 1000},
+        {"wide_objects", make_wide_objects, 100 * 1000},
+        {"comment_heavy", make_comment_heavy, 40 * 1000},
+        {"long_strings", make_long_strings, 10 * 1000},
+    };
+
+    bench_results results = {0};
+    int failed = 0;
+    printf("corpus,metric,value\n");
+    for (size_t i = 0; i < sizeof(corpora) / sizeof(corpora[0]); ++i) {
+        bench_text text = {0};
+        corpora[i].make(&text, corpora[i].size);
+        if (!text.data || !bench_corpus(&results, corpora[i].name, &text)) {
+            failed++;
+        }
+        free(text.data);
+    }
+
+    int regressions = baseline ? compare_baseline(&results, baseline, tolerance) : 0;
+    return failed > 0 || regressions > 0 ? 1 : 0;
+}
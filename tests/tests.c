@@ -1,7 +1,12 @@
+#include <stddef.h>
+
 #define VF_TEST_IMPLEMENTATION
 #include "lib/vf_test.h"
 
 #define FLD_PARSER_IMPLEMENTATION
+#define FLD_PARSER_FILE_IO
+#define FLD_PARSER_THREADS
+#define FLD_ENABLE_STATS
 #include "../include/field_parser.h"
 
 // Helper function to create a parser with memory
@@ -78,9 +83,24 @@ TEST(Parser, BigNumbers) {
     fld_parser parser = {0};
     void* memory = NULL;
     
-    EXPECT_FALSE(setup_parser(&parser, source, &memory));
+    // Any number of float digits is fine, past a float's precision they
+    // only round
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+    float big_float;
+    EXPECT_TRUE(fld_get_float(parser.root, "big_float", &big_float));
+    EXPECT_TRUE(big_float == 1e9f);
+    cleanup_parser(memory);
 
+    // Integers beyond 64 bits are still too big
+    EXPECT_FALSE(setup_parser(&parser, "big_int = 9223372036854775808;", &memory));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_INVALID_NUMBER);
     cleanup_parser(memory);
+
+    // Floats beyond the float range too
+    EXPECT_FALSE(setup_parser(&parser, "big_float = 1.0e39;", &memory));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_INVALID_NUMBER);
+    cleanup_parser(memory);
+
     return true;
 }
 
@@ -503,6 +523,2124 @@ TEST(Parser, EdgeCases) {
     return true;
 }
 
+TEST(Parser, ArenaHoldsOnlyTree) {
+    const char* source =
+        "a = 1;\n"
+        "b = \"two\";\n"
+        "c = { d = 3.0; e = vec2(1.0, 2.0); };\n";
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+
+    // Only the source copy and the five fields should be in the arena,
+    // tokens and intermediate values are not allocated from it
+    size_t used = parser.allocator.current - parser.allocator.start;
+    size_t tree = strlen(source) + 1 + 5 * sizeof(fld_object) + ALIGNOF(fld_object);
+    EXPECT_TRUE(used <= tree);
+
+    float x, y;
+    EXPECT_TRUE(fld_get_vec2(parser.root, "c.e", &x, &y));
+    EXPECT_EQ_FLOAT(y, 2.0f);
+
+    cleanup_parser(memory);
+    return true;
+}
+
+TEST(Parser, ArraySinglePass) {
+    const char* source =
+        "floats = [1.5, -2.0, 3.25, 4.0, 5.5];\n"
+        "after = 7;\n";
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+
+    fld_value_type type;
+    void* items;
+    size_t count;
+    EXPECT_TRUE(fld_get_array(parser.root, "floats", &type, &items, &count));
+    EXPECT_EQ(type, FLD_VALUE_FLOAT);
+    EXPECT_EQ(count, 5);
+    float* floats = (float*)items;
+    EXPECT_EQ_FLOAT(floats[0], 1.5f);
+    EXPECT_EQ_FLOAT(floats[1], -2.0f);
+    EXPECT_EQ_FLOAT(floats[4], 5.5f);
+
+    // Storage is exactly the items, directly followed by the next field
+    fld_object* after = fld_get_field(parser.root, "after");
+    EXPECT_TRUE(after != NULL);
+    EXPECT_TRUE((size_t)((uint8_t*)after - (uint8_t*)(floats + 5)) < ALIGNOF(fld_object));
+
+    int after_val;
+    EXPECT_TRUE(fld_get_int(parser.root, "after", &after_val));
+    EXPECT_EQ_INT(after_val, 7);
+
+    cleanup_parser(memory);
+    return true;
+}
+
+TEST(Parser, ArrayErrors) {
+    fld_parser parser = {0};
+    void* memory = NULL;
+
+    EXPECT_FALSE(setup_parser(&parser, "mixed = [1, \"two\", 3];", &memory));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_ARRAY_TYPE_MISMATCH);
+    cleanup_parser(memory);
+
+    EXPECT_FALSE(setup_parser(&parser, "nested = [[1, 2], [3, 4]];", &memory));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_ARRAY_NOT_SUPPORTED_TYPE);
+    cleanup_parser(memory);
+
+    EXPECT_FALSE(setup_parser(&parser, "unclosed = [1, 2;", &memory));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_UNEXPECTED_TOKEN);
+    cleanup_parser(memory);
+
+    return true;
+}
+
+TEST(Parser, LargeArrays) {
+    // Well over the old 128 item limit
+    const int item_count = 5000;
+    char* source = (char*)malloc(item_count * 8 + 32);
+    char* cursor = source;
+    cursor += sprintf(cursor, "values = [");
+    for (int i = 0; i < item_count; ++i) {
+        cursor += sprintf(cursor, i ? ", %d.5" : "%d.5", i % 100);
+    }
+    sprintf(cursor, "];");
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+
+    bool parsed = setup_parser(&parser, source, &memory);
+    free(source);
+    EXPECT_TRUE(parsed);
+
+    fld_value_type type;
+    void* items;
+    size_t count;
+    EXPECT_TRUE(fld_get_array(parser.root, "values", &type, &items, &count));
+    EXPECT_EQ(type, FLD_VALUE_FLOAT);
+    EXPECT_EQ(count, (size_t)item_count);
+    float* floats = (float*)items;
+    EXPECT_EQ_FLOAT(floats[0], 0.5f);
+    EXPECT_EQ_FLOAT(floats[4999], 99.5f);
+
+    cleanup_parser(memory);
+
+    // The bulk path still catches type changes in the middle of a run
+    EXPECT_FALSE(setup_parser(&parser, "values = [1.0, 2.0, 3, 4.0];", &memory));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_ARRAY_TYPE_MISMATCH);
+    cleanup_parser(memory);
+
+    return true;
+}
+
+TEST(Parser, HashedLookup) {
+    char source[4096];
+    char* cursor = source;
+    cursor += sprintf(cursor, "wide = {\n");
+    for (int i = 0; i < 64; ++i) {
+        cursor += sprintf(cursor, "    key_%d = %d;\n", i, i);
+    }
+    cursor += sprintf(cursor, "    key_7 = 1000;\n"); // Duplicate, first one wins
+    cursor += sprintf(cursor, "};\nsmall = { a = 1; b = 2; };\n");
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+
+    fld_object* wide;
+    EXPECT_TRUE(fld_get_object(parser.root, "wide", &wide));
+    EXPECT_TRUE(wide->index != NULL);
+
+    char path[32];
+    int val;
+    for (int i = 0; i < 64; ++i) {
+        sprintf(path, "wide.key_%d", i);
+        EXPECT_TRUE(fld_get_int(parser.root, path, &val));
+        EXPECT_EQ_INT(i, val);
+    }
+    EXPECT_FALSE(fld_has_field(parser.root, "wide.key_64"));
+
+    // Starting a lookup in the middle of the list still only scans forward
+    fld_object* middle = fld_get_field(wide, "key_32");
+    EXPECT_TRUE(middle != NULL);
+    EXPECT_TRUE(fld_get_field(middle, "key_40") != NULL);
+    EXPECT_TRUE(fld_get_field(middle, "key_10") == NULL);
+
+    // Iteration order is untouched
+    fld_iterator iter;
+    fld_iter_init(&iter, wide, FLD_ITER_FIELDS);
+    fld_object* first = fld_iter_next(&iter);
+    fld_object* second = fld_iter_next(&iter);
+    EXPECT_TRUE(fld_string_view_eq(first->key, "key_0"));
+    EXPECT_TRUE(fld_string_view_eq(second->key, "key_1"));
+
+    fld_object* small;
+    EXPECT_TRUE(fld_get_object(parser.root, "small", &small));
+    EXPECT_TRUE(small->index == NULL);
+
+    cleanup_parser(memory);
+    return true;
+}
+
+TEST(Parser, CompiledPaths) {
+    const char* source =
+        "settings = {\n"
+        "    window = { size = vec2(1920.0, 1080.0); };\n"
+        "    volume = 0.5;\n"
+        "};\n"
+        "name = \"first\";\n";
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+
+    fld_path size_path;
+    EXPECT_TRUE(fld_path_compile(&size_path, "settings.window.size"));
+    EXPECT_EQ(size_path.segment_count, 3);
+    EXPECT_TRUE(fld_path_resolve(parser.root, &size_path) == fld_get_field_by_path(parser.root, "settings.window.size"));
+
+    fld_path missing_path;
+    EXPECT_TRUE(fld_path_compile(&missing_path, "settings.volume.nope"));
+    EXPECT_TRUE(fld_path_resolve(parser.root, &missing_path) == NULL);
+
+    EXPECT_FALSE(fld_path_compile(&missing_path, ""));
+    EXPECT_FALSE(fld_path_compile(&missing_path, "..."));
+
+    // Bindings resolve once and then read straight from the cached field
+    fld_path volume_path;
+    EXPECT_TRUE(fld_path_compile(&volume_path, "settings.volume"));
+    fld_binding volume;
+    EXPECT_TRUE(fld_bind(&volume, &volume_path, &parser) != NULL);
+
+    float vol;
+    EXPECT_TRUE(fld_binding_get_float(&volume, &vol));
+    EXPECT_EQ_FLOAT(vol, 0.5f);
+
+    int wrong_type;
+    EXPECT_FALSE(fld_binding_get_int(&volume, &wrong_type));
+
+    float x, y;
+    fld_binding size;
+    fld_bind(&size, &size_path, &parser);
+    EXPECT_TRUE(fld_binding_get_vec2(&size, &x, &y));
+    EXPECT_EQ_FLOAT(x, 1920.0f);
+
+    // Parsing again into the same parser makes the binding resolve again
+    const char* reloaded = "settings = { volume = 0.25; };";
+    EXPECT_TRUE(fld_parse(&parser, reloaded, memory, fld_estimate_memory(source)));
+    EXPECT_TRUE(fld_binding_get_float(&volume, &vol));
+    EXPECT_EQ_FLOAT(vol, 0.25f);
+    EXPECT_FALSE(fld_binding_get_vec2(&size, &x, &y));
+
+    cleanup_parser(memory);
+    return true;
+}
+
+TEST(Parser, BorrowedSource) {
+    // Not null-terminated after the first field on purpose
+    const char buffer[] = "name = \"borrowed\"; count = 3; ignored = 1;";
+    size_t length = strstr(buffer, " ignored") - buffer;
+
+    fld_parser parser = {0};
+    size_t size = fld_estimate_memory(buffer);
+    void* memory = malloc(size);
+
+    EXPECT_TRUE(fld_parse_borrowed(&parser, buffer, length, memory, size));
+
+    // String views point into the caller's buffer, nothing was copied
+    fld_string_view name;
+    EXPECT_TRUE(fld_get_str_view(parser.root, "name", &name));
+    EXPECT_TRUE(name.start > buffer && name.start < buffer + length);
+    EXPECT_TRUE(fld_string_view_eq(name, "borrowed"));
+    EXPECT_TRUE(parser.source == buffer);
+
+    int count;
+    EXPECT_TRUE(fld_get_int(parser.root, "count", &count));
+    EXPECT_EQ_INT(count, 3);
+    EXPECT_FALSE(fld_has_field(parser.root, "ignored"));
+
+    // Source ending in the middle of a value
+    EXPECT_FALSE(fld_parse_borrowed(&parser, buffer, 10, memory, size));
+
+    // Copying variant with an explicit length
+    EXPECT_TRUE(fld_parse_ex(&parser, buffer, length, memory, size, FLD_PARSE_DEFAULT));
+    EXPECT_TRUE(fld_get_str_view(parser.root, "name", &name));
+    EXPECT_TRUE(name.start < buffer || name.start >= buffer + sizeof(buffer));
+
+    free(memory);
+    return true;
+}
+
+TEST(Parser, ParseFile) {
+    const char* source =
+        "// Mapped straight from disk\n"
+        "title = \"from file\";\n"
+        "numbers = [1, 2, 3, 4, 5, 6, 7, 8];\n"
+        "nested = { flag = true; scale = vec3(1.0, 2.0, 3.0); };\n";
+
+    const char* path = "fld_parse_file_test.fld";
+    FILE* file = fopen(path, "wb");
+    EXPECT_TRUE(file != NULL);
+    fwrite(source, 1, strlen(source), file);
+    fclose(file);
+
+    fld_parser parser = {0};
+    bool parsed = fld_parse_file(&parser, path);
+    // Parsing again lets go of the previous mapping and arena
+    parsed = parsed && fld_parse_file(&parser, path);
+    remove(path);
+    EXPECT_TRUE(parsed);
+
+    char title[32];
+    EXPECT_TRUE(fld_get_cstr(parser.root, "title", title, sizeof(title)));
+    EXPECT_TRUE(strcmp(title, "from file") == 0);
+
+    size_t count;
+    EXPECT_TRUE(fld_get_array_size(parser.root, "numbers", &count));
+    EXPECT_EQ(count, 8);
+
+    bool flag;
+    EXPECT_TRUE(fld_get_bool(parser.root, "nested.flag", &flag));
+    EXPECT_TRUE(flag);
+
+    // The arena is sized from the pre-scan, an upper bound of the exact size
+    fld_measurement measurement;
+    EXPECT_TRUE(fld_measure(source, strlen(source), FLD_PARSE_BORROW_SOURCE, &measurement));
+    size_t arena = parser.allocator.end - parser.allocator.start;
+    EXPECT_EQ(fld_get_memory_used(&parser), measurement.bytes);
+    EXPECT_TRUE(measurement.bytes <= arena);
+
+    fld_close(&parser);
+    EXPECT_TRUE(parser.root == NULL);
+
+    EXPECT_FALSE(fld_parse_file(&parser, "this_file_does_not_exist.fld"));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_FILE_IO);
+
+    return true;
+}
+
+TEST(Parser, ExactMeasure) {
+    char source[2048];
+    int written = sprintf(source,
+        "name = \"measured\";\n"
+        "flags = [true, false, true];\n"
+        "ints = [1, 2, 3, 4, 5];\n"
+        "names = [\"a\", \"b\"];\n"
+        "empty = {};\n"
+        "none = [];\n"
+        "nested = { scale = vec3(1.0, 2.0, 3.0); inner = { value = 0.5; }; };\n");
+    // Enough fields for a lookup index
+    for (int i = 0; i < 20; ++i) {
+        written += sprintf(source + written, "field_%d = %d;\n", i, i);
+    }
+    size_t length = (size_t)written;
+
+    fld_measurement measurement;
+    EXPECT_TRUE(fld_measure(source, length, FLD_PARSE_DEFAULT, &measurement));
+    EXPECT_EQ(measurement.fields, 30);
+    EXPECT_EQ(measurement.objects, 3);
+    EXPECT_EQ(measurement.arrays, 4);
+    EXPECT_EQ(measurement.items[FLD_VALUE_BOOL], 3);
+    EXPECT_EQ(measurement.items[FLD_VALUE_INT], 5);
+    EXPECT_EQ(measurement.items[FLD_VALUE_STRING], 2);
+    EXPECT_EQ(measurement.indexes, FLD_INDEX_MIN_FIELDS > 0 && FLD_INDEX_MIN_FIELDS <= 27 ? 1 : 0);
+    EXPECT_EQ(fld_estimate_memory(source), measurement.bytes);
+
+    // Exactly the measured size is enough, one byte less is not
+    fld_parser parser = {0};
+    void* memory = malloc(measurement.bytes);
+    EXPECT_TRUE(fld_parse_ex(&parser, source, length, memory, measurement.bytes, FLD_PARSE_DEFAULT));
+    EXPECT_EQ(fld_get_memory_used(&parser), measurement.bytes);
+    EXPECT_FALSE(fld_parse_ex(&parser, source, length, memory, measurement.bytes - 1, FLD_PARSE_DEFAULT));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_OUT_OF_MEMORY);
+
+    // Borrowing skips the source copy
+    fld_measurement borrowed;
+    EXPECT_TRUE(fld_measure(source, length, FLD_PARSE_BORROW_SOURCE, &borrowed));
+    EXPECT_TRUE(fld_parse_borrowed(&parser, source, length, memory, borrowed.bytes));
+    EXPECT_EQ(fld_get_memory_used(&parser), borrowed.bytes);
+    EXPECT_TRUE(borrowed.bytes + length + 1 <= measurement.bytes);
+    free(memory);
+
+    // Errors are reported like the parser would
+    const char* bad = "a = 1;\nb = [1, \"two\"];";
+    EXPECT_FALSE(fld_measure(bad, strlen(bad), FLD_PARSE_DEFAULT, &measurement));
+    EXPECT_EQ(measurement.error.code, FLD_ERROR_ARRAY_TYPE_MISMATCH);
+    EXPECT_EQ(measurement.error.line, 2);
+
+    return true;
+}
+
+typedef struct {
+    int allocated;
+    int freed;
+} chunk_counter;
+
+static void* counting_alloc(size_t size, void* user) {
+    ((chunk_counter*)user)->allocated++;
+    return malloc(size);
+}
+
+static void counting_free(void* memory, size_t size, void* user) {
+    (void)size;
+    ((chunk_counter*)user)->freed++;
+    free(memory);
+}
+
+TEST(Parser, ChunkedArena) {
+    char source[8192];
+    int written = sprintf(source, "numbers = [0");
+    for (int i = 1; i < 500; ++i) {
+        written += sprintf(source + written, ", %d", i);
+    }
+    written += sprintf(source + written, "];\n");
+    for (int i = 0; i < 40; ++i) {
+        written += sprintf(source + written, "group_%d = { value = %d; };\n", i, i);
+    }
+
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 512};
+
+    // No memory of its own, everything comes from small chunks
+    fld_parser parser = {0};
+    fld_parser_set_allocator(&parser, &chunks);
+    EXPECT_TRUE(fld_parse_ex(&parser, source, (size_t)written, NULL, 0, FLD_PARSE_DEFAULT));
+    EXPECT_TRUE(counter.allocated > 1);
+
+    // The array outgrew several chunks and still has to be contiguous
+    size_t count;
+    EXPECT_TRUE(fld_get_array_size(parser.root, "numbers", &count));
+    EXPECT_EQ(count, 500);
+    const fld_object* numbers = fld_get_field(parser.root, "numbers");
+    const int* items = (const int*)numbers->value.as.array.items;
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ_INT(items[i], i);
+    }
+
+    int value;
+    EXPECT_TRUE(fld_get_int(parser.root, "group_39.value", &value));
+    EXPECT_EQ_INT(value, 39);
+    EXPECT_TRUE(fld_get_memory_used(&parser) >= (size_t)written);
+
+    // A new parse hands the previous chunks back first
+    char memory[256];
+    EXPECT_TRUE(fld_parse(&parser, source, memory, sizeof(memory)));
+    EXPECT_TRUE(counter.freed > 0);
+
+    fld_parser_release(&parser);
+    EXPECT_EQ_INT(counter.freed, counter.allocated);
+    EXPECT_TRUE(parser.root == NULL);
+
+    // Without a chunk allocator a full buffer still fails the parse
+    fld_parser_set_allocator(&parser, NULL);
+    EXPECT_FALSE(fld_parse(&parser, source, memory, sizeof(memory)));
+    EXPECT_EQ(parser.last_error.code, FLD_ERROR_OUT_OF_MEMORY);
+    EXPECT_EQ_INT(counter.freed, counter.allocated);
+
+    return true;
+}
+
+TEST(Parser, ParserInit) {
+    // Whatever was on the stack before, fld_parser_init makes it a parser
+    fld_parser parser;
+    memset(&parser, 0xA5, sizeof(parser));
+    fld_parser_init(&parser);
+
+    char memory[1024];
+    EXPECT_TRUE(fld_parse(&parser, "a = 1; b = { c = 2; };", memory, sizeof(memory)));
+    int value = 0;
+    EXPECT_TRUE(fld_get_int(parser.root, "b.c", &value));
+    EXPECT_EQ_INT(value, 2);
+    EXPECT_TRUE(fld_parse(&parser, "a = 3;", memory, sizeof(memory)));
+    EXPECT_TRUE(fld_get_int(parser.root, "a", &value));
+    EXPECT_EQ_INT(value, 3);
+    fld_parser_release(&parser);
+    return true;
+}
+
+TEST(Parser, LongCommentRuns) {
+    // Runs of trivia longer than a SIMD block, with stars and slashes inside
+    const char* source =
+        "/*************************************************\n"
+        " * Heavily commented header, * and / everywhere * \n"
+        " *************************************************/\n"
+        "                                                   \n"
+        "// ---------------------------------------------------------------\n"
+        "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t first = 1;\n"
+        "/* a */ /* b */ // c\n"
+        "second = 2;   /* trailing block comment that is long enough */\n"
+        "\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n"
+        "    third = oops;";
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+
+    EXPECT_FALSE(setup_parser(&parser, source, &memory));
+    fld_error error = fld_get_last_error(&parser);
+    EXPECT_EQ(error.code, FLD_ERROR_UNEXPECTED_TOKEN);
+    EXPECT_EQ_INT(error.line, 18);
+    EXPECT_EQ_INT(error.column, 13);
+    cleanup_parser(memory);
+
+    // Same source with a valid last value
+    char fixed[1024];
+    strcpy(fixed, source);
+    memcpy(strstr(fixed, "oops"), "   3", 4);
+    EXPECT_TRUE(setup_parser(&parser, fixed, &memory));
+
+    int val;
+    EXPECT_TRUE(fld_get_int(parser.root, "first", &val));
+    EXPECT_EQ_INT(val, 1);
+    EXPECT_TRUE(fld_get_int(parser.root, "second", &val));
+    EXPECT_EQ_INT(val, 2);
+    EXPECT_TRUE(fld_get_int(parser.root, "third", &val));
+    EXPECT_EQ_INT(val, 3);
+    cleanup_parser(memory);
+
+    // Unterminated block comments are reported where they start
+    const char* unterminated = "a = 1;\n  /* never closed ....................\n\n";
+    EXPECT_FALSE(setup_parser(&parser, unterminated, &memory));
+    error = fld_get_last_error(&parser);
+    EXPECT_EQ_INT(error.line, 2);
+    EXPECT_EQ_INT(error.column, 3);
+    cleanup_parser(memory);
+
+    return true;
+}
+
+TEST(Parser, NumberParsing) {
+    const char* source =
+        "tenth = 0.1;\n"
+        "third = 0.333333343267;\n"
+        "avogadro = 6.02214076e23;\n"
+        "planck = 6.62607015E-34;\n"
+        "tiny = 1.0e-45;\n"
+        "underflow = 1.0e-50;\n"
+        "exponent_int = 25e-1;\n"
+        "positive_exponent = 2.5e+2;\n"
+        "negative = -1.5e3;\n"
+        "halfway = 16777217.0000000000001;\n"
+        "long_tail = 4.8410654283036202994e-13;\n"
+        "leading_zeros = 0.0000000000000000000000123;\n"
+        "printed = 2.5000000000000000000000000e-01;\n"
+        "big = 9000000000;\n"
+        "max = 9223372036854775807;\n"
+        "min = -9223372036854775808;\n"
+        "small = -2147483648;\n"
+        "mixed = [1, -2, 9000000000, 4];\n"
+        "wide = [9000000000, 1, 2];\n";
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+
+    // Correctly rounded, bit for bit what a compiler would make of the literal
+    float f;
+    EXPECT_TRUE(fld_get_float(parser.root, "tenth", &f));
+    EXPECT_TRUE(f == 0.1f);
+    EXPECT_TRUE(fld_get_float(parser.root, "third", &f));
+    EXPECT_TRUE(f == 0.333333343267f);
+    EXPECT_TRUE(fld_get_float(parser.root, "avogadro", &f));
+    EXPECT_TRUE(f == 6.02214076e23f);
+    EXPECT_TRUE(fld_get_float(parser.root, "planck", &f));
+    EXPECT_TRUE(f == 6.62607015e-34f);
+    EXPECT_TRUE(fld_get_float(parser.root, "tiny", &f));
+    EXPECT_TRUE(f == 1.0e-45f);
+    EXPECT_TRUE(fld_get_float(parser.root, "underflow", &f));
+    EXPECT_TRUE(f == 0.0f);
+    EXPECT_TRUE(fld_get_float(parser.root, "exponent_int", &f));
+    EXPECT_TRUE(f == 2.5f);
+    EXPECT_TRUE(fld_get_float(parser.root, "positive_exponent", &f));
+    EXPECT_TRUE(f == 250.0f);
+    EXPECT_TRUE(fld_get_float(parser.root, "negative", &f));
+    EXPECT_TRUE(f == -1500.0f);
+
+    // Digits past the 64-bit mantissa still decide halfway cases, and only
+    // significant digits count towards it
+    EXPECT_TRUE(fld_get_float(parser.root, "halfway", &f));
+    EXPECT_TRUE(f == 16777218.0f);
+    EXPECT_TRUE(fld_get_float(parser.root, "long_tail", &f));
+    EXPECT_TRUE(f == 4.8410654283036202994e-13f);
+    EXPECT_TRUE(fld_get_float(parser.root, "leading_zeros", &f));
+    EXPECT_TRUE(f == 1.23e-23f);
+    EXPECT_TRUE(fld_get_float(parser.root, "printed", &f));
+    EXPECT_TRUE(f == 0.25f);
+
+    // Integers that don't fit in an int are int64
+    int i;
+    int64_t i64;
+    EXPECT_EQ(fld_get_type(parser.root, "big"), FLD_VALUE_INT64);
+    EXPECT_FALSE(fld_get_int(parser.root, "big", &i));
+    EXPECT_TRUE(fld_get_int64(parser.root, "big", &i64));
+    EXPECT_TRUE(i64 == 9000000000LL);
+    EXPECT_TRUE(fld_get_int64(parser.root, "max", &i64));
+    EXPECT_TRUE(i64 == INT64_MAX);
+    EXPECT_TRUE(fld_get_int64(parser.root, "min", &i64));
+    EXPECT_TRUE(i64 == INT64_MIN);
+    EXPECT_TRUE(fld_get_int(parser.root, "small", &i));
+    EXPECT_EQ_INT(i, INT32_MIN);
+    EXPECT_TRUE(fld_get_int64(parser.root, "small", &i64));
+    EXPECT_TRUE(i64 == INT32_MIN);
+
+    // Int arrays widen to int64 when they have to, in either order
+    const char* names[] = { "mixed", "wide" };
+    const int64_t expected[][4] = { { 1, -2, 9000000000LL, 4 }, { 9000000000LL, 1, 2, 0 } };
+    for (int a = 0; a < 2; ++a) {
+        fld_value_type type;
+        void* items;
+        size_t count;
+        EXPECT_TRUE(fld_get_array(parser.root, names[a], &type, &items, &count));
+        EXPECT_EQ(type, FLD_VALUE_INT64);
+        EXPECT_EQ(count, a == 0 ? 4 : 3);
+        for (size_t n = 0; n < count; ++n) {
+            EXPECT_TRUE(((int64_t*)items)[n] == expected[a][n]);
+        }
+    }
+
+    // The measure pass accounts for the widened copy
+    fld_measurement measurement;
+    EXPECT_TRUE(fld_measure(source, strlen(source), FLD_PARSE_DEFAULT, &measurement));
+    EXPECT_EQ(fld_get_memory_used(&parser), measurement.bytes);
+    EXPECT_EQ(measurement.items[FLD_VALUE_INT64], 7);
+
+    cleanup_parser(memory);
+    return true;
+}
+
+static const fld_change* find_change(const fld_changes* changes, const char* path) {
+    for (size_t i = 0; i < changes->count; ++i) {
+        if (fld_string_view_eq(changes->items[i].path, path)) return &changes->items[i];
+    }
+    return NULL;
+}
+
+TEST(Parser, IncrementalReparse) {
+    char before[2048];
+    char after[2048];
+    int written = sprintf(before,
+        "window = { width = 1280; height = 720; title = \"Editor\"; };\n"
+        "volume = 0.5;\n"
+        "tags = [\"a\", \"b\"];\n"
+        "removed = true;\n");
+    for (int i = 0; i < 20; ++i) {
+        written += sprintf(before + written, "key_%d = %d;\n", i, i);
+    }
+
+    // Same document with a changed volume, a comment, a moved field,
+    // a removed and an added one
+    written = sprintf(after,
+        "// Saved from the editor\n"
+        "tags = [\"a\", \"b\"];\n"
+        "window = { width = 1280; height = 720; title = \"Editor\"; };\n"
+        "volume = 0.75;\n");
+    for (int i = 0; i < 20; ++i) {
+        written += sprintf(after + written, i == 7 ? "key_%d =   %d; // formatting only\n" : "key_%d = %d;\n", i, i);
+    }
+    written += sprintf(after + written, "added = vec2(1.0, 2.0);\n");
+
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 0};
+    fld_parser parser = {0};
+    fld_parser_set_allocator(&parser, &chunks);
+    EXPECT_TRUE(fld_parse_ex(&parser, before, strlen(before), NULL, 0, FLD_PARSE_DEFAULT));
+
+    fld_object* window = fld_get_field(parser.root, "window");
+    fld_object* key_7 = fld_get_field(parser.root, "key_7");
+    uint32_t generation = parser.generation;
+
+    fld_changes changes;
+    EXPECT_TRUE(fld_reparse(&parser, after, strlen(after), &changes));
+    EXPECT_TRUE(parser.generation != generation);
+    EXPECT_EQ(changes.count, 3);
+    EXPECT_EQ(changes.reused, 22);
+
+    const fld_change* change = find_change(&changes, "volume");
+    EXPECT_TRUE(change && change->type == FLD_CHANGE_MODIFIED);
+    change = find_change(&changes, "added");
+    EXPECT_TRUE(change && change->type == FLD_CHANGE_ADDED);
+    change = find_change(&changes, "removed");
+    EXPECT_TRUE(change && change->type == FLD_CHANGE_REMOVED);
+
+    // Unchanged subtrees are the very same objects
+    EXPECT_TRUE(fld_get_field(parser.root, "window") == window);
+    EXPECT_TRUE(fld_get_field(parser.root, "key_7") == key_7);
+    EXPECT_TRUE(window->parent == NULL);
+
+    // The new tree is in source order and fully usable
+    EXPECT_TRUE(fld_string_view_eq(parser.root->key, "tags"));
+    float volume;
+    EXPECT_TRUE(fld_get_float(parser.root, "volume", &volume));
+    EXPECT_EQ_FLOAT(volume, 0.75f);
+    int width;
+    EXPECT_TRUE(fld_get_int(parser.root, "window.width", &width));
+    EXPECT_EQ_INT(width, 1280);
+    int value;
+    EXPECT_TRUE(fld_get_int(parser.root, "key_19", &value));
+    EXPECT_EQ_INT(value, 19);
+    EXPECT_FALSE(fld_has_field(parser.root, "removed"));
+
+    // Reloading the same text again changes nothing
+    EXPECT_TRUE(fld_reparse(&parser, after, strlen(after), &changes));
+    EXPECT_EQ(changes.count, 0);
+    EXPECT_EQ(changes.reused, 24);
+
+    // A broken reload keeps the tree as it was
+    fld_object* root = parser.root;
+    const char* broken = "volume = 1.0;\nwindow = { width = ; };\n";
+    EXPECT_FALSE(fld_reparse(&parser, broken, strlen(broken), &changes));
+    EXPECT_EQ(parser.last_error.line, 2);
+    EXPECT_TRUE(parser.root == root);
+    EXPECT_TRUE(fld_get_float(parser.root, "volume", &volume));
+    EXPECT_EQ_FLOAT(volume, 0.75f);
+
+    // A matching hash alone doesn't keep a field, its text has to match too
+    const char* collided = "volume = 0.5;";
+    fld_get_field(parser.root, "volume")->value.content_hash = _content_hash(collided, strlen(collided));
+    EXPECT_TRUE(fld_reparse(&parser, collided, strlen(collided), &changes));
+    change = find_change(&changes, "volume");
+    EXPECT_TRUE(change && change->type == FLD_CHANGE_MODIFIED);
+    EXPECT_TRUE(fld_get_float(parser.root, "volume", &volume));
+    EXPECT_EQ_FLOAT(volume, 0.5f);
+
+    fld_parser_release(&parser);
+    EXPECT_EQ_INT(counter.freed, counter.allocated);
+    return true;
+}
+
+TEST(Parser, StreamingParse) {
+    const char* source =
+        "// Streamed in pieces\n"
+        "name = \"split; /* not a comment */\";\n"
+        "/* block ; comment */ count = 123456; big = 9000000000;\n"
+        "ratio = -1.25e-3; flag = true;\n"
+        "window = { size = vec2(1280.0, 720.0); tags = [\"a\", \"b;\"]; };\n"
+        "values = [1, 2, 3, 4000000000];\n"
+        "// trailing comment";
+    size_t length = strlen(source);
+
+    static uint8_t whole_memory[8192];
+    fld_parser whole = {0};
+    EXPECT_TRUE(fld_parse(&whole, source, whole_memory, sizeof(whole_memory)));
+
+    // Every piece size splits strings, numbers and comments somewhere
+    static uint8_t memory[8192];
+    for (size_t piece = 1; piece <= 16; ++piece) {
+        fld_parser parser = {0};
+        fld_stream stream;
+        fld_stream_begin(&stream, &parser, memory, sizeof(memory));
+        for (size_t i = 0; i < length; i += piece) {
+            size_t n = length - i < piece ? length - i : piece;
+            EXPECT_TRUE(fld_stream_feed(&stream, source + i, n));
+        }
+        EXPECT_TRUE(fld_stream_end(&stream));
+        EXPECT_TRUE(_fields_equal(parser.root, whole.root));
+
+        for (fld_object *a = parser.root, *b = whole.root; a && b; a = a->next, b = b->next) {
+            EXPECT_EQ(a->value.content_hash, b->value.content_hash);
+        }
+    }
+
+    // Without memory up front the pending text moves between chunks
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 256};
+    fld_parser grown = {0};
+    fld_parser_set_allocator(&grown, &chunks);
+    fld_stream stream;
+    fld_stream_begin(&stream, &grown, NULL, 0);
+    for (size_t i = 0; i < length; i += 5) {
+        EXPECT_TRUE(fld_stream_feed(&stream, source + i, length - i < 5 ? length - i : 5));
+    }
+    EXPECT_TRUE(fld_stream_end(&stream));
+    EXPECT_TRUE(_fields_equal(grown.root, whole.root));
+    EXPECT_TRUE(counter.allocated > 1);
+    fld_parser_release(&grown);
+    EXPECT_EQ_INT(counter.freed, counter.allocated);
+
+    int64_t big;
+    EXPECT_TRUE(fld_get_int64(whole.root, "big", &big));
+    EXPECT_TRUE(big == 9000000000LL);
+
+    // Errors point at the same place as in a whole parse
+    const char* broken = "a = 1;\n  b = \"ok\"; c = ;\n";
+    length = strlen(broken);
+    EXPECT_FALSE(fld_parse(&whole, broken, whole_memory, sizeof(whole_memory)));
+    for (size_t piece = 1; piece <= 4; ++piece) {
+        fld_parser parser = {0};
+        fld_stream stream;
+        fld_stream_begin(&stream, &parser, memory, sizeof(memory));
+        bool ok = true;
+        for (size_t i = 0; i < length && ok; i += piece) {
+            ok = fld_stream_feed(&stream, broken + i, length - i < piece ? length - i : piece);
+        }
+        EXPECT_FALSE(ok && fld_stream_end(&stream));
+        EXPECT_EQ(parser.last_error.code, whole.last_error.code);
+        EXPECT_EQ(parser.last_error.line, whole.last_error.line);
+        EXPECT_EQ(parser.last_error.column, whole.last_error.column);
+    }
+
+    // A field that never ends is reported at the end
+    fld_parser parser = {0};
+    fld_stream_begin(&stream, &parser, memory, sizeof(memory));
+    EXPECT_TRUE(fld_stream_feed(&stream, "a = [1, 2", 9));
+    EXPECT_FALSE(fld_stream_end(&stream));
+    return true;
+}
+
+typedef struct {
+    char log[512];
+    size_t length;
+    const char* stop_at;
+    bool stop_next;
+    int found;
+} event_log;
+
+static void log_event(event_log* log, const char* text, size_t length) {
+    memcpy(log->log + log->length, text, length);
+    log->length += length;
+    log->log[log->length++] = ' ';
+    log->log[log->length] = '\0';
+}
+
+static bool on_key(void* user, fld_string_view key) {
+    event_log* log = (event_log*)user;
+    log_event(log, key.start, key.length);
+    log->stop_next = log->stop_at && fld_string_view_eq(key, log->stop_at);
+    return true;
+}
+
+static bool on_value(void* user, const fld_value* value) {
+    event_log* log = (event_log*)user;
+    char text[32];
+    int length = 0;
+    switch (value->type) {
+        case FLD_VALUE_INT: length = sprintf(text, "%d", value->as.integer); break;
+        case FLD_VALUE_INT64: length = sprintf(text, "%lld", (long long)value->as.int64); break;
+        case FLD_VALUE_STRING: length = sprintf(text, "%.*s", value->as.string.length, value->as.string.start); break;
+        default: length = sprintf(text, "v%d", (int)value->type); break;
+    }
+    log_event(log, text, (size_t)length);
+    if (log->stop_next) log->found = value->as.integer;
+    return !log->stop_next;
+}
+
+static bool on_object_begin(void* user) { log_event((event_log*)user, "{", 1); return true; }
+static bool on_object_end(void* user) { log_event((event_log*)user, "}", 1); return true; }
+static bool on_array_begin(void* user) { log_event((event_log*)user, "[", 1); return true; }
+static bool on_array_end(void* user) { log_event((event_log*)user, "]", 1); return true; }
+
+TEST(Parser, EventCallbacks) {
+    const char* source =
+        "name = \"demo\";\n"
+        "window = { width = 640; inner = {}; };\n"
+        "ids = [1, 5000000000, 3];\n"
+        "empty = [];\n"
+        "needle = 42;\n"
+        "after = true;\n";
+
+    event_log log = {0};
+    fld_event_handler handler = {&log, on_key, on_value, on_object_begin, on_object_end, on_array_begin, on_array_end, NULL};
+    fld_error error;
+    EXPECT_TRUE(fld_parse_events(source, strlen(source), &handler, &error));
+    EXPECT_EQ(error.code, FLD_ERROR_NONE);
+    EXPECT_TRUE(strcmp(log.log,
+        "name demo window { width 640 inner { } } ids [ 1 5000000000 3 ] empty [ ] needle 42 after v4 ") == 0);
+
+    // Stopping early isn't an error
+    memset(&log, 0, sizeof(log));
+    log.stop_at = "needle";
+    EXPECT_FALSE(fld_parse_events(source, strlen(source), &handler, &error));
+    EXPECT_EQ(error.code, FLD_ERROR_NONE);
+    EXPECT_EQ_INT(log.found, 42);
+    EXPECT_TRUE(strstr(log.log, "after") == NULL);
+
+    // Only some callbacks, and the same errors as a tree parse
+    fld_event_handler keys_only = {&log, on_key, NULL, NULL, NULL, NULL, NULL, NULL};
+    const char* broken = "a = 1;\nb = [1, \"two\"];\n";
+    EXPECT_FALSE(fld_parse_events(broken, strlen(broken), &keys_only, &error));
+
+    static uint8_t memory[1024];
+    fld_parser parser = {0};
+    EXPECT_FALSE(fld_parse(&parser, broken, memory, sizeof(memory)));
+    EXPECT_EQ(error.code, FLD_ERROR_ARRAY_TYPE_MISMATCH);
+    EXPECT_EQ(error.code, parser.last_error.code);
+    EXPECT_EQ(error.line, parser.last_error.line);
+    EXPECT_EQ(error.column, parser.last_error.column);
+    return true;
+}
+
+TEST(Parser, BinaryImage) {
+    char source[4096];
+    int written = sprintf(source,
+        "title = \"Game\";\n"
+        "window = { size = vec2(1280.0, 720.0); flags = { vsync = true; }; };\n"
+        "names = [\"one\", \"two\", \"three\"];\n"
+        "ids = [1, 5000000000];\n"
+        "empty = [];\n"
+        "nothing = {};\n");
+    for (int i = 0; i < 24; ++i) {
+        written += sprintf(source + written, "key_%d = %d;\n", i, i);
+    }
+
+    static uint8_t memory[16384];
+    fld_parser parser = {0};
+    EXPECT_TRUE(fld_parse(&parser, source, memory, sizeof(memory)));
+    EXPECT_TRUE(parser.root->index != NULL);
+
+    size_t size = fld_serialized_size(parser.root);
+    uint8_t* image = (uint8_t*)malloc(size);
+    EXPECT_EQ(fld_serialize(parser.root, image, size - 1), 0);
+    EXPECT_EQ(fld_serialize(parser.root, image, size), size);
+
+    // The image holds no pointers, so it loads from anywhere
+    uint8_t* moved = (uint8_t*)malloc(size);
+    memcpy(moved, image, size);
+    memset(memory, 0, sizeof(memory));
+
+    fld_parser loaded = {0};
+    EXPECT_TRUE(fld_load_binary(&loaded, moved, size));
+    EXPECT_TRUE(loaded.root->index != NULL);
+
+    fld_string_view title;
+    EXPECT_TRUE(fld_get_str_view(loaded.root, "title", &title));
+    EXPECT_TRUE(fld_string_view_eq(title, "Game"));
+    bool vsync;
+    EXPECT_TRUE(fld_get_bool(loaded.root, "window.flags.vsync", &vsync));
+    EXPECT_TRUE(vsync);
+    fld_object* flags = fld_get_field_by_path(loaded.root, "window.flags");
+    EXPECT_TRUE(flags && flags->parent && fld_string_view_eq(flags->parent->key, "window"));
+    int value;
+    EXPECT_TRUE(fld_get_int(loaded.root, "key_23", &value));
+    EXPECT_EQ_INT(value, 23);
+    fld_object* names = fld_get_field(loaded.root, "names");
+    EXPECT_TRUE(fld_string_view_eq(((fld_string_view*)names->value.as.array.items)[2], "three"));
+
+    // Same tree as a fresh parse
+    fld_parser fresh = {0};
+    EXPECT_TRUE(fld_parse(&fresh, source, memory, sizeof(memory)));
+    EXPECT_TRUE(_fields_equal(loaded.root, fresh.root));
+
+    // Images that don't check out are refused
+    memcpy(moved, image, size);
+    EXPECT_FALSE(fld_load_binary(&loaded, moved, size - 1));
+    EXPECT_EQ(loaded.last_error.code, FLD_ERROR_INVALID_IMAGE);
+    EXPECT_TRUE(loaded.root == NULL);
+
+    memcpy(moved, image, size);
+    ((fld_binary_header*)moved)->magic ^= 1;
+    EXPECT_FALSE(fld_load_binary(&loaded, moved, size));
+
+    memcpy(moved, image, size);
+    fld_object* first = (fld_object*)(moved + ((fld_binary_header*)moved)->root);
+    first->next = (fld_object*)(uintptr_t)(size * 2);
+    EXPECT_FALSE(fld_load_binary(&loaded, moved, size));
+
+    // The index slots are rebuilt on load, so corrupt ones can't send lookups in circles
+    memcpy(moved, image, size);
+    first = (fld_object*)(moved + ((fld_binary_header*)moved)->root);
+    fld_index* index = (fld_index*)(moved + (uintptr_t)first->index);
+    uintptr_t* slots = (uintptr_t*)(moved + (uintptr_t)index->fields);
+    uint32_t* hashes = (uint32_t*)(moved + (uintptr_t)index->hashes);
+    for (uint32_t i = 0; i < index->capacity; ++i) {
+        slots[i] = (uintptr_t)((uint8_t*)first - moved);
+        hashes[i] = 0;
+    }
+    index->count = 0;
+    EXPECT_TRUE(fld_load_binary(&loaded, moved, size));
+    EXPECT_TRUE(fld_get_int(loaded.root, "key_23", &value));
+    EXPECT_EQ_INT(value, 23);
+    EXPECT_NULL(fld_get_field(loaded.root, "missing"));
+    EXPECT_TRUE(_fields_equal(loaded.root, fresh.root));
+
+    // An index without an empty slot is refused
+    memcpy(moved, image, size);
+    index->capacity = 16;
+    EXPECT_FALSE(fld_load_binary(&loaded, moved, size));
+
+    // An empty tree makes an image too
+    uint64_t header[8];
+    EXPECT_EQ(fld_serialize(NULL, header, sizeof(header)), sizeof(fld_binary_header));
+    EXPECT_TRUE(fld_load_binary(&loaded, header, sizeof(header)));
+    EXPECT_TRUE(loaded.root == NULL);
+
+    free(moved);
+    free(image);
+    return true;
+}
+
+TEST(Parser, CompactTree) {
+    const char* source =
+        "name = \"compact\";\n"
+        "window = { size = vec3(1.0, 2.0, 3.0); inner = { depth = 2; }; empty = {}; };\n"
+        "tags = [\"x\", \"yz\"];\n"
+        "ids = [7, 5000000000];\n"
+        "ratio = 0.5;\n"
+        "on = true;\n";
+
+    static uint8_t memory[4096];
+    fld_parser parser = {0};
+    EXPECT_TRUE(fld_parse(&parser, source, memory, sizeof(memory)));
+
+    size_t size = fld_compact_size(parser.root);
+    uint64_t compact_memory[128];
+    EXPECT_TRUE(size <= sizeof(compact_memory));
+    fld_compact_tree tree;
+    EXPECT_FALSE(fld_compact(parser.root, compact_memory, size - 1, &tree));
+    EXPECT_TRUE(fld_compact(parser.root, compact_memory, size, &tree));
+    EXPECT_EQ(tree.count, 10);
+
+    // Pre-order, the same order as a recursive iteration
+    fld_iterator iter;
+    fld_iter_init(&iter, parser.root, FLD_ITER_RECURSIVE);
+    uint32_t node = 0;
+    for (fld_object* field = fld_iter_next(&iter); field; field = fld_iter_next(&iter), ++node) {
+        EXPECT_TRUE(node < tree.count);
+        fld_string_view key = fld_compact_key(&tree, node);
+        EXPECT_TRUE(key.length == field->key.length && memcmp(key.start, field->key.start, key.length) == 0);
+        EXPECT_EQ(tree.types[node], field->value.type);
+    }
+    EXPECT_EQ(node, tree.count);
+
+    // Only the tree's own memory is used from here on
+    memset(memory, 0, sizeof(memory));
+
+    node = fld_compact_find(&tree, "window.inner.depth");
+    EXPECT_TRUE(node != FLD_COMPACT_NONE);
+    EXPECT_EQ_INT(tree.payloads[node].integer, 2);
+    EXPECT_TRUE(fld_string_view_eq(fld_compact_key(&tree, tree.parents[node]), "inner"));
+
+    node = fld_compact_find(&tree, "window.size");
+    EXPECT_EQ_FLOAT(fld_compact_vec(&tree, node)[2], 3.0f);
+    EXPECT_TRUE(fld_string_view_eq(fld_compact_key(&tree, tree.next[node]), "inner"));
+
+    node = fld_compact_find(&tree, "name");
+    EXPECT_TRUE(fld_string_view_eq(fld_compact_string(&tree, node), "compact"));
+
+    size_t count;
+    node = fld_compact_find(&tree, "tags");
+    const fld_string_view* tags = (const fld_string_view*)fld_compact_array(&tree, node, &count);
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(tree.item_types[node], FLD_VALUE_STRING);
+    EXPECT_TRUE(fld_string_view_eq(tags[1], "yz"));
+
+    node = fld_compact_find(&tree, "ids");
+    EXPECT_TRUE(((const int64_t*)fld_compact_array(&tree, node, &count))[1] == 5000000000LL);
+
+    EXPECT_TRUE(fld_compact_find(&tree, "window.empty.any") == FLD_COMPACT_NONE);
+    EXPECT_TRUE(fld_compact_find(&tree, "missing") == FLD_COMPACT_NONE);
+    EXPECT_TRUE(tree.next[fld_compact_find(&tree, "on")] == FLD_COMPACT_NONE);
+    return true;
+}
+
+TEST(Parser, BatchParse) {
+    enum { DOCUMENTS = 64 };
+    static char sources[DOCUMENTS][1024];
+    static uint8_t memory[DOCUMENTS][4096];
+    static fld_parser parsers[DOCUMENTS];
+    fld_document documents[DOCUMENTS];
+
+    for (int i = 0; i < DOCUMENTS; ++i) {
+        int written = sprintf(sources[i], "id = %d;\nsettings = { level = { depth = %d; }; };\n", i, i * 2);
+        for (int j = 0; j < i % 17; ++j) {
+            written += sprintf(sources[i] + written, "extra_%d = [%d, %d, %d];\n", j, i, j, i + j);
+        }
+        if (i == 41) {
+            sprintf(sources[i] + written, "broken = ;\n");
+        }
+
+        documents[i].source = sources[i];
+        documents[i].length = strlen(sources[i]);
+        documents[i].memory = memory[i];
+        documents[i].size = sizeof(memory[i]);
+        documents[i].flags = FLD_PARSE_DEFAULT;
+        memset(&parsers[i], 0, sizeof(fld_parser));
+    }
+
+    for (int workers = 1; workers <= 8; workers *= 2) {
+        EXPECT_FALSE(fld_parse_batch(parsers, documents, DOCUMENTS, workers));
+
+        for (int i = 0; i < DOCUMENTS; ++i) {
+            if (i == 41) {
+                EXPECT_EQ(parsers[i].last_error.code, FLD_ERROR_UNEXPECTED_TOKEN);
+                continue;
+            }
+            EXPECT_EQ(parsers[i].last_error.code, FLD_ERROR_NONE);
+
+            int id, depth;
+            EXPECT_TRUE(fld_get_int(parsers[i].root, "id", &id));
+            EXPECT_EQ_INT(id, i);
+            EXPECT_TRUE(fld_get_int(parsers[i].root, "settings.level.depth", &depth));
+            EXPECT_EQ_INT(depth, i * 2);
+        }
+    }
+
+    EXPECT_TRUE(fld_parse_batch(parsers, documents, 41, 4));
+    EXPECT_TRUE(fld_parse_batch(parsers, documents, 0, 4));
+
+    // Paths are walked in place, without a copy or strtok
+    int depth;
+    EXPECT_TRUE(fld_get_int(parsers[3].root, ".settings..level.depth.", &depth));
+    EXPECT_EQ_INT(depth, 6);
+    EXPECT_FALSE(fld_get_int(parsers[3].root, "...", &depth));
+    char long_path[300];
+    memset(long_path, '.', sizeof(long_path));
+    memcpy(long_path + 200, "id", 3);
+    EXPECT_TRUE(fld_get_int(parsers[3].root, long_path, &depth));
+    EXPECT_EQ_INT(depth, 3);
+    return true;
+}
+
+TEST(Parser, ParallelParse) {
+    size_t capacity = 64 * 1024;
+    char* source = (char*)malloc(capacity);
+    int written = 0;
+    for (int i = 0; i < 400; ++i) {
+        written += sprintf(source + written,
+            i % 3 == 0 ? "field_%d = { name = \"a;b{c\"; values = [%d, 2, 3]; }; // ; }\n"
+                       : "field_%d = %d; /* ; { */ ", i, i);
+    }
+
+    static uint8_t memory[256 * 1024];
+    fld_parser whole = {0};
+    EXPECT_TRUE(fld_parse_ex(&whole, source, (size_t)written, memory, sizeof(memory), FLD_PARSE_DEFAULT));
+
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 0};
+    fld_parser parser = {0};
+    fld_parser_set_allocator(&parser, &chunks);
+    for (int workers = 1; workers <= 8; workers *= 2) {
+        EXPECT_TRUE(fld_parse_parallel(&parser, source, (size_t)written, FLD_PARSE_DEFAULT, workers));
+        EXPECT_TRUE(_fields_equal(parser.root, whole.root));
+        EXPECT_TRUE(parser.root->index != NULL);
+
+        int values;
+        EXPECT_TRUE(fld_get_int(parser.root, "field_397", &values));
+        EXPECT_EQ_INT(values, 397);
+        EXPECT_TRUE(fld_get_memory_used(&parser) > (size_t)written);
+    }
+
+    // Errors are in whole-source coordinates, also mid-line
+    strstr(source, "field_250 = ")[12] = ';';
+    EXPECT_FALSE(fld_parse_ex(&whole, source, (size_t)written, memory, sizeof(memory), FLD_PARSE_DEFAULT));
+    EXPECT_FALSE(fld_parse_parallel(&parser, source, (size_t)written, FLD_PARSE_BORROW_SOURCE, 4));
+    EXPECT_EQ(parser.last_error.code, whole.last_error.code);
+    EXPECT_EQ(parser.last_error.line, whole.last_error.line);
+    EXPECT_EQ(parser.last_error.column, whole.last_error.column);
+    EXPECT_TRUE(whole.last_error.line > 1 && whole.last_error.column > 1);
+    EXPECT_TRUE(parser.root == NULL);
+
+    fld_parser_release(&parser);
+    EXPECT_EQ_INT(counter.freed, counter.allocated);
+
+    // Without a chunk allocator one using malloc is set
+    fld_parser plain = {0};
+    EXPECT_TRUE(fld_parse_parallel(&plain, "a = 1; b = 2;", 13, FLD_PARSE_DEFAULT, 2));
+    EXPECT_TRUE(plain.root && plain.root->next && !plain.root->next->next);
+    fld_parser_release(&plain);
+
+    free(source);
+    return true;
+}
+
+typedef struct {
+    int width;
+    int height;
+    bool fullscreen;
+    float gamma;
+    float position[3];
+    fld_string_view title;
+    int64_t seed;
+    int missing;
+    int values[70];
+} schema_config;
+
+TEST(Parser, SchemaFill) {
+    char source[4096];
+    int written = sprintf(source,
+        "window = { width = 1920; height = 1080; fullscreen = true; title = \"Main\"; };\n"
+        "render = { gamma = 2.2; camera = { position = vec3(1.0, 2.0, 3.0); }; };\n"
+        "seed = 42;\n"
+        "values = {");
+    for (int i = 0; i < 70; ++i) {
+        written += sprintf(source + written, " v%d = %d;", i, i * 10);
+    }
+    sprintf(source + written, " };\n");
+
+    static uint8_t memory[16384];
+    fld_parser parser = {0};
+    EXPECT_TRUE(fld_parse(&parser, source, memory, sizeof(memory)));
+
+    static char value_paths[70][16];
+    fld_schema_field fields[80] = {
+        {"window.width", FLD_VALUE_INT, offsetof(schema_config, width), FLD_SCHEMA_REQUIRED},
+        {"window.height", FLD_VALUE_INT, offsetof(schema_config, height), FLD_SCHEMA_REQUIRED},
+        {"window.fullscreen", FLD_VALUE_BOOL, offsetof(schema_config, fullscreen), 0},
+        {"window.title", FLD_VALUE_STRING, offsetof(schema_config, title), 0},
+        {"render.gamma", FLD_VALUE_FLOAT, offsetof(schema_config, gamma), 0},
+        {"render.camera.position", FLD_VALUE_VEC3, offsetof(schema_config, position), 0},
+        {"seed", FLD_VALUE_INT64, offsetof(schema_config, seed), FLD_SCHEMA_REQUIRED},
+        {"window.missing", FLD_VALUE_INT, offsetof(schema_config, missing), 0},
+    };
+    uint32_t count = 8;
+    for (int i = 0; i < 70; ++i, ++count) {
+        sprintf(value_paths[i], "values.v%d", i);
+        fields[count].path = value_paths[i];
+        fields[count].type = FLD_VALUE_INT;
+        fields[count].offset = offsetof(schema_config, values) + i * sizeof(int);
+        fields[count].flags = 0;
+    }
+
+    // Shared prefixes share nodes: window, render, camera, values and one per leaf
+    fld_schema_node nodes[128];
+    fld_schema schema;
+    EXPECT_FALSE(fld_schema_compile(&schema, fields, count, nodes, 10));
+    EXPECT_TRUE(fld_schema_compile(&schema, fields, count, nodes, 128));
+    EXPECT_EQ(schema.node_count, 4 + count);
+
+    schema_config config;
+    memset(&config, 0, sizeof(config));
+    config.missing = -1;
+    uint64_t missing[2];
+    EXPECT_TRUE(fld_schema_fill(&schema, parser.root, &config, missing));
+    EXPECT_EQ_INT(config.width, 1920);
+    EXPECT_EQ_INT(config.height, 1080);
+    EXPECT_TRUE(config.fullscreen);
+    EXPECT_TRUE(fld_string_view_eq(config.title, "Main"));
+    EXPECT_EQ_FLOAT(config.gamma, 2.2f);
+    EXPECT_EQ_FLOAT(config.position[2], 3.0f);
+    EXPECT_TRUE(config.seed == 42);
+    EXPECT_EQ_INT(config.values[69], 690);
+    EXPECT_EQ_INT(config.missing, -1);
+    EXPECT_TRUE(missing[0] == ((uint64_t)1 << 7));
+    EXPECT_TRUE(missing[1] == 0);
+
+    // A required value of the wrong type fails the fill
+    fields[1].type = FLD_VALUE_FLOAT;
+    EXPECT_TRUE(fld_schema_compile(&schema, fields, count, nodes, 128));
+    EXPECT_FALSE(fld_schema_fill(&schema, parser.root, &config, missing));
+    EXPECT_TRUE(missing[0] == (((uint64_t)1 << 7) | ((uint64_t)1 << 1)));
+
+    // Paths listed twice and unsupported types are refused
+    fields[1] = fields[0];
+    EXPECT_FALSE(fld_schema_compile(&schema, fields, count, nodes, 128));
+    fields[1].path = "window.height";
+    fields[1].type = FLD_VALUE_OBJECT;
+    EXPECT_FALSE(fld_schema_compile(&schema, fields, count, nodes, 128));
+    return true;
+}
+
+TEST(Parser, ArenaReuse) {
+    char large[4096];
+    int written = sprintf(large, "numbers = [0");
+    for (int i = 1; i < 300; ++i) {
+        written += sprintf(large + written, ", %d", i);
+    }
+    written += sprintf(large + written, "];\nname = \"large\";\n");
+    const char* small = "name = \"small\"; count = 3;";
+
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 512};
+
+    // Some caller memory and chunks on top of it
+    char memory[256];
+    fld_parser parser = {0};
+    fld_parser_set_allocator(&parser, &chunks);
+    EXPECT_TRUE(fld_parse_ex(&parser, large, (size_t)written, memory, sizeof(memory), FLD_PARSE_DEFAULT));
+    size_t large_used = fld_get_memory_used(&parser);
+    int allocated = counter.allocated;
+    EXPECT_TRUE(allocated > 0);
+    EXPECT_TRUE(fld_get_memory_peak(&parser) == large_used);
+
+    // Reset keeps every chunk, parsing again fetches nothing
+    fld_path name_path;
+    fld_binding name;
+    EXPECT_TRUE(fld_path_compile(&name_path, "name"));
+    EXPECT_NOT_NULL(fld_bind(&name, &name_path, &parser));
+    fld_parser_reset(&parser);
+    EXPECT_TRUE(parser.root == NULL);
+    EXPECT_TRUE(fld_get_memory_used(&parser) == 0);
+    EXPECT_TRUE(fld_binding_get(&name) == NULL);
+    EXPECT_EQ_INT(counter.freed, 0);
+
+    for (int round = 0; round < 3; ++round) {
+        EXPECT_TRUE(fld_parse_reuse(&parser, large, (size_t)written, FLD_PARSE_DEFAULT));
+        EXPECT_EQ_INT(counter.allocated, allocated);
+        EXPECT_TRUE(fld_get_memory_used(&parser) == large_used);
+
+        size_t count;
+        EXPECT_TRUE(fld_get_array_size(parser.root, "numbers", &count));
+        EXPECT_EQ(count, 300);
+        EXPECT_TRUE(fld_string_view_eq(fld_binding_get(&name)->value.as.string, "large"));
+
+        // Small documents fit in the caller's memory, the peak stays
+        EXPECT_TRUE(fld_parse_reuse(&parser, small, strlen(small), FLD_PARSE_DEFAULT));
+        EXPECT_TRUE((uint8_t*)parser.root >= (uint8_t*)memory && (uint8_t*)parser.root < (uint8_t*)memory + sizeof(memory));
+        EXPECT_TRUE(fld_string_view_eq(fld_binding_get(&name)->value.as.string, "small"));
+        EXPECT_TRUE(fld_get_memory_peak(&parser) == large_used);
+    }
+    EXPECT_EQ_INT(counter.allocated, allocated);
+
+    // Failing parses count towards the peak too
+    EXPECT_FALSE(fld_parse_reuse(&parser, "a = ;", 5, FLD_PARSE_DEFAULT));
+    EXPECT_TRUE(fld_get_memory_peak(&parser) == large_used);
+
+    // Spare chunks are handed back with the rest
+    fld_parser_reset(&parser);
+    fld_parser_release(&parser);
+    EXPECT_EQ_INT(counter.freed, counter.allocated);
+
+    // A block sized by the peak needs no chunks at all
+    void* block = malloc(fld_get_memory_peak(&parser));
+    fld_parser_set_allocator(&parser, NULL);
+    EXPECT_TRUE(fld_parse_ex(&parser, large, (size_t)written, block, fld_get_memory_peak(&parser), FLD_PARSE_DEFAULT));
+    EXPECT_EQ_INT(counter.allocated, allocated);
+    free(block);
+    return true;
+}
+
+TEST(Parser, Overlay) {
+    const char* sources[4] = {
+        "window = { width = 800; height = 600; title = \"App\"; }; volume = 0.5; mods = { a = 1; };",
+        "window = { width = 1280; }; gpu = \"fast\";",
+        "mods = \"none\"; window = { fullscreen = true; };",
+        "window = { height = 720; };",
+    };
+    fld_parser parsers[4] = {0};
+    void* memory[4];
+    fld_overlay_entry cache[16];
+    fld_overlay overlay;
+    fld_overlay_init(&overlay, cache, 16);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(setup_parser(&parsers[i], sources[i], &memory[i]));
+        EXPECT_TRUE(fld_overlay_push(&overlay, &parsers[i]));
+    }
+
+    // Objects merge, the topmost layer wins
+    fld_object* width = fld_overlay_get(&overlay, "window.width");
+    EXPECT_NOT_NULL(width);
+    EXPECT_EQ_INT(width->value.as.integer, 1280);
+    EXPECT_EQ_INT(fld_overlay_get(&overlay, "window.height")->value.as.integer, 720);
+    EXPECT_TRUE(fld_string_view_eq(fld_overlay_get(&overlay, "window..title")->value.as.string, "App"));
+    EXPECT_TRUE(fld_overlay_get(&overlay, "window.fullscreen")->value.as.boolean);
+    EXPECT_EQ_FLOAT(fld_overlay_get(&overlay, "volume")->value.as.float_val, 0.5f);
+    EXPECT_TRUE(fld_overlay_get(&overlay, "window.width") == width);
+
+    // A value that isn't an object hides the object below it
+    EXPECT_EQ(fld_overlay_get(&overlay, "mods")->value.type, FLD_VALUE_STRING);
+    EXPECT_NULL(fld_overlay_get(&overlay, "mods.a"));
+    EXPECT_NULL(fld_overlay_get(&overlay, "window.depth"));
+    EXPECT_NULL(fld_overlay_get(&overlay, "volume.x"));
+
+    // Every key once, in the lowest layer's order
+    const char* top_keys[] = {"window", "volume", "mods", "gpu"};
+    fld_overlay_iter iter;
+    fld_overlay_iter_init(&iter, &overlay, NULL);
+    int count = 0;
+    for (fld_object* field; (field = fld_overlay_iter_next(&iter)) != NULL; ++count) {
+        EXPECT_TRUE(count < 4 && fld_string_view_eq(field->key, top_keys[count]));
+    }
+    EXPECT_EQ_INT(count, 4);
+
+    const char* window_keys[] = {"width", "height", "title", "fullscreen"};
+    int window_values[] = {1280, 720};
+    fld_overlay_iter_init(&iter, &overlay, "window");
+    count = 0;
+    for (fld_object* field; (field = fld_overlay_iter_next(&iter)) != NULL; ++count) {
+        EXPECT_TRUE(count < 4 && fld_string_view_eq(field->key, window_keys[count]));
+        if (count < 2) EXPECT_EQ_INT(field->value.as.integer, window_values[count]);
+    }
+    EXPECT_EQ_INT(count, 4);
+    fld_overlay_iter_init(&iter, &overlay, "mods");
+    EXPECT_NULL(fld_overlay_iter_next(&iter));
+
+    // Flattened into one compact tree
+    size_t size = fld_flatten_size(&overlay);
+    void* flat = malloc(size);
+    fld_compact_tree tree;
+    EXPECT_TRUE(fld_flatten(&overlay, flat, size, &tree));
+    EXPECT_EQ_INT((int)tree.count, 8);
+    uint32_t node = fld_compact_find(&tree, "window.width");
+    EXPECT_TRUE(node != FLD_COMPACT_NONE && tree.payloads[node].integer == 1280);
+    node = fld_compact_find(&tree, "window.title");
+    EXPECT_TRUE(node != FLD_COMPACT_NONE && fld_string_view_eq(fld_compact_string(&tree, node), "App"));
+    EXPECT_EQ_INT((int)tree.payloads[fld_compact_find(&tree, "window")].children, 4);
+    EXPECT_TRUE(fld_compact_find(&tree, "mods.a") == FLD_COMPACT_NONE);
+    EXPECT_FALSE(fld_flatten(&overlay, flat, size - 1, &tree));
+
+    // Parsing a layer again drops what the cache remembered
+    free(memory[2]);
+    EXPECT_TRUE(setup_parser(&parsers[2], "window = 5;", &memory[2]));
+    EXPECT_NULL(fld_overlay_get(&overlay, "window.width"));
+    EXPECT_EQ_INT(fld_overlay_get(&overlay, "window.height")->value.as.integer, 720);
+    EXPECT_NOT_NULL(fld_overlay_get(&overlay, "mods.a"));
+
+    // A single cache slot still gives the right fields
+    fld_overlay small;
+    fld_overlay_init(&small, cache, 1);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(fld_overlay_push(&small, &parsers[i]));
+    }
+    for (int round = 0; round < 2; ++round) {
+        EXPECT_EQ_INT(fld_overlay_get(&small, "window.height")->value.as.integer, 720);
+        EXPECT_EQ_INT(fld_overlay_get(&small, "mods.a")->value.as.integer, 1);
+        EXPECT_TRUE(fld_string_view_eq(fld_overlay_get(&small, "gpu")->value.as.string, "fast"));
+    }
+
+    free(flat);
+    for (int i = 0; i < 4; ++i) {
+        cleanup_parser(memory[i]);
+    }
+    return true;
+}
+
+TEST(Parser, LazyObjects) {
+    const char* source =
+        "name = \"lazy\";\n"
+        "window = {\n"
+        "    size = vec2(1280.0, 720.0);\n"
+        "    inner = { depth = 2; list = [1, 2]; };\n"
+        "    title = \"{ not a brace }\"; // } nor this\n"
+        "};\n"
+        "audio = { volume = 0.5; };\n"
+        "broken = {\n"
+        "    ok = 1;\n"
+        "    bad = ;\n"
+        "};\n"
+        "after = 3;\n";
+
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 0};
+    fld_parser parser = {0};
+    fld_parser_set_allocator(&parser, &chunks);
+
+    // The bad field in an object nobody looked at yet doesn't fail the parse
+    EXPECT_TRUE(fld_parse_ex(&parser, source, strlen(source), NULL, 0, FLD_PARSE_LAZY_OBJECTS));
+    fld_object* window = fld_get_field(parser.root, "window");
+    fld_object* audio = fld_get_field(parser.root, "audio");
+    EXPECT_TRUE(window->value.type == FLD_VALUE_OBJECT);
+    EXPECT_NULL(window->value.as.object);
+    EXPECT_NOT_NULL(window->value.as.lazy.body);
+    int after = 0;
+    EXPECT_TRUE(fld_get_int(parser.root, "after", &after));
+    EXPECT_EQ_INT(after, 3);
+
+    // Parsed one level at a time, when first asked for
+    float x = 0.0f, y = 0.0f;
+    EXPECT_TRUE(fld_get_vec2(parser.root, "window.size", &x, &y));
+    EXPECT_EQ_FLOAT(x, 1280.0f);
+    EXPECT_NOT_NULL(window->value.as.object);
+    EXPECT_NULL(window->value.as.lazy.body);
+    EXPECT_NULL(audio->value.as.object);
+    fld_object* inner = fld_get_field(window->value.as.object, "inner");
+    EXPECT_NOT_NULL(inner->value.as.lazy.body);
+    EXPECT_TRUE(fld_string_view_eq(fld_get_field(window->value.as.object, "title")->value.as.string, "{ not a brace }"));
+    EXPECT_TRUE(fld_get_field_by_path(parser.root, "window.inner.depth")->parent == inner);
+
+    // Iterating goes into unread objects too
+    fld_iterator iter;
+    fld_iter_init(&iter, parser.root, FLD_ITER_RECURSIVE);
+    int count = 0;
+    while (fld_iter_next(&iter)) count++;
+    EXPECT_EQ_INT(count, 11);
+    EXPECT_NOT_NULL(audio->value.as.object);
+
+    // The error shows up on first access, with its place in the source
+    EXPECT_EQ_INT(parser.last_error.code, FLD_ERROR_UNEXPECTED_TOKEN);
+    EXPECT_EQ_INT(parser.last_error.line, 10);
+    EXPECT_NULL(fld_get_children(fld_get_field(parser.root, "broken")));
+
+    // Equal to the same source parsed eagerly
+    fld_parser eager = {0};
+    fld_parser_set_allocator(&eager, &chunks);
+    const char* good = "a = { b = { c = 1; }; d = [true]; }; e = {};";
+    EXPECT_TRUE(fld_parse_ex(&eager, good, strlen(good), NULL, 0, FLD_PARSE_DEFAULT));
+    EXPECT_TRUE(fld_parse_ex(&parser, good, strlen(good), NULL, 0, FLD_PARSE_LAZY_OBJECTS));
+    EXPECT_TRUE(_fields_equal(parser.root, eager.root));
+
+    // Images of a lazy tree have everything in them
+    EXPECT_TRUE(fld_parse_ex(&parser, good, strlen(good), NULL, 0, FLD_PARSE_LAZY_OBJECTS));
+    size_t size = fld_serialized_size(parser.root);
+    void* image = malloc(size);
+    EXPECT_EQ(fld_serialize(parser.root, image, size), size);
+    fld_parser loaded = {0};
+    EXPECT_TRUE(fld_load_binary(&loaded, image, size));
+    EXPECT_TRUE(_fields_equal(loaded.root, eager.root));
+    free(image);
+
+    // A measured buffer has room for every object to expand
+    const char* nested = "a = { x = 1; b = { y = 2; c = { z = 3; }; }; }; d = { w = 4; };";
+    fld_measurement m;
+    EXPECT_TRUE(fld_measure(nested, strlen(nested), FLD_PARSE_LAZY_OBJECTS, &m));
+    void* exact = malloc(m.bytes);
+    fld_parser fixed = {0};
+    EXPECT_TRUE(fld_parse_ex(&fixed, nested, strlen(nested), exact, m.bytes, FLD_PARSE_LAZY_OBJECTS));
+    int value = 0;
+    EXPECT_TRUE(fld_get_int(fixed.root, "a.b.c.z", &value));
+    EXPECT_EQ_INT(value, 3);
+    EXPECT_TRUE(fld_get_int(fixed.root, "d.w", &value));
+    EXPECT_EQ_INT(value, 4);
+    EXPECT_TRUE(fld_get_int(fixed.root, "a.x", &value));
+    EXPECT_EQ_INT(value, 1);
+    EXPECT_TRUE(fld_get_int(fixed.root, "a.b.y", &value));
+    EXPECT_EQ_INT(value, 2);
+    fld_close(&fixed);
+    free(exact);
+
+    fld_close(&eager);
+    fld_close(&parser);
+    EXPECT_EQ(counter.allocated, counter.freed);
+    return true;
+}
+
+typedef struct {
+    fld_parser parser;
+    char source[64];
+} shared_version;
+
+static void release_version(fld_parser* parser, void* user) {
+    fld_close(parser);
+    free(parser);
+    (*(int*)user)++;
+}
+
+static chunk_counter shared_chunks;
+
+static shared_version* make_version(int version) {
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &shared_chunks, 0};
+    shared_version* made = (shared_version*)calloc(1, sizeof(shared_version));
+    fld_parser_set_allocator(&made->parser, &chunks);
+    snprintf(made->source, sizeof(made->source), "version = %d; nested = { version = %d; };", version, version);
+    fld_parse_ex(&made->parser, made->source, strlen(made->source), NULL, 0, FLD_PARSE_LAZY_OBJECTS);
+    return made;
+}
+
+#if !defined(_WIN32)
+typedef struct {
+    fld_shared_config* shared;
+    int slot;
+    volatile long* done;
+    int bad;
+} shared_reader;
+
+static void* read_shared(void* arg) {
+    shared_reader* reader = (shared_reader*)arg;
+    int last = 0;
+    while (!_atomic_load(reader->done)) {
+        fld_parser* parser = fld_shared_acquire(reader->shared, reader->slot);
+        int version = 0, nested = -1;
+        fld_get_int(parser->root, "version", &version);
+        fld_get_int(parser->root, "nested.version", &nested);
+        fld_shared_release(reader->shared, reader->slot);
+
+        // Never an older config than before, never a torn one
+        if (version < last || version != nested) reader->bad++;
+        last = version;
+    }
+    return NULL;
+}
+#endif
+
+TEST(Parser, SharedConfig) {
+    int released = 0;
+    fld_shared_config shared;
+    fld_shared_init(&shared, &make_version(1)->parser, release_version, &released);
+
+    // Lazy objects were parsed before anyone could read them
+    fld_parser* first = fld_shared_acquire(&shared, 0);
+    EXPECT_NOT_NULL(fld_get_field(first->root, "nested")->value.as.object);
+
+    // A reader keeps its parser through a publish
+    EXPECT_TRUE(fld_shared_publish(&shared, &make_version(2)->parser));
+    EXPECT_EQ_INT(released, 0);
+    fld_parser* second = fld_shared_acquire(&shared, 1);
+    int version = 0;
+    EXPECT_TRUE(fld_get_int(first->root, "version", &version));
+    EXPECT_EQ_INT(version, 1);
+    EXPECT_TRUE(fld_get_int(second->root, "version", &version));
+    EXPECT_EQ_INT(version, 2);
+    fld_shared_release(&shared, 0);
+    EXPECT_EQ_INT(fld_shared_reclaim(&shared), 0);
+    EXPECT_EQ_INT(released, 1);
+
+    // Too many old parsers held up by one reader
+    for (int i = 0; i < FLD_SHARED_MAX_RETIRED; ++i) {
+        EXPECT_TRUE(fld_shared_publish(&shared, &make_version(3 + i)->parser));
+    }
+    shared_version* waiting = make_version(100);
+    EXPECT_FALSE(fld_shared_publish(&shared, &waiting->parser));
+    fld_shared_release(&shared, 1);
+    EXPECT_TRUE(fld_shared_publish(&shared, &waiting->parser));
+    // All of them, and the one it replaced since nobody is reading
+    EXPECT_EQ_INT(released, 2 + FLD_SHARED_MAX_RETIRED);
+
+#if !defined(_WIN32)
+    // Readers on threads while new versions come in
+    volatile long done = 0;
+    shared_reader readers[4];
+    pthread_t threads[4];
+    for (int i = 0; i < 4; ++i) {
+        readers[i].shared = &shared;
+        readers[i].slot = i;
+        readers[i].done = &done;
+        readers[i].bad = 0;
+        pthread_create(&threads[i], NULL, read_shared, &readers[i]);
+    }
+    for (int i = 0; i < 200; ++i) {
+        shared_version* next = make_version(101 + i);
+        while (!fld_shared_publish(&shared, &next->parser)) {}
+    }
+    _atomic_store(&done, 1);
+    for (int i = 0; i < 4; ++i) {
+        pthread_join(threads[i], NULL);
+        EXPECT_EQ_INT(readers[i].bad, 0);
+    }
+#endif
+
+    fld_shared_close(&shared);
+    EXPECT_EQ(shared_chunks.allocated, shared_chunks.freed);
+    EXPECT_NULL(fld_shared_acquire(&shared, 0));
+    fld_shared_release(&shared, 0);
+    return true;
+}
+
+TEST(Parser, ParseStats) {
+    const char* source =
+        "// Window settings\n"
+        "window = { size = vec2(1.0, 2.0); inner = { depth = 3; }; };\n"
+        "ids = [1, 2, 5000000000]; /* wide */\n"
+        "name = \"stats\";\n";
+
+    void* memory = NULL;
+    fld_parser parser = {0};
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+    const fld_parse_stats* stats = fld_get_parse_stats(&parser);
+
+    EXPECT_EQ(stats->tokens[TOKEN_KEY], 6);
+    EXPECT_EQ(stats->tokens[TOKEN_BRACE_LEFT], 2);
+    EXPECT_EQ(stats->tokens[TOKEN_INT], 4);
+    EXPECT_EQ(stats->tokens[TOKEN_EOF], 1);
+    EXPECT_EQ(stats->comment_bytes, strlen("// Window settings") + strlen("/* wide */"));
+    EXPECT_TRUE(stats->whitespace_bytes > 0);
+
+    EXPECT_EQ(stats->arrays, 1);
+    EXPECT_EQ(stats->array_items, 3);
+    EXPECT_EQ(stats->array_widenings, 1);
+    EXPECT_EQ_INT(stats->max_depth, 3);
+    EXPECT_EQ(stats->object_bytes, 6 * sizeof(fld_object));
+    EXPECT_EQ(stats->item_bytes, 2 * sizeof(int) + 2 * sizeof(int64_t) + sizeof(int64_t));
+    EXPECT_EQ(stats->source_bytes, strlen(source) + 1);
+    EXPECT_TRUE(stats->parse_ns >= stats->index_ns);
+
+    // Every parse starts counting again
+    EXPECT_TRUE(fld_parse_ex(&parser, source, strlen(source), memory, fld_estimate_memory(source), FLD_PARSE_BORROW_SOURCE));
+    EXPECT_EQ(stats->source_bytes, 0);
+    EXPECT_EQ(stats->tokens[TOKEN_EOF], 1);
+    cleanup_parser(memory);
+    return true;
+}
+
+static bool on_newlines(void* user, const fld_value* value) {
+    for (int i = 0; i < value->as.string.length; ++i) {
+        if (value->as.string.start[i] == '\n') (*(int*)user)++;
+    }
+    return true;
+}
+
+TEST(Parser, StringEscapes) {
+    const char* source =
+        "path = \"C:\\\\tools\\\\\\\"x\\\"\";\n"
+        "plain = \"no escapes here\";\n"
+        "lines = \"a\\tb\\nc\\/\";\n"
+        "unicode = \"caf\\u00e9 \\u20ac \\ud83d\\ude00\";\n"
+        "tags = [\"x\", \"say \\\"hi\\\"\", \"z\"];\n"
+        "nested = { brace = \"\\\"}\"; n = 1; };\n";
+
+    fld_measurement measurement;
+    EXPECT_TRUE(fld_measure(source, strlen(source), FLD_PARSE_DEFAULT, &measurement));
+    void* memory = malloc(measurement.bytes);
+    fld_parser parser = {0};
+    EXPECT_TRUE(fld_parse_ex(&parser, source, strlen(source), memory, measurement.bytes, FLD_PARSE_DEFAULT));
+    EXPECT_EQ(fld_get_memory_used(&parser), measurement.bytes);
+
+    fld_string_view text;
+    EXPECT_TRUE(fld_get_str_view(parser.root, "path", &text));
+    EXPECT_TRUE(fld_string_view_eq(text, "C:\\tools\\\"x\""));
+    EXPECT_TRUE(fld_get_str_view(parser.root, "lines", &text));
+    EXPECT_TRUE(fld_string_view_eq(text, "a\tb\nc/"));
+    EXPECT_TRUE(fld_get_str_view(parser.root, "unicode", &text));
+    EXPECT_TRUE(fld_string_view_eq(text, "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80"));
+
+    // Strings without escapes still point into the source
+    EXPECT_TRUE(fld_get_str_view(parser.root, "plain", &text));
+    EXPECT_TRUE(text.start > parser.source && text.start < parser.source + parser.source_length);
+
+    fld_value_type type;
+    fld_string_view* tags;
+    size_t count;
+    EXPECT_TRUE(fld_get_array(parser.root, "tags", &type, (void**)&tags, &count));
+    EXPECT_EQ(count, 3);
+    EXPECT_TRUE(fld_string_view_eq(tags[0], "x"));
+    EXPECT_TRUE(fld_string_view_eq(tags[1], "say \"hi\""));
+    EXPECT_TRUE(fld_string_view_eq(tags[2], "z"));
+    EXPECT_TRUE(fld_get_str_view(parser.root, "nested.brace", &text));
+    EXPECT_TRUE(fld_string_view_eq(text, "\"}"));
+
+    // An escaped quote doesn't end a string for the structural scans either
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 0};
+    fld_parser lazy = {0};
+    fld_parser_set_allocator(&lazy, &chunks);
+    EXPECT_TRUE(fld_parse_ex(&lazy, source, strlen(source), NULL, 0, FLD_PARSE_LAZY_OBJECTS));
+    EXPECT_TRUE(_fields_equal(lazy.root, parser.root));
+    fld_close(&lazy);
+    static uint8_t stream_memory[4096];
+    for (size_t piece = 1; piece <= 8; ++piece) {
+        fld_parser streamed = {0};
+        fld_stream stream;
+        fld_stream_begin(&stream, &streamed, stream_memory, sizeof(stream_memory));
+        for (size_t i = 0; i < strlen(source); i += piece) {
+            EXPECT_TRUE(fld_stream_feed(&stream, source + i, strlen(source) - i < piece ? strlen(source) - i : piece));
+        }
+        EXPECT_TRUE(fld_stream_end(&stream));
+        EXPECT_TRUE(_fields_equal(streamed.root, parser.root));
+    }
+
+    // Events get the decoded text too
+    event_log log = {0};
+    fld_event_handler handler = {&log, NULL, on_value, NULL, NULL, NULL, NULL, NULL};
+    const char* events = "a = \"1\\\"2\"; b = [\"\\\\\", \"c\"];";
+    EXPECT_TRUE(fld_parse_events(events, strlen(events), &handler, NULL));
+    EXPECT_TRUE(strcmp(log.log, "1\"2 \\ c ") == 0);
+
+    // Longer than the event buffer once decoded, it needs chunks
+    char* escapes = (char*)malloc(2600);
+    int written = sprintf(escapes, "s = \"");
+    for (int i = 0; i < 1200; ++i) {
+        written += sprintf(escapes + written, "\\n");
+    }
+    sprintf(escapes + written, "\"; t = \"\\t\";");
+    int newlines = 0;
+    fld_event_handler long_handler = {&newlines, NULL, on_newlines, NULL, NULL, NULL, NULL, NULL};
+    fld_error error;
+    EXPECT_FALSE(fld_parse_events(escapes, strlen(escapes), &long_handler, &error));
+    EXPECT_EQ(error.code, FLD_ERROR_STRING_TOO_LONG);
+    EXPECT_EQ_INT(newlines, 0);
+
+    long_handler.strings = &chunks;
+    EXPECT_TRUE(fld_parse_events(escapes, strlen(escapes), &long_handler, &error));
+    EXPECT_EQ_INT(newlines, 1200);
+    EXPECT_TRUE(counter.allocated > 0);
+    EXPECT_EQ(counter.allocated, counter.freed);
+    free(escapes);
+
+    // Bad escapes are reported where the string starts
+    const char* invalid[] = {"a = 1;\nb = \"\\q\";", "a = 1;\nb = \"\\u12\";", "a = 1;\nb = \"\\udc00\";", "a = 1;\nb = \"\\ud800x\";"};
+    for (int i = 0; i < 4; ++i) {
+        static uint8_t small[1024];
+        fld_parser broken = {0};
+        EXPECT_FALSE(fld_parse(&broken, invalid[i], small, sizeof(small)));
+        EXPECT_EQ(broken.last_error.code, FLD_ERROR_INVALID_ESCAPE);
+        EXPECT_EQ_INT(broken.last_error.line, 2);
+        EXPECT_EQ_INT(broken.last_error.column, 5);
+    }
+
+    cleanup_parser(memory);
+    return true;
+}
+
+typedef struct {
+    char text[1024];
+    size_t length;
+    int calls;
+} write_sink;
+
+static bool sink_write(void* user, const char* text, size_t length) {
+    write_sink* sink = (write_sink*)user;
+    if (sink->length + length >= sizeof(sink->text)) return false;
+    memcpy(sink->text + sink->length, text, length);
+    sink->length += length;
+    sink->text[sink->length] = '\0';
+    sink->calls++;
+    return true;
+}
+
+static bool write_float_is(float value, const char* expected) {
+    static uint8_t memory[1024];
+    fld_parser parser = {0};
+    char source[64];
+    size_t length = 0;
+    if (!fld_parse(&parser, "v = 0.0;", memory, sizeof(memory))) return false;
+    parser.root->value.as.float_val = value;
+
+    length = fld_write(parser.root, source, sizeof(source), FLD_WRITE_SINGLE_LINE);
+    return length == strlen(source) && strncmp(source, "v = ", 4) == 0 &&
+           strncmp(source + 4, expected, strlen(expected)) == 0 && source[4 + strlen(expected)] == ';';
+}
+
+TEST(Parser, Writer) {
+    const char* source =
+        "name = \"demo \\\"quoted\\\" \\\\ \\t\";\n"
+        "count = -42;\n"
+        "big = 5000000000;\n"
+        "scale = 0.1;\n"
+        "tiny = 1.5e-7;\n"
+        "enabled = false;\n"
+        "values = [1, 2, 3];\n"
+        "weights = [0.5, 1e30];\n"
+        "tags = [\"a\", \"b\\nc\"];\n"
+        "empty = {};\n"
+        "settings = { size = vec2(1920.0, 1080.0); color = vec4(1.0, 0.5, 0.25, 1.0); inner = { n = 1; }; title = \"Main\"; };\n";
+
+    fld_parser parser = {0};
+    void* memory = NULL;
+    EXPECT_TRUE(setup_parser(&parser, source, &memory));
+
+    // Measure, then write, then read back the same tree
+    uint32_t styles[] = {FLD_WRITE_PRETTY, FLD_WRITE_SINGLE_LINE};
+    for (int i = 0; i < 2; ++i) {
+        size_t length = fld_write(parser.root, NULL, 0, styles[i]);
+        EXPECT_TRUE(length > 0);
+        char* text = (char*)malloc(length + 1);
+        EXPECT_EQ(fld_write(parser.root, text, length + 1, styles[i]), length);
+        EXPECT_EQ(strlen(text), length);
+        EXPECT_TRUE((strchr(text, '\n') == NULL) == (styles[i] == FLD_WRITE_SINGLE_LINE));
+
+        fld_parser again = {0};
+        void* again_memory = NULL;
+        EXPECT_TRUE(setup_parser(&again, text, &again_memory));
+        EXPECT_TRUE(_fields_equal(again.root, parser.root));
+        cleanup_parser(again_memory);
+        free(text);
+    }
+
+    char pretty[1024];
+    fld_write(parser.root->next, pretty, sizeof(pretty), FLD_WRITE_PRETTY);
+    EXPECT_TRUE(strncmp(pretty, "count = -42;\nbig = 5000000000;\n", 31) == 0);
+    EXPECT_TRUE(strstr(pretty, "empty = {};\nsettings = {\n    size = vec2(1920.0, 1080.0);\n") != NULL);
+    EXPECT_TRUE(strstr(pretty, "    inner = {\n        n = 1;\n    };\n") != NULL);
+    EXPECT_TRUE(strstr(pretty, "tags = [\"a\", \"b\\nc\"];") != NULL);
+
+    char line[1024];
+    fld_write(parser.root, line, sizeof(line), FLD_WRITE_SINGLE_LINE);
+    EXPECT_TRUE(strncmp(line, "name = \"demo \\\"quoted\\\" \\\\ \\t\"; count = -42;", 44) == 0);
+    EXPECT_TRUE(strstr(line, "inner = { n = 1; }; title = \"Main\"; };") != NULL);
+
+    // Floats come out with the fewest digits that read back the same
+    EXPECT_TRUE(write_float_is(0.1f, "0.1"));
+    EXPECT_TRUE(write_float_is(1.0f / 3.0f, "0.33333334"));
+    EXPECT_TRUE(write_float_is(12300.0f, "12300.0"));
+    EXPECT_TRUE(write_float_is(0.00012f, "0.00012"));
+    EXPECT_TRUE(write_float_is(-0.0f, "-0.0"));
+    EXPECT_TRUE(write_float_is(1e-45f, "1e-45"));
+    EXPECT_TRUE(write_float_is(3.4028235e38f, "3.4028235e38"));
+    EXPECT_TRUE(write_float_is(16777216.0f, "16777216.0"));
+    EXPECT_TRUE(write_float_is(1e10f, "1e10"));
+
+    // Text that doesn't fit is still counted, and infinity can't be written
+    char small[16];
+    size_t full = fld_write(parser.root, NULL, 0, FLD_WRITE_SINGLE_LINE);
+    fld_writer writer;
+    fld_writer_init(&writer, small, sizeof(small), FLD_WRITE_SINGLE_LINE);
+    EXPECT_FALSE(fld_write_fields(&writer, parser.root) && fld_writer_finish(&writer, NULL));
+    size_t length = 0;
+    EXPECT_FALSE(fld_writer_finish(&writer, &length));
+    EXPECT_EQ(length, full);
+    EXPECT_EQ(strlen(small), sizeof(small) - 1);
+
+    fld_object* scale = fld_get_field_by_path(parser.root, "scale");
+    scale->value.as.float_val = 1e30f * 1e30f;
+    EXPECT_EQ(fld_write(parser.root, NULL, 0, FLD_WRITE_PRETTY), 0);
+    scale->value.as.float_val = 0.1f;
+
+    // Neither can an empty string, since `""` doesn't parse back
+    fld_parser quoted = {0};
+    EXPECT_FALSE(fld_parse(&quoted, "k = \"\";", NULL, 0));
+    fld_object* title = fld_get_field_by_path(parser.root, "settings.title");
+    title->value.as.string.length = 0;
+    EXPECT_EQ(fld_write(parser.root, NULL, 0, FLD_WRITE_SINGLE_LINE), 0);
+    title->value.as.string.length = 4;
+    fld_string_view* tags = (fld_string_view*)fld_get_field(parser.root, "tags")->value.as.array.items;
+    tags[0].length = 0;
+    EXPECT_EQ(fld_write(parser.root, NULL, 0, FLD_WRITE_PRETTY), 0);
+    tags[0].length = 1;
+    EXPECT_TRUE(fld_write(parser.root, NULL, 0, FLD_WRITE_PRETTY) > 0);
+
+    // Through a callback, building fields by hand
+    write_sink sink = {0};
+    fld_writer_init_callback(&writer, sink_write, &sink, FLD_WRITE_SINGLE_LINE);
+    fld_value value = {0};
+    value.type = FLD_VALUE_INT;
+    value.as.integer = 7;
+    EXPECT_TRUE(fld_write_key(&writer, (fld_string_view){"list", 4}));
+    EXPECT_TRUE(fld_write_array_begin(&writer));
+    EXPECT_TRUE(fld_write_value(&writer, &value));
+    EXPECT_TRUE(fld_write_value(&writer, &value));
+    EXPECT_TRUE(fld_write_array_end(&writer));
+    EXPECT_TRUE(fld_write_key(&writer, (fld_string_view){"obj", 3}));
+    EXPECT_TRUE(fld_write_object_begin(&writer));
+    EXPECT_TRUE(fld_write_key(&writer, (fld_string_view){"x", 1}));
+    EXPECT_TRUE(fld_write_value(&writer, &value));
+    EXPECT_TRUE(fld_write_object_end(&writer));
+    EXPECT_EQ_INT(sink.calls, 0);
+    EXPECT_TRUE(fld_writer_finish(&writer, &length));
+    EXPECT_EQ_INT(sink.calls, 1);
+    EXPECT_TRUE(strcmp(sink.text, "list = [7, 7]; obj = { x = 7; };") == 0);
+    EXPECT_EQ(length, strlen(sink.text));
+
+    // Reformatting straight from parse events
+    sink.length = 0;
+    sink.calls = 0;
+    fld_writer_init_callback(&writer, sink_write, &sink, FLD_WRITE_SINGLE_LINE);
+    fld_event_handler handler = fld_writer_handler(&writer);
+    const char* messy = "a=1;// note\nb={c=[1,2];d=\"x\";\n};e=vec3(1.5,2,3);";
+    EXPECT_TRUE(fld_parse_events(messy, strlen(messy), &handler, NULL));
+    EXPECT_TRUE(fld_writer_finish(&writer, NULL));
+    EXPECT_TRUE(strcmp(sink.text, "a = 1; b = { c = [1, 2]; d = \"x\"; }; e = vec3(1.5, 2.0, 3.0);") == 0);
+
+    cleanup_parser(memory);
+    return true;
+}
+
+TEST(Parser, TreeEdits) {
+    char source[2048] = "count = 1; values = [1, 2]; settings = { title = \"Main\"; }; wide = {";
+    for (int i = 0; i < 20; ++i) {
+        char field[32];
+        snprintf(field, sizeof(field), " f%d = %d;", i, i);
+        strcat(source, field);
+    }
+    strcat(source, " dup = 1; dup = 2; };");
+
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 0};
+    fld_parser parser = {0};
+    fld_parser_set_allocator(&parser, &chunks);
+    EXPECT_TRUE(fld_parse_ex(&parser, source, strlen(source), NULL, 0, FLD_PARSE_DEFAULT));
+
+    // Changing a value keeps the field, bound paths don't resolve again
+    fld_path compiled;
+    EXPECT_TRUE(fld_path_compile(&compiled, "count"));
+    fld_binding binding;
+    fld_object* count = fld_bind(&binding, &compiled, &parser);
+    EXPECT_TRUE(fld_set_int(&parser, "count", 5) == count);
+    EXPECT_EQ_INT(binding.generation, parser.generation);
+    int value = 0;
+    EXPECT_TRUE(fld_binding_get_int(&binding, &value));
+    EXPECT_EQ_INT(value, 5);
+    EXPECT_TRUE(fld_set_int64(&parser, "count", 5000000000LL) == count);
+    EXPECT_EQ(fld_get_type(parser.root, "count"), FLD_VALUE_INT64);
+
+    // Missing fields are added, objects along the way too
+    float size[2] = {1920.0f, 1080.0f};
+    EXPECT_NOT_NULL(fld_set_vec(&parser, "window.size", size, 2));
+    EXPECT_NOT_NULL(fld_set_str(&parser, "window.title", "Editor \"1\""));
+    EXPECT_NOT_NULL(fld_set_bool(&parser, "settings.vsync", true));
+    EXPECT_NOT_NULL(fld_set_float(&parser, "settings.scale", 1.5f));
+    EXPECT_TRUE(fld_add_object(&parser, "settings") == fld_get_field_by_path(parser.root, "settings"));
+    EXPECT_NULL(fld_set_int(&parser, "count.inner", 1));
+    EXPECT_NULL(fld_set_str(&parser, "window.title", ""));
+    float y = 0.0f, x = 0.0f;
+    EXPECT_TRUE(fld_get_vec2(parser.root, "window.size", &x, &y));
+    EXPECT_EQ_FLOAT(y, 1080.0f);
+    fld_string_view text;
+    EXPECT_TRUE(fld_get_str_view(parser.root, "window.title", &text));
+    EXPECT_TRUE(fld_string_view_eq(text, "Editor \"1\""));
+    EXPECT_TRUE(fld_get_field_by_path(parser.root, "settings.scale")->parent == fld_get_field_by_path(parser.root, "settings"));
+
+    // Indexed lists stay indexed through removals and growth
+    fld_object* wide = fld_get_children(fld_get_field_by_path(parser.root, "wide"));
+    EXPECT_NOT_NULL(wide->index);
+    EXPECT_TRUE(fld_remove_field(&parser, "wide.f0"));
+    EXPECT_TRUE(fld_remove_field(&parser, "wide.f7"));
+    EXPECT_FALSE(fld_remove_field(&parser, "wide.f7"));
+    EXPECT_NULL(fld_get_field_by_path(parser.root, "wide.f0"));
+    EXPECT_NULL(fld_get_field_by_path(parser.root, "wide.f7"));
+    EXPECT_NOT_NULL(fld_get_children(fld_get_field_by_path(parser.root, "wide"))->index);
+    EXPECT_TRUE(fld_remove_field(&parser, "wide.dup"));
+    EXPECT_TRUE(fld_get_int(parser.root, "wide.dup", &value));
+    EXPECT_EQ_INT(value, 2);
+
+    // Removed fields are reused first
+    fld_object* removed = fld_get_field_by_path(parser.root, "wide.f3");
+    EXPECT_TRUE(fld_remove_field(&parser, "wide.f3"));
+    EXPECT_TRUE(fld_set_int(&parser, "wide.f3", 33) == removed);
+
+    for (int i = 20; i < 80; ++i) {
+        char path[32];
+        snprintf(path, sizeof(path), "wide.f%d", i);
+        EXPECT_NOT_NULL(fld_set_int(&parser, path, i));
+    }
+    for (int i = 1; i < 80; ++i) {
+        char path[32];
+        snprintf(path, sizeof(path), "wide.f%d", i);
+        bool found = fld_get_int(parser.root, path, &value);
+        EXPECT_TRUE(found == (i != 7));
+        if (found) EXPECT_EQ_INT(value, i == 3 ? 33 : i);
+    }
+    EXPECT_EQ_INT(fld_get_children(fld_get_field_by_path(parser.root, "wide"))->index->count, 79);
+
+    // The index knows the last field, appends go there without a walk
+    wide = fld_get_children(fld_get_field_by_path(parser.root, "wide"));
+    fld_object* tail = wide;
+    while (tail->next) tail = tail->next;
+    EXPECT_TRUE(wide->index->last == tail);
+    EXPECT_TRUE(fld_string_view_eq(tail->key, "f79"));
+    EXPECT_TRUE(fld_remove_field(&parser, "wide.f79"));
+    EXPECT_TRUE(fld_string_view_eq(wide->index->last->key, "f78"));
+    fld_object* appended = fld_set_int(&parser, "wide.tail", 1);
+    EXPECT_TRUE(wide->index->last == appended);
+    EXPECT_TRUE(fld_get_field_by_path(parser.root, "wide.f78")->next == appended);
+
+    // Appends keep the items contiguous and follow the array type rules
+    fld_value item = {0};
+    item.type = FLD_VALUE_INT;
+    for (int i = 3; i <= 10; ++i) {
+        item.as.integer = i;
+        EXPECT_TRUE(fld_array_append(&parser, "values", &item));
+    }
+    item.type = FLD_VALUE_INT64;
+    item.as.int64 = 1LL << 40;
+    EXPECT_TRUE(fld_array_append(&parser, "values", &item));
+    item.type = FLD_VALUE_FLOAT;
+    item.as.float_val = 1.0f;
+    EXPECT_FALSE(fld_array_append(&parser, "values", &item));
+    fld_value_type type;
+    int64_t* wide_items;
+    size_t items;
+    EXPECT_TRUE(fld_get_array(parser.root, "values", &type, (void**)&wide_items, &items));
+    EXPECT_EQ(type, FLD_VALUE_INT64);
+    EXPECT_EQ(items, 11);
+    EXPECT_TRUE(wide_items[9] == 10 && wide_items[10] == (1LL << 40));
+
+    char name[] = "first";
+    item.type = FLD_VALUE_STRING;
+    item.as.string.start = name;
+    item.as.string.length = 5;
+    EXPECT_TRUE(fld_array_append(&parser, "window.tags", &item));
+    name[0] = 'F';
+    EXPECT_TRUE(fld_array_append(&parser, "window.tags", &item));
+    fld_string_view* tags;
+    EXPECT_TRUE(fld_get_array(parser.root, "window.tags", &type, (void**)&tags, &items));
+    EXPECT_EQ(items, 2);
+    EXPECT_TRUE(fld_string_view_eq(tags[0], "first") && fld_string_view_eq(tags[1], "First"));
+
+    // The edited tree writes out and parses back the same
+    char written[4096];
+    size_t length = fld_write(parser.root, written, sizeof(written), FLD_WRITE_PRETTY);
+    EXPECT_TRUE(length > 0 && length < sizeof(written));
+    fld_parser again = {0};
+    fld_parser_set_allocator(&again, &chunks);
+    EXPECT_TRUE(fld_parse_ex(&again, written, length, NULL, 0, FLD_PARSE_DEFAULT));
+    EXPECT_TRUE(_fields_equal(again.root, parser.root));
+    fld_parser_release(&again);
+
+    // Removing an object hands back everything under it, and a reparse
+    // of the original text doesn't keep an edited field
+    EXPECT_TRUE(fld_remove_field(&parser, "window"));
+    EXPECT_NULL(fld_get_field_by_path(parser.root, "window.size"));
+    EXPECT_NOT_NULL(parser.free_fields);
+    fld_changes changes;
+    EXPECT_TRUE(fld_reparse(&parser, source, strlen(source), &changes));
+    EXPECT_TRUE(fld_get_int(parser.root, "count", &value));
+    EXPECT_EQ_INT(value, 1);
+    EXPECT_NULL(fld_get_field_by_path(parser.root, "settings.vsync"));
+    fld_parser_release(&parser);
+
+    // Building from nothing, also inside lazy objects
+    fld_parser built = {0};
+    fld_parser_set_allocator(&built, &chunks);
+    EXPECT_NOT_NULL(fld_set_int(&built, "a.b.c", 1));
+    EXPECT_TRUE(fld_get_int(built.root, "a.b.c", &value));
+    fld_parser_release(&built);
+
+    fld_parser lazy = {0};
+    fld_parser_set_allocator(&lazy, &chunks);
+    EXPECT_TRUE(fld_parse_ex(&lazy, source, strlen(source), NULL, 0, FLD_PARSE_LAZY_OBJECTS));
+    EXPECT_NOT_NULL(fld_set_int(&lazy, "wide.f1", 100));
+    EXPECT_TRUE(fld_get_int(lazy.root, "wide.f1", &value));
+    EXPECT_EQ_INT(value, 100);
+    EXPECT_TRUE(fld_get_int(lazy.root, "wide.f19", &value));
+    fld_parser_release(&lazy);
+    EXPECT_EQ_INT(counter.allocated, counter.freed);
+    return true;
+}
+
+TEST(Parser, ParseInto) {
+    const char* source =
+        "count = 1;\n"
+        "settings = { display = { brightness = 0.5; contrast = 1.0; }; title = \"Main\"; };\n";
+
+    chunk_counter counter = {0};
+    fld_chunk_allocator chunks = {counting_alloc, counting_free, &counter, 0};
+    uint32_t flags[] = {FLD_PARSE_DEFAULT, FLD_PARSE_LAZY_OBJECTS};
+    for (int i = 0; i < 2; ++i) {
+        fld_parser parser = {0};
+        fld_parser_set_allocator(&parser, &chunks);
+        EXPECT_TRUE(fld_parse_ex(&parser, source, strlen(source), NULL, 0, flags[i]));
+
+        // Objects merge, other values are replaced in place
+        fld_object* title = fld_get_field_by_path(parser.root, "settings.title");
+        EXPECT_TRUE(fld_parse_into(&parser, "settings", "display = { brightness = 0.8; }; title = \"Override\"; extra = 3;"));
+        float value = 0.0f;
+        EXPECT_TRUE(fld_get_float(parser.root, "settings.display.brightness", &value));
+        EXPECT_EQ_FLOAT(value, 0.8f);
+        EXPECT_TRUE(fld_get_float(parser.root, "settings.display.contrast", &value));
+        EXPECT_EQ_FLOAT(value, 1.0f);
+        EXPECT_TRUE(fld_get_field_by_path(parser.root, "settings.title") == title);
+        EXPECT_TRUE(fld_string_view_eq(title->value.as.string, "Override"));
+        fld_object* extra = fld_get_field_by_path(parser.root, "settings.extra");
+        EXPECT_NOT_NULL(extra);
+        EXPECT_TRUE(extra->parent == fld_get_field_by_path(parser.root, "settings"));
+
+        // An object replacing a value takes its children along
+        EXPECT_TRUE(fld_parse_into(&parser, "settings", "extra = { a = 1; b = 2; }; display = 4;"));
+        fld_object* a = fld_get_field_by_path(parser.root, "settings.extra.a");
+        EXPECT_NOT_NULL(a);
+        EXPECT_TRUE(a->parent == extra);
+        EXPECT_EQ(fld_get_type(parser.root, "settings.display"), FLD_VALUE_INT);
+
+        // The top level, and objects that don't exist yet
+        EXPECT_TRUE(fld_parse_into(&parser, NULL, "count = 2; added = [1, 2]; count = 3;"));
+        int number = 0;
+        EXPECT_TRUE(fld_get_int(parser.root, "count", &number));
+        EXPECT_EQ_INT(number, 3);
+        size_t size = 0;
+        EXPECT_TRUE(fld_get_array_size(parser.root, "added", &size));
+        EXPECT_EQ(size, 2);
+        EXPECT_TRUE(fld_parse_into(&parser, "plugins.audio", "volume = 1;"));
+        EXPECT_TRUE(fld_get_int(parser.root, "plugins.audio.volume", &number));
+
+        // Errors leave the tree alone
+        char before[512], after[512];
+        fld_write(parser.root, before, sizeof(before), FLD_WRITE_SINGLE_LINE);
+        EXPECT_FALSE(fld_parse_into(&parser, "settings", "title = \"x\";\nbroken = ;"));
+        EXPECT_EQ(parser.last_error.code, FLD_ERROR_UNEXPECTED_TOKEN);
+        EXPECT_EQ_INT(parser.last_error.line, 2);
+        EXPECT_FALSE(fld_parse_into(&parser, "count.inner", "a = 1;"));
+        EXPECT_EQ(parser.last_error.code, FLD_ERROR_INVALID_PATH);
+        fld_write(parser.root, after, sizeof(after), FLD_WRITE_SINGLE_LINE);
+        EXPECT_TRUE(strcmp(before, after) == 0);
+
+        // A reparse of the file drops the overrides again
+        fld_changes changes;
+        EXPECT_TRUE(fld_reparse(&parser, source, strlen(source), &changes));
+        EXPECT_TRUE(fld_get_int(parser.root, "count", &number));
+        EXPECT_EQ_INT(number, 1);
+        EXPECT_TRUE(fld_get_float(parser.root, "settings.display.brightness", &value));
+        EXPECT_EQ_FLOAT(value, 0.5f);
+        EXPECT_NULL(fld_get_field_by_path(parser.root, "plugins"));
+        fld_parser_release(&parser);
+    }
+    EXPECT_EQ_INT(counter.allocated, counter.freed);
+    return true;
+}
+
 int main(void) {
     RUN_ALL_TESTS();
     return 0;
@@ -0,0 +1,149 @@
+#define VF_TEST_IMPLEMENTATION
+#include "lib/vf_test.h"
+
+#define FLD_PARSER_IMPLEMENTATION
+#include "../include/field_parser.hpp"
+
+using namespace fld::literals;
+
+static const char *source =
+    "name = \"demo\";\n"
+    "count = 7;\n"
+    "big = 5000000000;\n"
+    "scale = 1.5;\n"
+    "enabled = true;\n"
+    "values = [1, 2, 3, 4];\n"
+    "weights = [0.5, 0.25];\n"
+    "tags = [\"a\", \"bc\"];\n"
+    "empty = [];\n"
+    "settings = {\n"
+    "    window = {\n"
+    "        size = vec2(1920.0, 1080.0);\n"
+    "        color = vec4(1.0, 0.5, 0.25, 1.0);\n"
+    "    };\n"
+    "    title = \"Main\";\n"
+    "};\n";
+
+// The literal hashes exactly like the runtime index
+static_assert("settings.window.size"_fld.segment_count == 3, "three segments");
+static_assert("settings.window.size"_fld.segments[2].hash == fld::hash_key("size", 4), "hashed at compile time");
+static_assert("..a..b."_fld.segment_count == 2, "empty segments are skipped");
+static_assert(""_fld.segment_count == 0, "empty paths resolve to nothing");
+
+TEST(Cpp, PathLiterals) {
+    constexpr fld_path literal = "settings.window.size"_fld;
+    fld_path compiled;
+    EXPECT_TRUE(fld_path_compile(&compiled, "settings.window.size"));
+    EXPECT_EQ_INT(compiled.segment_count, literal.segment_count);
+    for (int i = 0; i < compiled.segment_count; ++i) {
+        EXPECT_TRUE(compiled.segments[i].hash == literal.segments[i].hash);
+        EXPECT_TRUE(compiled.segments[i].hash == fld_hash_key(compiled.text + compiled.segments[i].offset, compiled.segments[i].length));
+        EXPECT_EQ_INT(compiled.segments[i].offset, literal.segments[i].offset);
+        EXPECT_EQ_INT(compiled.segments[i].length, literal.segments[i].length);
+    }
+    EXPECT_EQ_STR(compiled.text, literal.text);
+    return true;
+}
+
+TEST(Cpp, TypedAccess) {
+    fld::document doc;
+    EXPECT_TRUE(doc.parse(source));
+
+    static constexpr fld_path size_path = "settings.window.size"_fld;
+    std::optional<fld::vec2> size = doc.get<fld::vec2>(size_path);
+    EXPECT_TRUE(size.has_value());
+    EXPECT_EQ_FLOAT(size->x, 1920.0f);
+    EXPECT_EQ_FLOAT(size->y, 1080.0f);
+
+    fld::fields root = doc.root();
+    EXPECT_TRUE(root.get<std::string_view>("name"_fld) == "demo");
+    EXPECT_EQ_INT(*root.get<int>("count"_fld), 7);
+    EXPECT_TRUE(*root.get<int64_t>("count"_fld) == 7);
+    EXPECT_TRUE(*root.get<int64_t>("big"_fld) == 5000000000LL);
+    EXPECT_FALSE(root.get<int>("big"_fld).has_value());
+    EXPECT_EQ_FLOAT(*root.get<float>("scale"_fld), 1.5f);
+    EXPECT_TRUE(*root.get<bool>("enabled"_fld));
+    EXPECT_EQ_FLOAT(root.get<fld::vec4>("settings.window.color")->z, 0.25f);
+
+    // Wrong types and missing paths come back empty
+    EXPECT_FALSE(root.get<float>("count"_fld).has_value());
+    EXPECT_FALSE(root.get<int>("settings.missing"_fld).has_value());
+    EXPECT_EQ_INT(root.get_or("settings.missing"_fld, 3), 3);
+    EXPECT_EQ_INT(root.get_or("count"_fld, 3), 7);
+
+    // Arrays as spans over the arena
+    fld::span<const int> values = *root.get<fld::span<const int>>("values"_fld);
+    EXPECT_EQ_INT((int)values.size(), 4);
+    int sum = 0;
+    for (int value : values) sum += value;
+    EXPECT_EQ_INT(sum, 10);
+    EXPECT_EQ_FLOAT((*root.get<fld::span<const float>>("weights"_fld))[1], 0.25f);
+    EXPECT_FALSE(root.get<fld::span<const float>>("values"_fld).has_value());
+    EXPECT_TRUE(root.get<fld::span<const float>>("empty"_fld)->empty());
+
+    fld::span<const fld_string_view> tags = *root.get<fld::span<const fld_string_view>>("tags"_fld);
+    EXPECT_EQ_INT((int)tags.size(), 2);
+    EXPECT_TRUE(fld_string_view_eq(tags[1], "bc"));
+
+    // Objects as field lists
+    fld::fields settings = *root.get<fld::fields>("settings"_fld);
+    EXPECT_TRUE(settings.get<std::string_view>("title") == "Main");
+    EXPECT_FALSE(root.find("count").children());
+    return true;
+}
+
+TEST(Cpp, RangeIteration) {
+    fld::document doc;
+    EXPECT_TRUE(doc.parse(source));
+
+    int top = 0;
+    for (fld::field field : doc.root()) {
+        EXPECT_FALSE(field.key().empty());
+        top++;
+    }
+    EXPECT_EQ_INT(top, 10);
+
+    int nested = 0;
+    for (fld::field field : doc.root().find("settings").children()) {
+        nested += field.key() == "window" || field.key() == "title";
+    }
+    EXPECT_EQ_INT(nested, 2);
+
+    int all = 0;
+    for (fld::field field : doc.root().find("settings").children().all()) {
+        (void)field;
+        all++;
+    }
+    EXPECT_EQ_INT(all, 4);
+    return true;
+}
+
+TEST(Cpp, DocumentOwnership) {
+    fld::document doc;
+    EXPECT_FALSE(doc.parse("broken = ;"));
+    EXPECT_EQ_INT(doc.error().code, FLD_ERROR_UNEXPECTED_TOKEN);
+    EXPECT_FALSE(doc.root());
+
+    // A new parse replaces the previous arena
+    EXPECT_TRUE(doc.parse("a = 1;"));
+    EXPECT_TRUE(doc.parse(source));
+    EXPECT_EQ_INT(*doc.get<int>("count"), 7);
+
+    // Bindings keep working through the C API
+    static constexpr fld_path count_path = "count"_fld;
+    fld_binding binding;
+    EXPECT_NOT_NULL(fld_bind(&binding, &count_path, &doc.parser()));
+    EXPECT_TRUE(doc.parse("count = 9;"));
+    int count = 0;
+    EXPECT_TRUE(fld_binding_get_int(&binding, &count));
+    EXPECT_EQ_INT(count, 9);
+
+    doc.release();
+    EXPECT_FALSE(doc.root());
+    return true;
+}
+
+int main(void) {
+    RUN_ALL_TESTS();
+    return 0;
+}